@@ -96,9 +96,6 @@ namespace steemit {
                 wlog("unknown api: ${api}", ("api", api_name));
                 return fc::api_ptr();
             }
-            if (it->second) {
-                ilog("found api: ${api}", ("api", api_name));
-            }
             FC_ASSERT(it->second != nullptr);
             return it->second;
         }
@@ -117,9 +114,6 @@ namespace steemit {
         }
 
         void network_broadcast_api::on_api_startup() {
-            /// note cannot capture shared pointer here, because _applied_block_connection will never
-            /// be freed if the lambda holds a reference to it.
-            _applied_block_connection = connect_signal(_app.chain_database()->applied_block, *this, &network_broadcast_api::on_applied_block);
         }
 
         bool network_broadcast_api::check_max_block_age(int32_t max_block_age) {
@@ -199,7 +193,7 @@ namespace steemit {
                 (*_app._remote_net_api)->broadcast_transaction(trx);
             } else {
                 FC_ASSERT(!check_max_block_age(_max_block_age));
-                _app.chain_database()->push_transaction(trx);
+                _app.push_transaction(trx);
                 _app.p2p_node()->broadcast_transaction(trx);
             }
         }
@@ -234,10 +228,16 @@ namespace steemit {
             } else {
                 FC_ASSERT(!check_max_block_age(_max_block_age));
                 trx.validate();
+
+                /// Only sessions waiting for confirmations follow applied blocks. note cannot capture shared
+                /// pointer here, because _applied_block_connection will never be freed if the lambda holds it.
+                if (!_applied_block_connection.connected()) {
+                    _applied_block_connection = connect_signal(_app.chain_database()->applied_block, *this, &network_broadcast_api::on_applied_block);
+                }
                 _callbacks[trx.id()] = cb;
                 _callbacks_expirations[trx.expiration].push_back(trx.id());
 
-                _app.chain_database()->push_transaction(trx);
+                _app.push_transaction(trx);
                 _app.p2p_node()->broadcast_transaction(trx);
             }
         }
@@ -0,0 +1,181 @@
+#include <steemit/app/api_admission.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/thread/future.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+namespace steemit {
+    namespace app {
+
+        namespace detail {
+            class api_admission_impl {
+            public:
+                api_admission_limits limits;
+                std::map<std::string, uint32_t> weights;
+                std::vector<std::string> high_priority_apis;
+
+                std::mutex mutex;
+                std::map<const void *, uint32_t> session_calls;
+                std::map<std::string, uint32_t> method_calls;
+
+                std::vector<uint32_t> free_threads;
+                std::deque<fc::promise<uint32_t>::ptr> waiting[3]; ///< by priority
+                uint32_t waiting_count = 0;
+
+                bool is_high_priority(const std::string &method) const {
+                    auto api = method.substr(0, method.find('.'));
+                    return std::find(high_priority_apis.begin(), high_priority_apis.end(), api) !=
+                           high_priority_apis.end();
+                }
+
+                template<typename Key>
+                static void decrement(std::map<Key, uint32_t> &counts, const Key &key) {
+                    auto itr = counts.find(key);
+                    if (itr != counts.end() && --itr->second == 0) {
+                        counts.erase(itr);
+                    }
+                }
+            };
+        }
+
+        api_admission::ticket::ticket(api_admission &owner, const void *session, std::string method, api_priority priority)
+                : _owner(owner), _session(session), _method(std::move(method)), _priority(priority) {
+        }
+
+        api_admission::ticket::~ticket() {
+            _owner.release(*this);
+        }
+
+        api_admission::thread_slot::thread_slot(api_admission &owner, uint32_t thread)
+                : _owner(owner), _thread(thread) {
+        }
+
+        api_admission::thread_slot::~thread_slot() {
+            _owner.release(*this);
+        }
+
+        api_admission::api_admission(const api_admission_limits &limits, uint32_t thread_count,
+                                     std::map<std::string, uint32_t> weights, std::vector<std::string> high_priority_apis)
+                : my(new detail::api_admission_impl()) {
+            my->limits = limits;
+            my->weights = std::move(weights);
+            my->high_priority_apis = std::move(high_priority_apis);
+            for (uint32_t i = thread_count; i > 0; --i) {
+                my->free_threads.push_back(i - 1);
+            }
+        }
+
+        api_admission::~api_admission() {
+        }
+
+        uint64_t api_admission::estimate_cost(const std::string &method, const fc::variants &args) const {
+            auto weight = my->weights.find(method);
+            uint64_t cost = weight == my->weights.end() ? 1 : weight->second;
+
+            for (const auto &arg : args) {
+                if (!arg.is_object()) {
+                    continue;
+                }
+                const auto &obj = arg.get_object();
+                auto limit = obj.find("limit");
+                if (limit != obj.end() && limit->value().is_numeric()) {
+                    cost *= std::max<uint64_t>(1, std::min<uint64_t>(limit->value().as_uint64(), 1000000));
+                    break;
+                }
+            }
+            return cost;
+        }
+
+        std::unique_ptr<api_admission::ticket> api_admission::admit(const void *session, const std::string &method,
+                                                                    const fc::variants &args) {
+            api_priority priority = api_priority::high;
+            if (!my->is_high_priority(method)) {
+                priority = estimate_cost(method, args) > my->limits.max_normal_cost ? api_priority::low
+                                                                                      : api_priority::normal;
+            }
+
+            std::lock_guard<std::mutex> lock(my->mutex);
+            auto session_calls = my->session_calls.find(session);
+            FC_ASSERT(session_calls == my->session_calls.end() || session_calls->second < my->limits.max_session_calls,
+                    "Too many API calls in flight on this connection, at most ${n} are allowed",
+                    ("n", my->limits.max_session_calls));
+            if (priority != api_priority::high) {
+                auto method_calls = my->method_calls.find(method);
+                FC_ASSERT(method_calls == my->method_calls.end() || method_calls->second < my->limits.max_method_calls,
+                        "Too many calls of ${method} in flight, try again later", ("method", method));
+                my->method_calls[method]++;
+            }
+            my->session_calls[session]++;
+
+            return std::unique_ptr<ticket>(new ticket(*this, session, method, priority));
+        }
+
+        std::unique_ptr<api_admission::thread_slot> api_admission::acquire_thread(const ticket &t) {
+            fc::promise<uint32_t>::ptr turn;
+            {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                if (!my->free_threads.empty()) {
+                    auto thread = my->free_threads.back();
+                    my->free_threads.pop_back();
+                    return std::unique_ptr<thread_slot>(new thread_slot(*this, thread));
+                }
+
+                FC_ASSERT(my->waiting_count < my->limits.max_queued_calls,
+                        "API calls queue is full, try again later");
+                turn = fc::promise<uint32_t>::ptr(new fc::promise<uint32_t>("wait for api thread"));
+                my->waiting[static_cast<uint32_t>(t.priority())].push_back(turn);
+                my->waiting_count++;
+            }
+
+            try {
+                auto thread = fc::future<uint32_t>(turn).wait();
+                return std::unique_ptr<thread_slot>(new thread_slot(*this, thread));
+            } catch (...) {
+                // A canceled or failed wait gives up its place in the queue, or the thread it was already given
+                bool handed_over = false;
+                {
+                    std::lock_guard<std::mutex> lock(my->mutex);
+                    auto &queue = my->waiting[static_cast<uint32_t>(t.priority())];
+                    auto itr = std::find(queue.begin(), queue.end(), turn);
+                    if (itr != queue.end()) {
+                        queue.erase(itr);
+                        my->waiting_count--;
+                    } else {
+                        handed_over = true;
+                    }
+                }
+                if (handed_over) {
+                    thread_slot(*this, turn->wait());
+                }
+                throw;
+            }
+        }
+
+        void api_admission::release(const ticket &t) {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            detail::api_admission_impl::decrement(my->session_calls, t._session);
+            if (t._priority != api_priority::high) {
+                detail::api_admission_impl::decrement(my->method_calls, t._method);
+            }
+        }
+
+        void api_admission::release(const thread_slot &s) {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            for (auto &queue : my->waiting) {
+                if (!queue.empty()) {
+                    // The thread passes straight to the next call, so it can't be taken by a call arriving later.
+                    // It is set under the lock, so a call no longer in the queue has always been given its thread.
+                    queue.front()->set_value(s._thread);
+                    queue.pop_front();
+                    my->waiting_count--;
+                    return;
+                }
+            }
+            my->free_threads.push_back(s._thread);
+        }
+
+    }
+}
@@ -0,0 +1,64 @@
+#include <steemit/app/api_executor.hpp>
+
+#include <chainbase/chainbase.hpp>
+
+#include <fc/thread/future.hpp>
+
+namespace steemit {
+    namespace app {
+
+        api_executor::api_executor(uint32_t thread_count, std::shared_ptr<api_admission> admission,
+                                   std::shared_ptr<api_metrics> metrics)
+                : _admission(std::move(admission)), _metrics(std::move(metrics)) {
+            for (uint32_t i = 0; i < thread_count; ++i) {
+                _threads.push_back(std::make_shared<fc::thread>("api"));
+            }
+        }
+
+        api_executor::~api_executor() {
+        }
+
+        fc::variant api_executor::execute(const void *session, const std::string &name,
+                                          const fc::rpc::api_connection::call_info &info,
+                                          const std::function<fc::variant()> &call) {
+            auto timing = std::make_shared<api_metrics::call_timing>();
+            auto start = fc::time_point::now();
+
+            auto timed_call = [timing, start, call]() {
+                timing->queued = fc::time_point::now() - start;
+                auto lock_wait = chainbase::database::read_lock_wait_micro();
+                try {
+                    auto result = call();
+                    timing->lock_wait = fc::microseconds(chainbase::database::read_lock_wait_micro() - lock_wait);
+                    return result;
+                } catch (...) {
+                    timing->lock_wait = fc::microseconds(chainbase::database::read_lock_wait_micro() - lock_wait);
+                    throw;
+                }
+            };
+
+            try {
+                fc::variant result;
+                std::shared_ptr<api_admission::ticket> ticket = _admission->admit(session, name, info.args);
+                if (info.read_only && !_threads.empty()) {
+                    // The ticket and the thread are held until the call ends, not until the caller stops waiting
+                    std::shared_ptr<api_admission::thread_slot> slot = _admission->acquire_thread(*ticket);
+                    auto &thread = _threads[slot->thread()];
+                    result = thread->async([timed_call, ticket, slot]() {
+                        return timed_call();
+                    }, "read only api call").wait();
+                } else {
+                    result = timed_call();
+                }
+                timing->total = fc::time_point::now() - start;
+                _metrics->record_call(name, info.args, *timing, false);
+                return result;
+            } catch (...) {
+                timing->total = fc::time_point::now() - start;
+                _metrics->record_call(name, info.args, *timing, true);
+                throw;
+            }
+        }
+
+    }
+}
@@ -0,0 +1,129 @@
+#include <steemit/app/api_metrics.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace steemit {
+    namespace app {
+
+        api_metrics::api_metrics(const fc::microseconds &slow_call_threshold)
+                : _slow_call_threshold(slow_call_threshold) {
+        }
+
+        void api_metrics::record_call(const std::string &name, const fc::variants &args, const call_timing &timing, bool failed) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto &m = _methods[name];
+                m.total.add(timing.total);
+                m.queued.add(timing.queued);
+                m.lock_wait.add(timing.lock_wait);
+                if (failed) {
+                    m.errors++;
+                }
+            }
+
+            if (_slow_call_threshold.count() > 0 && timing.total > _slow_call_threshold) {
+                std::string json_args = fc::json::to_string(args);
+                if (json_args.size() > 256) {
+                    json_args = json_args.substr(0, 256) + "...";
+                }
+                wlog("Slow API call ${name} took ${t} us (queued ${q} us, lock wait ${l} us), args: ${args}",
+                        ("name", name)("t", timing.total.count())("q", timing.queued.count())
+                        ("l", timing.lock_wait.count())("args", json_args));
+            }
+        }
+
+        void api_metrics::record_traffic(const std::string &name, size_t bytes_in, size_t bytes_out) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto itr = _methods.find(name);
+            if (itr == _methods.end()) {
+                if (name != "batch") {
+                    return;
+                }
+                itr = _methods.emplace(name, method_metrics()).first;
+            }
+            itr->second.bytes_in += bytes_in;
+            itr->second.bytes_out += bytes_out;
+        }
+
+        std::vector<api_method_stats> api_metrics::get_stats() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::vector<api_method_stats> result;
+            result.reserve(_methods.size());
+            for (const auto &m : _methods) {
+                api_method_stats s;
+                s.name = m.first;
+                s.errors = m.second.errors;
+                s.bytes_in = m.second.bytes_in;
+                s.bytes_out = m.second.bytes_out;
+                s.total = m.second.total.get_stats("total");
+                s.queued = m.second.queued.get_stats("queued");
+                s.lock_wait = m.second.lock_wait.get_stats("lock_wait");
+                result.push_back(std::move(s));
+            }
+
+            std::sort(result.begin(), result.end(),
+                    [](const api_method_stats &a, const api_method_stats &b) {
+                        return a.total.total_us > b.total.total_us;
+                    });
+            return result;
+        }
+
+        std::string api_metrics::to_prometheus() const {
+            auto stats = get_stats();
+            std::ostringstream out;
+
+            auto family = [&](const char *name, const char *type, const char *help) {
+                out << "# HELP " << name << ' ' << help << '\n';
+                out << "# TYPE " << name << ' ' << type << '\n';
+            };
+
+            family("golos_api_calls_total", "counter", "Number of API calls");
+            for (const auto &s : stats) {
+                out << "golos_api_calls_total{method=\"" << s.name << "\"} " << s.total.count << '\n';
+            }
+
+            family("golos_api_errors_total", "counter", "Number of API calls which threw");
+            for (const auto &s : stats) {
+                out << "golos_api_errors_total{method=\"" << s.name << "\"} " << s.errors << '\n';
+            }
+
+            family("golos_api_call_duration_microseconds", "summary",
+                    "Duration of API calls, quantiles over the most recent calls");
+            for (const auto &s : stats) {
+                const std::string label = "method=\"" + s.name + "\"";
+                out << "golos_api_call_duration_microseconds{" << label << ",quantile=\"0.5\"} " << s.total.p50_us << '\n';
+                out << "golos_api_call_duration_microseconds{" << label << ",quantile=\"0.9\"} " << s.total.p90_us << '\n';
+                out << "golos_api_call_duration_microseconds{" << label << ",quantile=\"0.99\"} " << s.total.p99_us << '\n';
+                out << "golos_api_call_duration_microseconds_sum{" << label << "} " << s.total.total_us << '\n';
+                out << "golos_api_call_duration_microseconds_count{" << label << "} " << s.total.count << '\n';
+            }
+
+            family("golos_api_queue_microseconds_total", "counter", "Time API calls waited for an API thread");
+            for (const auto &s : stats) {
+                out << "golos_api_queue_microseconds_total{method=\"" << s.name << "\"} " << s.queued.total_us << '\n';
+            }
+
+            family("golos_api_lock_wait_microseconds_total", "counter",
+                    "Time API calls waited for the read lock of the database");
+            for (const auto &s : stats) {
+                out << "golos_api_lock_wait_microseconds_total{method=\"" << s.name << "\"} " << s.lock_wait.total_us << '\n';
+            }
+
+            family("golos_api_received_bytes_total", "counter", "Size of API requests");
+            for (const auto &s : stats) {
+                out << "golos_api_received_bytes_total{method=\"" << s.name << "\"} " << s.bytes_in << '\n';
+            }
+
+            family("golos_api_sent_bytes_total", "counter", "Size of API replies");
+            for (const auto &s : stats) {
+                out << "golos_api_sent_bytes_total{method=\"" << s.name << "\"} " << s.bytes_out << '\n';
+            }
+
+            return out.str();
+        }
+
+    }
+}
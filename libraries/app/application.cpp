@@ -22,6 +22,13 @@
  * THE SOFTWARE.
  */
 #include <steemit/app/api.hpp>
+#include <steemit/app/transaction_prechecker.hpp>
+#include <steemit/app/plugin_pipeline.hpp>
+#include <steemit/app/response_cache.hpp>
+#include <steemit/app/state_views.hpp>
+#include <steemit/app/api_metrics.hpp>
+#include <steemit/app/api_admission.hpp>
+#include <steemit/app/api_executor.hpp>
 
 #include <steemit/chain/database_exceptions.hpp>
 
@@ -33,6 +40,7 @@
 
 #include <fc/io/fstream.hpp>
 #include <fc/network/resolve.hpp>
+#include <fc/thread/thread.hpp>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/signals2.hpp>
@@ -43,6 +51,8 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <mutex>
+
 namespace steemit {
     namespace app {
         using graphene::net::item_hash_t;
@@ -157,6 +167,7 @@ namespace steemit {
                         _websocket_server = std::make_shared<fc::http::websocket_server>();
 
                         _websocket_server->on_connection([&](const fc::http::websocket_connection_ptr &c) { on_connection(c); });
+                        _websocket_server->on_http_get([this](const std::string &resource) { return on_http_get(resource); });
                         auto rpc_endpoint = _options->at("rpc-endpoint").as<string>();
                         ilog("Configured websocket rpc to listen on ${ip}", ("ip", rpc_endpoint));
                         auto endpoints = resolve_string_to_ip_endpoints(rpc_endpoint);
@@ -183,6 +194,7 @@ namespace steemit {
                         _websocket_tls_server = std::make_shared<fc::http::websocket_tls_server>(_options->at("server-pem").as<string>(), password);
 
                         _websocket_tls_server->on_connection([this](const fc::http::websocket_connection_ptr &c) { on_connection(c); });
+                        _websocket_tls_server->on_http_get([this](const std::string &resource) { return on_http_get(resource); });
                         auto rpc_tls_endpoint = _options->at("rpc-tls-endpoint").as<string>();
                         ilog("Configured websocket TLS rpc to listen on ${ip}", ("ip", rpc_tls_endpoint));
                         auto endpoints = resolve_string_to_ip_endpoints(rpc_tls_endpoint);
@@ -192,10 +204,37 @@ namespace steemit {
                     } FC_CAPTURE_AND_RETHROW()
                 }
 
+                fc::optional<std::string> on_http_get(const std::string &resource) {
+                    if (resource == "/metrics") {
+                        return _api_metrics->to_prometheus();
+                    }
+                    return fc::optional<std::string>();
+                }
+
+                fc::variant execute_call(const void *session, const fc::rpc::api_connection::call_info &info,
+                                         const std::vector<std::string> &api_names, const std::function<fc::variant()> &call) {
+                    return _api_executor->execute(session, api_name(info.api_id, api_names) + "." + info.method_name,
+                                                  info, call);
+                }
+
                 void on_connection(const fc::http::websocket_connection_ptr &c) {
                     std::shared_ptr<api_session_data> session = std::make_shared<api_session_data>();
                     session->wsc = std::make_shared<fc::rpc::websocket_api_connection>(*c);
 
+                    // Every API of the session is registered here, login_api hands out the same instances
+                    auto api_names = std::make_shared<std::vector<std::string>>();
+                    const void *session_key = session.get();
+
+                    session->wsc->set_call_executor([this, api_names, session_key](const fc::rpc::api_connection::call_info &info,
+                                                                                   const std::function<fc::variant()> &call) {
+                        return execute_call(session_key, info, *api_names, call);
+                    });
+
+                    session->wsc->set_max_batch_size(_max_batch_size);
+                    session->wsc->set_message_observer([this, api_names](const fc::variant &request, size_t bytes_in, size_t bytes_out) {
+                        _api_metrics->record_traffic(traffic_name(request, *api_names), bytes_in, bytes_out);
+                    });
+
                     for (const std::string &name : _public_apis) {
                         api_context ctx(*_self, name, session);
                         fc::api_ptr api = create_api_by_name(ctx);
@@ -204,15 +243,61 @@ namespace steemit {
                             continue;
                         }
                         session->api_map[name] = api;
-                        api->register_api(*session->wsc);
+                        auto api_id = api->register_api(*session->wsc);
+                        if (api_id >= api_names->size()) {
+                            api_names->resize(api_id + 1);
+                        }
+                        (*api_names)[api_id] = name;
                     }
                     c->set_session_data(session);
                 }
 
+                /**
+                 * Name a request the way execute_call names the call, or "batch" for a batch of requests.
+                 */
+                static std::string traffic_name(const fc::variant &request, const std::vector<std::string> &api_names) {
+                    if (request.is_array()) {
+                        return "batch";
+                    }
+                    if (!request.is_object()) {
+                        return std::string();
+                    }
+
+                    const auto &obj = request.get_object();
+                    auto method = obj.find("method");
+                    if (method == obj.end() || !method->value().is_string()) {
+                        return std::string();
+                    }
+                    if (method->value().get_string() != "call") {
+                        return api_name(0, api_names) + "." + method->value().get_string();
+                    }
+
+                    auto params = obj.find("params");
+                    if (params == obj.end() || !params->value().is_array() || params->value().size() < 2) {
+                        return std::string();
+                    }
+                    const auto &api = params->value().get_array()[0];
+                    std::string name;
+                    if (api.is_string()) {
+                        name = api.get_string();
+                    } else if (api.is_numeric()) {
+                        name = api_name(api.as_uint64(), api_names);
+                    }
+                    return name + "." + params->value().get_array()[1].as_string();
+                }
+
+                static std::string api_name(uint64_t api_id, const std::vector<std::string> &api_names) {
+                    if (api_id < api_names.size() && !api_names[api_id].empty()) {
+                        return api_names[api_id];
+                    }
+                    return "api" + std::to_string(api_id);
+                }
+
                 application_impl(application *self)
                         : _self(self),
                         //_pending_trx_db(std::make_shared<graphene::db::object_database>()),
-                          _chain_db(std::make_shared<chain::database>()) {
+                          _chain_db(std::make_shared<chain::database>()),
+                          _plugin_pipeline(std::make_shared<plugin_pipeline>(_chain_db)) {
                 }
 
                 ~application_impl() {
@@ -221,7 +306,7 @@ namespace steemit {
                 void register_builtin_apis() {
                     _self->register_api_factory<login_api>("login_api");
                     _self->register_api_factory<database_api>("database_api");
-                    _self->register_api_factory<network_node_api>("network_node_api");
+                    _self->register_shared_api_factory<network_node_api>("network_node_api");
                     _self->register_api_factory<network_broadcast_api>("network_broadcast_api");
                 }
 
@@ -253,6 +338,18 @@ namespace steemit {
                             }
 
                             _chain_db->set_flush_interval(_options->at("flush").as<uint32_t>());
+                            _chain_db->set_block_profiling(_options->at("block-profiling").as<bool>(),
+                                    _options->at("slow-block-threshold").as<uint32_t>());
+                            _chain_db->set_operation_profiling(_options->at("operation-profiling").as<bool>(),
+                                    _options->at("operation-profile-log-interval").as<uint32_t>());
+                            // Once operations move to the history log, get_transaction finds irreversible
+                            // transactions through the index only
+                            _chain_db->set_store_transaction_index(_options->at("store-transaction-index").as<bool>() ||
+                                                                   _chain_db->store_account_history());
+                            _chain_db->set_store_vote_archive(_options->at("store-vote-archive").as<bool>());
+                            _chain_db->set_pending_transactions_limit(
+                                    _options->at("max-pending-transactions").as<uint32_t>(),
+                                    fc::parse_size(_options->at("max-pending-transactions-size").as<string>()));
 
                             flat_map<uint32_t, block_id_type> loaded_checkpoints;
                             if (_options->count("checkpoint")) {
@@ -290,6 +387,33 @@ namespace steemit {
                                 }
                             }
 
+                            if (_options->count("reindex-plugin")) {
+                                reindex_plugins(_options->at("reindex-plugin").as<vector<string>>());
+                            }
+
+                            _trx_prechecker = std::make_shared<transaction_prechecker>(_chain_db,
+                                    _options->at("precheck-threads").as<uint32_t>());
+
+                            // Only a writing node learns about new blocks to clear the cache on
+                            auto cache_size = fc::parse_size(_options->at("api-response-cache-size").as<string>());
+                            if (cache_size) {
+                                _response_cache = std::make_shared<response_cache>(cache_size);
+                                _response_cache_connection = _chain_db->applied_block.connect([this](const signed_block &) {
+                                    _response_cache->clear();
+                                });
+                            }
+
+                            auto state_views_size = _options->at("api-state-views-size").as<uint32_t>();
+                            if (state_views_size) {
+                                _state_views = std::make_shared<state_views>(state_views_size);
+                                _state_views_objects_connection = _chain_db->changed_objects.connect([this](const chain::changed_objects_notification &note) {
+                                    _state_views->on_changed_objects(*_chain_db, note);
+                                });
+                                _state_views_block_connection = _chain_db->applied_block.connect([this](const signed_block &b) {
+                                    _state_views->on_block(b.block_num());
+                                });
+                            }
+
                             if (_options->count("force-validate")) {
                                 ilog("All transaction signatures will be validated");
                                 _force_validate = true;
@@ -343,6 +467,44 @@ namespace steemit {
                                 _public_apis.push_back(name);
                             }
                         }
+                        _api_metrics = std::make_shared<api_metrics>(
+                                fc::milliseconds(_options->at("api-slow-call-threshold").as<uint32_t>()));
+
+                        uint32_t api_threads = _options->at("api-threads").as<uint32_t>();
+                        ilog("Executing read only API calls on ${n} threads", ("n", api_threads));
+
+                        api_admission_limits limits;
+                        limits.max_queued_calls = _options->at("api-max-queued-calls").as<uint32_t>();
+                        limits.max_session_calls = _options->at("api-max-session-calls").as<uint32_t>();
+                        _max_batch_size = _options->at("api-max-batch-size").as<uint32_t>();
+                        if (_max_batch_size > limits.max_session_calls) {
+                            // Every call of a batch is in flight at once, a larger batch would get some rejected
+                            wlog("api-max-batch-size is lowered to api-max-session-calls, ${n}",
+                                    ("n", limits.max_session_calls));
+                            _max_batch_size = limits.max_session_calls;
+                        }
+                        limits.max_method_calls = _options->at("api-max-method-calls").as<uint32_t>();
+                        limits.max_normal_cost = _options->at("api-max-normal-cost").as<uint64_t>();
+
+                        std::map<std::string, uint32_t> weights = {
+                                {"database_api.get_state",           200},
+                                {"database_api.get_account_history", 200},
+                                {"database_api.get_blocks",          200},
+                                {"database_api.get_content_replies", 20}
+                        };
+                        if (_options->count("api-method-weight")) {
+                            for (const std::string &arg : _options->at("api-method-weight").as<std::vector<std::string>>()) {
+                                auto pos = arg.find('=');
+                                FC_ASSERT(pos != std::string::npos, "api-method-weight must be <api>.<method>=<weight>, got ${arg}",
+                                        ("arg", arg));
+                                weights[arg.substr(0, pos)] = boost::lexical_cast<uint32_t>(arg.substr(pos + 1));
+                            }
+                        }
+
+                        _api_admission = std::make_shared<api_admission>(limits, api_threads, std::move(weights),
+                                std::vector<std::string>{"login_api", "network_broadcast_api"});
+                        _api_executor = std::make_shared<api_executor>(api_threads, _api_admission, _api_metrics);
+
                         _running = true;
 
                         if (!read_only) {
@@ -374,6 +536,29 @@ namespace steemit {
                     _api_factories_by_name[name] = factory;
                 }
 
+                void register_shared_api_factory(const string &name,
+                                                 std::function<std::shared_ptr<void>(const api_context &)> create,
+                                                 std::function<fc::api_ptr(const std::shared_ptr<void> &)> wrap) {
+                    _api_factories_by_name[name] = [this, name, create, wrap](const api_context &) {
+                        std::lock_guard<std::recursive_mutex> lock(_shared_apis_mutex);
+                        auto instance = get_shared_api_instance(name, create);
+                        auto &api = _shared_apis[name].api;
+                        if (!api) {
+                            api = wrap(instance);
+                        }
+                        return api;
+                    };
+                }
+
+                std::shared_ptr<void> get_shared_api_instance(const string &name, const std::function<std::shared_ptr<void>(const api_context &)> &create) {
+                    std::lock_guard<std::recursive_mutex> lock(_shared_apis_mutex);
+                    auto &instance = _shared_apis[name].instance;
+                    if (!instance) {
+                        instance = create(api_context(*_self, name, std::weak_ptr<api_session_data>()));
+                    }
+                    return instance;
+                }
+
                 fc::api_ptr create_api_by_name(const api_context &ctx) {
                     auto it = _api_factories_by_name.find(ctx.api_name);
                     if (it == _api_factories_by_name.end()) {
@@ -483,7 +668,7 @@ namespace steemit {
                 virtual void handle_transaction(const graphene::net::trx_message &transaction_message) override {
                     try {
                         if (_running) {
-                            _chain_db->push_transaction(transaction_message.trx);
+                            _self->push_transaction(transaction_message.trx);
                         }
                     } FC_CAPTURE_AND_RETHROW((transaction_message))
                 }
@@ -816,6 +1001,30 @@ namespace steemit {
                     // notify GUI or something cool
                 }
 
+                void reindex_plugins(const vector<string> &args) {
+                    for (const auto &arg : args) {
+                        vector<string> names;
+                        boost::split(names, arg, boost::is_any_of(" \t,"));
+                        for (const std::string &name : names) {
+                            if (name.empty()) {
+                                continue;
+                            }
+
+                            auto itr = _plugins_enabled.find(name);
+                            FC_ASSERT(itr != _plugins_enabled.end(), "Plugin ${name} to reindex is not enabled", ("name", name));
+
+                            ilog("Reindexing plugin ${name}", ("name", name));
+                            auto start = fc::time_point::now();
+                            _chain_db->with_write_lock([&]() {
+                                FC_ASSERT(itr->second->plugin_reindex(),
+                                        "Plugin ${name} cannot be reindexed without replaying the blockchain", ("name", name));
+                            });
+                            ilog("Done reindexing plugin ${name}, elapsed time: ${t} sec",
+                                    ("name", name)("t", double((fc::time_point::now() - start).count()) / 1000000.0));
+                        }
+                    }
+                }
+
                 void get_max_block_age(int32_t &result) {
                     result = _max_block_age;
                     return;
@@ -828,6 +1037,10 @@ namespace steemit {
                         _p2p_network->close();
                         fc::usleep(fc::seconds(1)); // p2p node has some calls to the database, give it a second to shutdown before invalidating the chain db pointer
                     }
+                    _trx_prechecker.reset();
+                    if (_plugin_pipeline) {
+                        _plugin_pipeline->shutdown();
+                    }
                     if (_chain_db) {
                         _chain_db->close();
                     }
@@ -842,6 +1055,20 @@ namespace steemit {
 
                 //std::shared_ptr<graphene::db::object_database>   _pending_trx_db;
                 std::shared_ptr<steemit::chain::database> _chain_db;
+                std::shared_ptr<transaction_prechecker> _trx_prechecker;
+
+                std::shared_ptr<api_admission> _api_admission;
+                uint32_t _max_batch_size = 16;
+                /// Executes API methods marked with FC_API_READ_ONLY on its threads, each call takes its own read lock
+                std::shared_ptr<api_executor> _api_executor;
+                std::shared_ptr<plugin_pipeline> _plugin_pipeline;
+
+                std::shared_ptr<response_cache> _response_cache;
+                boost::signals2::scoped_connection _response_cache_connection;
+                std::shared_ptr<state_views> _state_views;
+                boost::signals2::scoped_connection _state_views_objects_connection;
+                boost::signals2::scoped_connection _state_views_block_connection;
+                std::shared_ptr<api_metrics> _api_metrics;
                 std::shared_ptr<graphene::net::node> _p2p_network;
                 std::shared_ptr<fc::http::websocket_server> _websocket_server;
                 std::shared_ptr<fc::http::websocket_tls_server> _websocket_tls_server;
@@ -849,7 +1076,16 @@ namespace steemit {
                 std::map<string, std::shared_ptr<abstract_plugin>> _plugins_available;
                 std::map<string, std::shared_ptr<abstract_plugin>> _plugins_enabled;
                 flat_map<std::string, std::function<fc::api_ptr(const api_context &)>> _api_factories_by_name;
+                /// The instance of a shared API, and the fc::api handed to every session if it was registered
+                struct shared_api {
+                    std::shared_ptr<void> instance;
+                    fc::api_ptr api;
+                };
+                /// Shared APIs are created by the first session using them, a shared API may create another one
+                std::recursive_mutex _shared_apis_mutex;
+                std::map<std::string, shared_api> _shared_apis;
                 std::vector<std::string> _public_apis;
+                std::set<std::string> _async_plugins;
                 int32_t _max_block_age = -1;
                 uint64_t _shared_file_size;
 
@@ -907,11 +1143,32 @@ namespace steemit {
                     ("api-user", bpo::value<vector<string>>()->composing(), "API user specification, may be specified multiple times")
                     ("public-api", bpo::value<vector<string>>()->composing()->default_value(default_apis, str_default_apis), "Set an API to be publicly available, may be specified multiple times")
                     ("enable-plugin", bpo::value<vector<string>>()->composing()->default_value(default_plugins, str_default_plugins), "Plugin(s) to enable, may be specified multiple times")
+                    ("async-plugins", bpo::value<vector<string>>()->composing(), "Plugin(s) which process blocks on their own thread, behind the chain, may be specified multiple times. Only plugins keeping their state outside of the chain database support it, currently block_info")
                     ("max-block-age", bpo::value<int32_t>()->default_value(200), "Maximum age of head block when broadcasting tx via API")
-                    ("flush", bpo::value<uint32_t>()->default_value(100000), "Flush shared memory file to disk this many blocks");
+                    ("flush", bpo::value<uint32_t>()->default_value(100000), "Flush shared memory file to disk this many blocks")
+                    ("store-transaction-index", bpo::bool_switch()->default_value(false), "Maintain an on-disk index of irreversible transaction ids for get_transaction, always on with store-account-history")
+                    ("store-vote-archive", bpo::bool_switch()->default_value(false), "Keep votes of comments which can no longer be paid out in an on-disk archive for get_active_votes and get_account_votes")
+                    ("max-pending-transactions", bpo::value<uint32_t>()->default_value(10000), "Maximum number of pending transactions, the oldest are dropped when it is reached, 0 means no limit")
+                    ("max-pending-transactions-size", bpo::value<string>()->default_value("16M"), "Maximum total size of pending transactions, the oldest are dropped when it is reached, 0 means no limit")
+                    ("precheck-threads", bpo::value<uint32_t>()->default_value(2), "Number of threads checking incoming transactions before they are pushed, 0 to check them under the write lock")
+                    ("api-threads", bpo::value<uint32_t>()->default_value(2), "Number of threads executing read only API calls, 0 to execute them on the main thread")
+                    ("api-response-cache-size", bpo::value<string>()->default_value("64M"), "Maximum estimated size of discussion and state query results cached until the next block, 0 to disable the cache")
+                    ("api-max-queued-calls", bpo::value<uint32_t>()->default_value(1000), "Maximum number of read only API calls waiting for an API thread, further calls are rejected")
+                    ("api-max-session-calls", bpo::value<uint32_t>()->default_value(16), "Maximum number of API calls in flight on one connection")
+                    ("api-max-batch-size", bpo::value<uint32_t>()->default_value(16), "Maximum number of requests in one JSON-RPC batch, larger batches are rejected, at most api-max-session-calls")
+                    ("api-max-method-calls", bpo::value<uint32_t>()->default_value(32), "Maximum number of calls of one API method in flight, broadcasts are not limited")
+                    ("api-max-normal-cost", bpo::value<uint64_t>()->default_value(100), "API calls estimated to cost more than this wait behind cheaper calls")
+                    ("api-method-weight", bpo::value<std::vector<std::string>>()->composing(), "Cost of one result of an API method as <api>.<method>=<weight>, the cost of a call is the weight times its query limit (may specify multiple times)")
+                    ("api-slow-call-threshold", bpo::value<uint32_t>()->default_value(1000), "Log API calls taking longer than this many milliseconds with their arguments, 0 to disable")
+                    ("api-state-views-size", bpo::value<uint32_t>()->default_value(10000), "Maximum number of accounts get_state keeps across blocks, 0 to build every state from scratch")
+                    ("block-profiling", bpo::value<bool>()->default_value(true), "Collect timing of block application phases")
+                    ("slow-block-threshold", bpo::value<uint32_t>()->default_value(1000), "Log the breakdown of blocks applied slower than this many milliseconds, 0 to disable")
+                    ("operation-profiling", bpo::value<bool>()->default_value(true), "Collect timing of evaluators and plugin handlers per operation type")
+                    ("operation-profile-log-interval", bpo::value<uint32_t>()->default_value(28800), "Log the operation profile every this many blocks, 0 to disable");
             command_line_options.add(configuration_file_options);
             command_line_options.add_options()
                     ("replay-blockchain", "Rebuild object graph by replaying all blocks")
+                    ("reindex-plugin", bpo::value<vector<string>>()->composing(), "Rebuild the indexes of a plugin from the chain state and the stored operation history, without replaying the blockchain (may specify multiple times)")
                     ("resync-blockchain", "Delete all blocks and re-sync with network from scratch")
                     ("force-validate", "Force validation of all transactions")
                     ("read-only", "Node will not connect to p2p network and can only read from the chain state")
@@ -938,15 +1195,33 @@ namespace steemit {
         }
 
         std::shared_ptr<abstract_plugin> application::get_plugin(const string &name) const {
-            try {
-                return my->_plugins_enabled.at(name);
-            }
-            catch (...) {
+            auto itr = my->_plugins_enabled.find(name);
+            if (itr != my->_plugins_enabled.end()) {
+                return itr->second;
             }
-
             return null_plugin;
         }
 
+        bool application::is_plugin_async(const std::string &name) const {
+            return my->_async_plugins.find(name) != my->_async_plugins.end();
+        }
+
+        std::shared_ptr<plugin_pipeline> application::get_plugin_pipeline() const {
+            return my->_plugin_pipeline;
+        }
+
+        std::shared_ptr<response_cache> application::get_response_cache() const {
+            return my->_response_cache;
+        }
+
+        std::shared_ptr<state_views> application::get_state_views() const {
+            return my->_state_views;
+        }
+
+        std::shared_ptr<api_metrics> application::get_api_metrics() const {
+            return my->_api_metrics;
+        }
+
         graphene::net::node_ptr application::p2p_node() {
             return my->_p2p_network;
         }
@@ -964,6 +1239,11 @@ namespace steemit {
             my->_is_block_producer = producing_blocks;
         }
 
+        void application::push_transaction(const protocol::signed_transaction &trx) {
+            FC_ASSERT(my->_trx_prechecker, "Node is not running in write mode");
+            my->_trx_prechecker->push_transaction(trx);
+        }
+
         optional<api_access_info> application::get_api_access_info(const string &username) const {
             return my->get_api_access_info(username);
         }
@@ -976,6 +1256,16 @@ namespace steemit {
             return my->register_api_factory(name, factory);
         }
 
+        void application::register_shared_api_factory(const string &name,
+                                                      std::function<std::shared_ptr<void>(const api_context &)> create,
+                                                      std::function<fc::api_ptr(const std::shared_ptr<void> &)> wrap) {
+            return my->register_shared_api_factory(name, create, wrap);
+        }
+
+        std::shared_ptr<void> application::get_shared_api_instance(const string &name, const std::function<std::shared_ptr<void>(const api_context &)> &create) {
+            return my->get_shared_api_instance(name, create);
+        }
+
         fc::api_ptr application::create_api_by_name(const api_context &ctx) {
             return my->create_api_by_name(ctx);
         }
@@ -1029,10 +1319,26 @@ namespace steemit {
                     }
                 }
             }
+            if (options.count("async-plugins") > 0) {
+                for (auto &arg : options.at("async-plugins").as<std::vector<std::string>>()) {
+                    vector<string> names;
+                    boost::split(names, arg, boost::is_any_of(" \t,"));
+                    for (const std::string &name : names) {
+                        if (!name.empty()) {
+                            my->_async_plugins.insert(name);
+                        }
+                    }
+                }
+            }
             for (auto &entry : my->_plugins_enabled) {
                 ilog("Initializing plugin ${name}", ("name", entry.first));
                 entry.second->plugin_initialize(options);
             }
+            for (const auto &name : my->_async_plugins) {
+                if (!my->_plugin_pipeline->has_consumer(name)) {
+                    wlog("Plugin ${name} keeps its state in the chain database or is not enabled, it cannot process blocks asynchronously", ("name", name));
+                }
+            }
             return;
         }
 
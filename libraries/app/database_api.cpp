@@ -1,16 +1,28 @@
 #include <steemit/app/api_context.hpp>
+#include <steemit/app/api_metrics.hpp>
 #include <steemit/app/application.hpp>
 #include <steemit/app/database_api.hpp>
+#include <steemit/app/response_cache.hpp>
+#include <steemit/app/state_views.hpp>
 
 #include <steemit/protocol/get_config.hpp>
+#include <steemit/protocol/impacted.hpp>
+#include <steemit/protocol/operation_util_impl.hpp>
 
 #include <fc/bloom_filter.hpp>
+#include <fc/crypto/base64.hpp>
+#include <fc/crypto/hex.hpp>
+#include <fc/io/raw.hpp>
 #include <fc/smart_ref_impl.hpp>
+#include <fc/thread/thread.hpp>
 
 #include <boost/range/iterator_range.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <cfenv>
+#include <deque>
+#include <mutex>
 
 #define GET_REQUIRED_FEES_MAX_RECURSION 4
 
@@ -18,6 +30,21 @@ namespace steemit {
     namespace app {
         class database_api_impl;
 
+        /**
+         * A block operations callback with its filter, shared with the tasks filtering and sending the blocks
+         * after the write lock is released. Tasks run in the order the blocks were applied and popped in.
+         */
+        struct block_operations_subscription {
+            std::function<void(const fc::variant &)> callback;
+            block_operations_filter filter;
+            flat_set<int> types; ///< which() of the operation types in the filter
+            std::deque<std::pair<uint32_t, fc::variant>> pending; ///< blocks waiting to become irreversible
+
+            void on_block(const chain::block_notification &note);
+
+            void on_popped_block(uint32_t block_num);
+        };
+
         class database_api_impl
                 : public std::enable_shared_from_this<database_api_impl> {
         public:
@@ -32,6 +59,8 @@ namespace steemit {
 
             void set_block_applied_callback(std::function<void(const variant &block_id)> cb);
 
+            void set_block_operations_callback(std::function<void(const variant &)> cb, const block_operations_filter &filter);
+
             void cancel_all_subscriptions();
 
             // Blocks and transactions
@@ -88,6 +117,53 @@ namespace steemit {
             // signal handlers
             void on_applied_block(const chain::signed_block &b);
 
+            void on_changed_objects(const chain::changed_objects_notification &note);
+
+            void send_changed_objects(const chain::changed_objects_notification &note);
+
+            void on_block_operations(const chain::block_notification &note);
+
+            void on_popped_block(const chain::signed_block &b);
+
+            /**
+             * Add a key of an object returned to the client to the subscribe filter, so its changes are published
+             * to the subscribe callback. Accounts are keyed by name, comments by author/permlink, removed objects
+             * by type:id.
+             */
+            void subscribe_to_item(const std::string &key) const;
+
+            bool is_subscribed_to_item(const std::string &key) const;
+
+            bool has_subscribe_callback() const;
+
+            /**
+             * Return the result of read() for the method and arguments from the shared response cache, calling it
+             * under the read lock and caching its result if it is not there. Sessions with a subscribe callback
+             * always read, as the lookups they make subscribe them to the objects returned.
+             */
+            template<typename Lambda>
+            auto cached_read(const char *method, const fc::variant &args, Lambda &&read) const -> decltype(read()) {
+                typedef decltype(read()) result_type;
+
+                if (!_response_cache || has_subscribe_callback()) {
+                    return _db.with_read_lock([&]() { return read(); });
+                }
+
+                std::string key = std::string(method) + fc::json::to_string(args);
+                auto cached = _response_cache->find(key);
+                if (cached) {
+                    return *std::static_pointer_cast<const result_type>(cached);
+                }
+
+                auto generation = _response_cache->generation();
+                auto result = std::make_shared<const result_type>(_db.with_read_lock([&]() { return read(); }));
+                // The packed size stands in for the size in memory, it is proportional and cheap to compute
+                _response_cache->insert(key, result, fc::raw::pack_size(*result), generation);
+                return *result;
+            }
+
+            /// Read only calls may run on API threads and subscribe to items concurrently with the main thread
+            mutable std::mutex _subscribe_mutex;
             mutable fc::bloom_filter _subscribe_filter;
             std::function<void(const fc::variant &)> _subscribe_callback;
             std::function<void(const fc::variant &)> _pending_trx_callback;
@@ -95,8 +171,17 @@ namespace steemit {
 
             steemit::chain::database &_db;
             std::shared_ptr<steemit::follow::follow_api> _follow_api;
+            std::shared_ptr<plugin_pipeline> _plugin_pipeline;
+            std::shared_ptr<response_cache> _response_cache;
+            std::shared_ptr<state_views> _state_views;
+            std::shared_ptr<api_metrics> _api_metrics;
 
             boost::signals2::scoped_connection _block_applied_connection;
+            boost::signals2::scoped_connection _changed_objects_connection;
+
+            std::shared_ptr<block_operations_subscription> _block_operations;
+            boost::signals2::scoped_connection _block_operations_connection;
+            boost::signals2::scoped_connection _popped_block_connection;
         };
 
         applied_operation::applied_operation() {
@@ -113,6 +198,16 @@ namespace steemit {
             op = fc::raw::unpack<operation>(op_obj.serialized_op);
         }
 
+        applied_operation::applied_operation(const history_operation &op)
+                : trx_id(op.trx_id),
+                  block(op.block),
+                  trx_in_block(op.trx_in_block),
+                  op_in_trx(op.op_in_trx),
+                  virtual_op(op.virtual_op),
+                  timestamp(op.timestamp) {
+            this->op = fc::raw::unpack<operation>(op.serialized_op);
+        }
+
         void find_accounts(std::set<std::string> &accounts, const discussion &d) {
             accounts.insert(d.author);
         }
@@ -130,14 +225,163 @@ namespace steemit {
         }
 
         void database_api_impl::set_subscribe_callback(std::function<void(const variant &)> cb, bool clear_filter) {
-            _subscribe_callback = cb;
-            if (clear_filter || !cb) {
-                static fc::bloom_parameters param;
-                param.projected_element_count = 10000;
-                param.false_positive_probability = 1.0 / 10000;
-                param.maximum_size = 1024 * 8 * 8 * 2;
-                param.compute_optimal_parameters();
-                _subscribe_filter = fc::bloom_filter(param);
+            {
+                std::lock_guard<std::mutex> lock(_subscribe_mutex);
+                _subscribe_callback = cb;
+                if (clear_filter || !cb) {
+                    static fc::bloom_parameters param;
+                    param.projected_element_count = 10000;
+                    param.false_positive_probability = 1.0 / 10000;
+                    param.maximum_size = 1024 * 8 * 8 * 2;
+                    param.compute_optimal_parameters();
+                    _subscribe_filter = fc::bloom_filter(param);
+                }
+            }
+
+            if (cb) {
+                if (!_changed_objects_connection.connected()) {
+                    _changed_objects_connection = connect_signal(_db.changed_objects, *this, &database_api_impl::on_changed_objects);
+                }
+            } else {
+                _changed_objects_connection.disconnect();
+            }
+        }
+
+        void database_api_impl::subscribe_to_item(const std::string &key) const {
+            std::lock_guard<std::mutex> lock(_subscribe_mutex);
+            if (_subscribe_callback) {
+                _subscribe_filter.insert(key);
+            }
+        }
+
+        bool database_api_impl::is_subscribed_to_item(const std::string &key) const {
+            std::lock_guard<std::mutex> lock(_subscribe_mutex);
+            return _subscribe_filter.contains(key);
+        }
+
+        bool database_api_impl::has_subscribe_callback() const {
+            std::lock_guard<std::mutex> lock(_subscribe_mutex);
+            return bool(_subscribe_callback);
+        }
+
+        /**
+         * Publishes the changes of a block to the objects the client looked up, in one notification:
+         * {"block_num": ..., "accounts": [...], "comments": [...], "removed": ["account:<id>", ...]}
+         */
+        void database_api_impl::on_changed_objects(const chain::changed_objects_notification &note) {
+            if (!has_subscribe_callback()) {
+                return;
+            }
+
+            // Only the ids are copied under the write lock, they are filtered and looked up after
+            auto shared_note = std::make_shared<chain::changed_objects_notification>();
+            shared_note->block_num = note.block_num;
+            for (const auto &ids : note.objects) {
+                if (ids.type == account_object_type || ids.type == account_metadata_object_type ||
+                    ids.type == comment_object_type) {
+                    shared_note->objects.push_back(ids);
+                }
+            }
+            if (shared_note->objects.empty()) {
+                return;
+            }
+
+            std::weak_ptr<database_api_impl> weak_self = shared_from_this();
+            fc::async([weak_self, shared_note]() {
+                auto self = weak_self.lock();
+                if (self) {
+                    self->send_changed_objects(*shared_note);
+                }
+            }, "send object updates");
+        }
+
+        void database_api_impl::send_changed_objects(const chain::changed_objects_notification &note) {
+            std::function<void(const fc::variant &)> cb;
+            {
+                std::lock_guard<std::mutex> lock(_subscribe_mutex);
+                cb = _subscribe_callback;
+            }
+            if (!cb) {
+                return;
+            }
+
+            fc::variant update = _db.with_read_lock([&]() -> fc::variant {
+                std::vector<account_api_obj> accounts;
+                std::vector<comment_api_obj> comments;
+                std::vector<std::string> removed;
+                flat_set<account_name_type> changed_accounts;
+
+                for (const auto &ids : note.objects) {
+                    if (ids.type == account_object_type) {
+                        for (const auto &changed : {&ids.created, &ids.modified}) {
+                            for (auto id : *changed) {
+                                const auto *account = _db.find<account_object>(account_id_type(id));
+                                if (account != nullptr && is_subscribed_to_item(account->name)) {
+                                    changed_accounts.insert(account->name);
+                                }
+                            }
+                        }
+                        for (auto id : ids.removed) {
+                            std::string key = "account:" + std::to_string(id);
+                            if (is_subscribed_to_item(key)) {
+                                removed.push_back(key);
+                            }
+                        }
+                    } else if (ids.type == account_metadata_object_type) {
+                        // Part of the account_api_obj of the account
+                        for (auto id : ids.modified) {
+                            const auto *meta = _db.find<account_metadata_object>(account_metadata_id_type(id));
+                            if (meta != nullptr && is_subscribed_to_item(meta->account)) {
+                                changed_accounts.insert(meta->account);
+                            }
+                        }
+                    } else if (ids.type == comment_object_type) {
+                        for (const auto &changed : {&ids.created, &ids.modified}) {
+                            for (auto id : *changed) {
+                                const auto *comment = _db.find<comment_object>(comment_id_type(id));
+                                if (comment != nullptr &&
+                                    is_subscribed_to_item(std::string(comment->author) + "/" + to_string(comment->permlink))) {
+                                    comments.emplace_back(*comment, _db);
+                                    comments.back().set_content(_db.get_comment_content(*comment));
+                                }
+                            }
+                        }
+                        for (auto id : ids.removed) {
+                            std::string key = "comment:" + std::to_string(id);
+                            if (is_subscribed_to_item(key)) {
+                                removed.push_back(key);
+                            }
+                        }
+                    }
+                }
+
+                for (const auto &name : changed_accounts) {
+                    const auto *account = _db.find_account(name);
+                    if (account != nullptr) {
+                        accounts.emplace_back(*account, _db);
+                    }
+                }
+
+                if (accounts.empty() && comments.empty() && removed.empty()) {
+                    return fc::variant();
+                }
+
+                return fc::mutable_variant_object()
+                        ("block_num", note.block_num)
+                        ("accounts", accounts)
+                        ("comments", comments)
+                        ("removed", removed);
+            });
+
+            if (update.is_null()) {
+                return;
+            }
+
+            try {
+                cb(update);
+            }
+            catch (const fc::exception &e) {
+                wlog("Failed to send object updates: ${e}", ("e", e.to_string()));
             }
         }
 
@@ -171,6 +415,131 @@ namespace steemit {
             _block_applied_connection = connect_signal(_db.applied_block, *this, &database_api_impl::on_applied_block);
         }
 
+        void database_api::set_block_operations_callback(std::function<void(const variant &)> cb, const block_operations_filter &filter) {
+            my->_db.with_read_lock([&]() {
+                my->set_block_operations_callback(cb, filter);
+            });
+        }
+
+        void database_api_impl::set_block_operations_callback(std::function<void(const variant &)> cb, const block_operations_filter &filter) {
+            flat_set<int> types;
+            if (!filter.operations.empty()) {
+                std::map<std::string, int> names;
+                for (int i = 0; i < operation::count(); ++i) {
+                    operation op;
+                    op.set_which(i);
+                    std::string name;
+                    op.visit(fc::get_operation_name(name));
+                    names[name] = i;
+                }
+                for (const auto &name : filter.operations) {
+                    auto itr = names.find(name);
+                    FC_ASSERT(itr != names.end(), "Unknown operation ${o}", ("o", name));
+                    types.insert(itr->second);
+                }
+            }
+
+            // Tasks of the previous subscription still in flight keep sending to its callback
+            _block_operations.reset();
+            if (cb) {
+                _block_operations = std::make_shared<block_operations_subscription>();
+                _block_operations->callback = cb;
+                _block_operations->filter = filter;
+                _block_operations->types = std::move(types);
+
+                if (!_block_operations_connection.connected()) {
+                    _block_operations_connection = connect_signal(_db.applied_block_operations, *this, &database_api_impl::on_block_operations);
+                    _popped_block_connection = connect_signal(_db.popped_block, *this, &database_api_impl::on_popped_block);
+                    _db.set_collect_block_operations(true);
+                }
+            } else if (_block_operations_connection.connected()) {
+                _block_operations_connection.disconnect();
+                _popped_block_connection.disconnect();
+                _db.set_collect_block_operations(false);
+            }
+        }
+
+        void database_api_impl::on_block_operations(const chain::block_notification &note) {
+            if (!_block_operations) {
+                return;
+            }
+
+            // Only the notification is copied under the write lock, it is filtered and serialized after
+            auto subscription = _block_operations;
+            auto shared_note = std::make_shared<const chain::block_notification>(note);
+            fc::async([subscription, shared_note]() {
+                subscription->on_block(*shared_note);
+            }, "send block operations");
+        }
+
+        void database_api_impl::on_popped_block(const chain::signed_block &b) {
+            if (!_block_operations) {
+                return;
+            }
+
+            auto subscription = _block_operations;
+            auto block_num = b.block_num();
+            fc::async([subscription, block_num]() {
+                subscription->on_popped_block(block_num);
+            }, "pop block operations");
+        }
+
+        void block_operations_subscription::on_block(const chain::block_notification &note) {
+            std::vector<chain::block_operation> operations;
+            for (const auto &op : note.operations) {
+                if (op.virtual_op && !filter.virtual_ops) {
+                    continue;
+                }
+                if (!types.empty() && !types.count(op.op.which())) {
+                    continue;
+                }
+                if (!filter.accounts.empty() &&
+                    std::none_of(op.impacted.begin(), op.impacted.end(), [&](const account_name_type &a) {
+                        return filter.accounts.count(std::string(a)) != 0;
+                    })) {
+                    continue;
+                }
+                operations.push_back(op);
+            }
+
+            auto block_num = note.block.block_num();
+            fc::mutable_variant_object update;
+            update("block_num", block_num)
+                    ("block_id", note.block.id())
+                    ("timestamp", note.block.timestamp);
+            if (filter.binary) {
+                update("operations", fc::to_hex(fc::raw::pack(operations)));
+            } else {
+                update("operations", operations);
+            }
+
+            std::vector<fc::variant> updates;
+            if (filter.irreversible) {
+                pending.emplace_back(block_num, fc::variant(std::move(update)));
+                while (!pending.empty() && pending.front().first <= note.props.last_irreversible_block_num) {
+                    updates.push_back(std::move(pending.front().second));
+                    pending.pop_front();
+                }
+            } else {
+                updates.push_back(fc::variant(std::move(update)));
+            }
+
+            try {
+                for (const auto &u : updates) {
+                    callback(u);
+                }
+            }
+            catch (const fc::exception &e) {
+                wlog("Failed to send block operations: ${e}", ("e", e.to_string()));
+            }
+        }
+
+        void block_operations_subscription::on_popped_block(uint32_t block_num) {
+            while (!pending.empty() && pending.back().first >= block_num) {
+                pending.pop_back();
+            }
+        }
+
         void database_api::cancel_all_subscriptions() {
             my->_db.with_read_lock([&]() {
                 my->cancel_all_subscriptions();
@@ -179,6 +548,7 @@ namespace steemit {
 
         void database_api_impl::cancel_all_subscriptions() {
             set_subscribe_callback(std::function<void(const fc::variant &)>(), true);
+            set_block_operations_callback(std::function<void(const fc::variant &)>(), block_operations_filter());
         }
 
 //////////////////////////////////////////////////////////////////////
@@ -195,20 +565,21 @@ namespace steemit {
         }
 
         database_api_impl::database_api_impl(const steemit::app::api_context &ctx)
-                : _db(*ctx.app.chain_database()) {
-            wlog("creating database api ${x}", ("x", int64_t(this)));
-
-            try {
-                ctx.app.get_plugin<follow::follow_plugin>(FOLLOW_PLUGIN_NAME);
-                _follow_api = std::make_shared<steemit::follow::follow_api>(ctx);
-            }
-            catch (fc::assert_exception) {
-                ilog("Follow Plugin not loaded");
+                : _db(*ctx.app.chain_database()),
+                  _plugin_pipeline(ctx.app.get_plugin_pipeline()),
+                  _response_cache(ctx.app.get_response_cache()),
+                  _state_views(ctx.app.get_state_views()),
+                  _api_metrics(ctx.app.get_api_metrics()) {
+            // Built for every connection, so anything which isn't per session is shared
+            if (ctx.app.get_plugin(FOLLOW_PLUGIN_NAME)) {
+                _follow_api = ctx.app.get_shared_api<steemit::follow::follow_api>("follow_api");
             }
         }
 
         database_api_impl::~database_api_impl() {
-            elog("freeing database api ${x}", ("x", int64_t(this)));
+            if (_block_operations_connection.connected()) {
+                _db.set_collect_block_operations(false);
+            }
         }
 
         void database_api::on_api_startup() {
@@ -244,6 +615,44 @@ namespace steemit {
             return _db.fetch_block_by_number(block_num);
         }
 
+        block_range database_api::get_blocks(uint32_t start, uint32_t count, block_format format) const {
+            FC_ASSERT(count <= 1000, "Can not return more than 1000 blocks");
+
+            block_range result;
+            auto add_raw = [&](const std::vector<char> &data) {
+                if (format == block_format::raw) {
+                    result.raw_blocks.push_back(fc::base64_encode(data.data(), data.size()));
+                } else {
+                    result.blocks.push_back(fc::raw::unpack<signed_block>(data));
+                }
+            };
+
+            // The block log only holds irreversible blocks and has a lock of its own
+            auto raw_blocks = my->_db.get_block_log().read_raw_blocks(start, count);
+            for (const auto &data : raw_blocks) {
+                add_raw(data);
+            }
+
+            uint64_t next = uint64_t(start) + raw_blocks.size();
+            uint64_t end = uint64_t(start) + count;
+            if (next < end) {
+                my->_db.with_read_lock([&]() {
+                    for (; next < end; ++next) {
+                        auto block = my->_db.fetch_block_by_number(static_cast<uint32_t>(next));
+                        if (!block) {
+                            break;
+                        }
+                        if (format == block_format::raw) {
+                            add_raw(fc::raw::pack(*block));
+                        } else {
+                            result.blocks.push_back(std::move(*block));
+                        }
+                    }
+                });
+            }
+            return result;
+        }
+
         std::vector<applied_operation> database_api::get_ops_in_block(uint32_t block_num, bool only_virtual) const {
             return my->_db.with_read_lock([&]() {
                 return my->get_ops_in_block(block_num, only_virtual);
@@ -251,10 +660,22 @@ namespace steemit {
         }
 
         std::vector<applied_operation> database_api_impl::get_ops_in_block(uint32_t block_num, bool only_virtual) const {
-            const auto &idx = _db.get_index<operation_index>().indices().get<by_location>();
-            auto itr = idx.lower_bound(block_num);
             std::vector<applied_operation> result;
             applied_operation temp;
+
+            if (_db.store_account_history() &&
+                block_num <= _db.get_history_log().head_block_num()) {
+                for (const auto &op : _db.get_history_log().get_block_operations(block_num)) {
+                    temp = op;
+                    if (!only_virtual || is_virtual_operation(temp.op)) {
+                        result.push_back(temp);
+                    }
+                }
+                return result;
+            }
+
+            const auto &idx = _db.get_index<operation_index>().indices().get<by_location>();
+            auto itr = idx.lower_bound(block_num);
             while (itr != idx.end() && itr->block == block_num) {
                 temp = *itr;
                 if (!only_virtual || is_virtual_operation(temp.op)) {
@@ -336,6 +757,39 @@ namespace steemit {
             });
         }
 
+        vector<timing_stats> database_api::get_block_profile_stats() const {
+            return my->_db.with_read_lock([&]() {
+                return my->_db.get_block_profiler().get_stats();
+            });
+        }
+
+        vector<operation_profile_stats> database_api::get_operation_profile_stats() const {
+            return my->_db.with_read_lock([&]() {
+                return my->_db.get_operation_profile_stats();
+            });
+        }
+
+        vector<timing_stats> database_api::get_state_profile_stats() const {
+            if (!my->_state_views) {
+                return {};
+            }
+            return my->_state_views->get_stats();
+        }
+
+        vector<api_method_stats> database_api::get_api_call_stats() const {
+            if (!my->_api_metrics) {
+                return {};
+            }
+            return my->_api_metrics->get_stats();
+        }
+
+        vector<pipeline_consumer_status> database_api::get_plugin_pipeline_status() const {
+            if (!my->_plugin_pipeline) {
+                return {};
+            }
+            return my->_plugin_pipeline->get_status();
+        }
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Keys                                                             //
@@ -378,6 +832,8 @@ namespace steemit {
                 auto itr = idx.find(name);
                 if (itr != idx.end()) {
                     results.push_back(extended_account(*itr, _db));
+                    subscribe_to_item(name);
+                    subscribe_to_item("account:" + std::to_string(itr->id._id));
 
                     if (_follow_api) {
                         results.back().reputation = _follow_api->get_account_reputations(itr->name, 1)[0].reputation;
@@ -431,6 +887,8 @@ namespace steemit {
 
                 if (itr) {
                     result.push_back(account_api_obj(*itr, _db));
+                    subscribe_to_item(name);
+                    subscribe_to_item("account:" + std::to_string(itr->id._id));
                 } else {
                     result.push_back(optional<account_api_obj>());
                 }
@@ -922,9 +1380,11 @@ namespace steemit {
                 const auto &by_permlink_idx = my->_db.get_index<comment_index>().indices().get<by_permlink>();
                 auto itr = by_permlink_idx.find(boost::make_tuple(author, permlink));
                 if (itr != by_permlink_idx.end()) {
-                    discussion result(*itr);
+                    discussion result(*itr, my->_db);
                     set_pending_payout(result);
                     result.active_votes = get_active_votes(author, permlink);
+                    my->subscribe_to_item(author + "/" + permlink);
+                    my->subscribe_to_item("comment:" + std::to_string(itr->id._id));
                     return result;
                 }
                 return discussion();
@@ -957,6 +1417,27 @@ namespace steemit {
                     result.push_back(vstate);
                     ++itr;
                 }
+
+                if (result.empty() && comment.mode == archived) {
+                    for (const auto &v : my->_db.get_archived_comment_votes(comment.id)) {
+                        const auto &vo = my->_db.get(account_id_type(v.voter));
+                        vote_state vstate;
+                        vstate.voter = vo.name;
+                        vstate.weight = v.weight;
+                        vstate.rshares = v.rshares;
+                        vstate.percent = v.vote_percent;
+                        vstate.time = v.last_update;
+
+                        if (my->_follow_api) {
+                            auto reps = my->_follow_api->get_account_reputations(vo.name, 1);
+                            if (reps.size()) {
+                                vstate.reputation = reps[0].reputation;
+                            }
+                        }
+
+                        result.push_back(vstate);
+                    }
+                }
                 return result;
             });
         }
@@ -982,6 +1463,20 @@ namespace steemit {
                     result.push_back(avote);
                     ++itr;
                 }
+
+                for (const auto &v : my->_db.get_archived_account_votes(aid)) {
+                    const auto *vo = my->_db.find(comment_id_type(v.comment));
+                    if (vo == nullptr) {
+                        continue;
+                    }
+                    account_vote avote;
+                    avote.authorperm = vo->author + "/" + to_string(vo->permlink);
+                    avote.weight = v.weight;
+                    avote.rshares = v.rshares;
+                    avote.percent = v.vote_percent;
+                    avote.time = v.last_update;
+                    result.push_back(avote);
+                }
                 return result;
             });
         }
@@ -994,6 +1489,11 @@ namespace steemit {
         }
 
         void database_api::set_pending_payout(discussion &d) const {
+            set_content(d);
+            set_discussion_fields(d, discussion_query());
+        }
+
+        void database_api::set_discussion_fields(discussion &d, const discussion_query &query) const {
             const auto &cidx = my->_db.get_index<tags::tag_index>().indices().get<tags::by_comment>();
             auto itr = cidx.lower_bound(d.id);
             if (itr != cidx.end() && itr->comment == d.id) {
@@ -1029,7 +1529,7 @@ namespace steemit {
                 d.pending_payout_value = asset(static_cast<uint64_t>(r2), pot.symbol);
                 d.total_pending_payout_value = asset(static_cast<uint64_t>(tpp), pot.symbol);
 
-                if (my->_follow_api) {
+                if (my->_follow_api && query.has_field("author_reputation")) {
                     d.author_reputation = my->_follow_api->get_account_reputations(d.author, 1)[0].reputation;
                 }
             }
@@ -1045,33 +1545,66 @@ namespace steemit {
                 d.body = "comment pruned due to size";
             }
 
-            set_url(d);
+            if (query.has_field("url")) {
+                set_url(d);
+            }
         }
 
         void database_api::set_url(discussion &d) const {
-            const comment_api_obj root(my->_db.get<comment_object, by_id>(d.root_comment));
+            const auto &root_obj = my->_db.get<comment_object, by_id>(d.root_comment);
+            const comment_api_obj root(root_obj, my->_db);
             d.url = "/" + root.category + "/@" + root.author + "/" +
                     root.permlink;
-            d.root_title = root.title;
             if (root.id != d.id) {
                 d.url += "#@" + d.author + "/" + d.permlink;
+                d.root_title = my->_db.get_comment_content(root_obj).title;
+            } else {
+                d.root_title = d.title;
             }
         }
 
+        /**
+         * Whether the json_metadata of the comment lists a tag the query filters out, it is only loaded for
+         * queries filtering tags.
+         */
+        static bool has_filtered_tag(const comment_api_obj &c, const discussion_query &query) {
+            if (query.filter_tags.empty()) {
+                return false;
+            }
+
+            tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
+
+            for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
+                if (meta.tags.find(iterator) != meta.tags.end()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void database_api::set_content(discussion &d) const {
+            d.set_content(my->_db.get_comment_content(my->_db.get<comment_object>(d.id)));
+        }
+
         std::vector<discussion> database_api::get_content_replies(std::string author, std::string permlink) const {
             return my->_db.with_read_lock([&]() {
+                std::vector<discussion> result;
+                const auto *parent_permlink = my->_db.find_interned_string(permlink);
+                if (parent_permlink == nullptr) {
+                    return result;
+                }
+
                 account_name_type acc_name = account_name_type(author);
                 const auto &by_permlink_idx = my->_db.get_index<comment_index>().indices().get<by_parent>();
-                auto itr = by_permlink_idx.find(boost::make_tuple(acc_name, permlink));
-                std::vector<discussion> result;
+                auto itr = by_permlink_idx.lower_bound(boost::make_tuple(acc_name, parent_permlink->id));
                 while (itr != by_permlink_idx.end() &&
                        itr->parent_author == author &&
-                       to_string(itr->parent_permlink) == permlink) {
+                       itr->parent_permlink == parent_permlink->id) {
 
-                    discussion push_discussion(*itr);
+                    discussion push_discussion(*itr, my->_db);
                     push_discussion.active_votes = get_active_votes(author, permlink);
 
-                    result.push_back(discussion(*itr));
+                    result.push_back(discussion(*itr, my->_db));
                     set_pending_payout(result.back());
                     ++itr;
                 }
@@ -1107,7 +1640,7 @@ namespace steemit {
 
                 while (itr != last_update_idx.end() && result.size() < limit &&
                        itr->parent_author == *parent_author) {
-                    result.push_back(*itr);
+                    result.emplace_back(*itr, my->_db);
                     set_pending_payout(result.back());
                     result.back().active_votes = get_active_votes(itr->author, to_string(itr->permlink));
                     ++itr;
@@ -1125,16 +1658,99 @@ namespace steemit {
                 FC_ASSERT(from >= limit, "From must be greater than limit");
                 //   idump((account)(from)(limit));
                 const auto &idx = my->_db.get_index<account_history_index>().indices().get<by_account>();
-                auto itr = idx.lower_bound(boost::make_tuple(account, from));
-                //   if( itr != idx.end() ) idump((*itr));
-                auto end = idx.upper_bound(boost::make_tuple(account, std::max(int64_t(0),
-                        int64_t(itr->sequence) - limit)));
-                //   if( end != idx.end() ) idump((*end));
+                const auto *acnt = my->_db.find_account(account);
+
+                // Operations of irreversible blocks are in the history log, the objects only hold
+                // reversible blocks and blocks restored by undo, which may overlap with the log
+                uint32_t log_count = 0;
+                if (my->_db.store_account_history() && acnt != nullptr) {
+                    log_count = my->_db.get_history_log().get_account_sequence(acnt->id._id);
+                }
+
+                uint64_t count = log_count;
+                auto top = idx.lower_bound(boost::make_tuple(account, uint32_t(-1)));
+                if (top != idx.end() && top->account == account) {
+                    count = std::max<uint64_t>(count, top->sequence + 1);
+                }
 
                 std::map<uint32_t, applied_operation> result;
-                while (itr != end) {
+                if (count == 0) {
+                    return result;
+                }
+
+                uint32_t start = std::min<uint64_t>(from, count - 1);
+                uint32_t stop = start > limit ? start - limit : 0;
+
+                for (auto itr = idx.lower_bound(boost::make_tuple(account, start));
+                     itr != idx.end() && itr->account == account &&
+                     itr->sequence >= stop; ++itr) {
                     result[itr->sequence] = my->_db.get(itr->op);
-                    ++itr;
+                }
+
+                if (log_count > stop) {
+                    uint32_t log_start = std::min(start, log_count - 1);
+                    for (const auto &op : my->_db.get_history_log().get_account_history(acnt->id._id, log_start, log_start - stop)) {
+                        result.emplace(op.first, op.second);
+                    }
+                }
+                return result;
+            });
+        }
+
+        std::map<uint32_t, applied_operation> database_api::get_account_history_by_type(std::string account, std::vector<std::string> op_types, uint64_t from, uint32_t limit) const {
+            static const auto name_to_tag = []() {
+                std::map<std::string, uint8_t> name_map;
+                for (int i = 0; i < operation::count(); ++i) {
+                    operation tmp;
+                    tmp.set_which(i);
+                    std::string n;
+                    tmp.visit(fc::get_operation_name(n));
+                    name_map[n] = i;
+                    name_map[n + "_operation"] = i;
+                }
+                return name_map;
+            }();
+
+            FC_ASSERT(limit > 0 && limit <=
+                      2000, "Limit of ${l} is not in range (0, 2000]", ("l", limit));
+
+            std::set<uint8_t> tags;
+            uint64_t op_types_mask = 0;
+            for (const auto &name : op_types) {
+                auto itr = name_to_tag.find(name);
+                FC_ASSERT(itr != name_to_tag.end(), "Invalid operation name: ${n}", ("n", name));
+                tags.insert(itr->second);
+                op_types_mask |= uint64_t(1) << itr->second;
+            }
+
+            return my->_db.with_read_lock([&]() {
+                std::map<uint32_t, applied_operation> result;
+                const auto *acnt = my->_db.find_account(account);
+                if (acnt == nullptr) {
+                    return result;
+                }
+
+                uint32_t start = std::min<uint64_t>(from, uint32_t(-1));
+
+                const auto &idx = my->_db.get_index<account_history_index>().indices().get<by_account_op_type>();
+                for (auto tag : tags) {
+                    uint32_t count = 0;
+                    for (auto itr = idx.lower_bound(boost::make_tuple(account, tag, start));
+                         itr != idx.end() && itr->account == account &&
+                         itr->op_type == tag && count < limit; ++itr, ++count) {
+                        result[itr->sequence] = my->_db.get(itr->op);
+                    }
+                }
+
+                if (my->_db.store_account_history()) {
+                    for (const auto &op : my->_db.get_history_log().get_account_history_by_type(acnt->id._id, op_types_mask, start, limit)) {
+                        result.emplace(op.first, op.second);
+                    }
+                }
+
+                // Keep the most recent operations found by the separate lookups
+                while (result.size() > limit) {
+                    result.erase(result.begin());
                 }
                 return result;
             });
@@ -1161,7 +1777,7 @@ namespace steemit {
         }
 
         std::vector<tag_api_obj> database_api::get_trending_tags(std::string after, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_trending_tags", fc::variant(fc::variants{fc::variant(after), fc::variant(limit)}), [&]() {
                 limit = std::min(limit, uint32_t(1000));
                 std::vector<tag_api_obj> result;
                 result.reserve(limit);
@@ -1194,13 +1810,26 @@ namespace steemit {
         }
 
         discussion database_api::get_discussion(comment_id_type id, uint32_t truncate_body) const {
-            discussion d = my->_db.get(id);
-            set_url(d);
-            set_pending_payout(d);
-            d.active_votes = get_active_votes(d.author, d.permlink);
+            discussion_query query;
+            query.truncate_body = truncate_body;
+            return get_discussion(id, query);
+        }
+
+        discussion database_api::get_discussion(comment_id_type id, const discussion_query &query) const {
+            discussion d(my->_db.get(id), my->_db);
+            set_content(d);
+            set_discussion_fields(d, query);
+            if (query.has_field("active_votes")) {
+                d.active_votes = get_active_votes(d.author, d.permlink);
+            }
+            truncate_discussion(d, query);
+            return d;
+        }
+
+        void database_api::truncate_discussion(discussion &d, const discussion_query &query) const {
             d.body_length = static_cast<uint32_t>(d.body.size());
-            if (truncate_body) {
-                d.body = d.body.substr(0, truncate_body);
+            if (query.truncate_body) {
+                d.body = d.body.substr(0, query.truncate_body);
 
                 if (!fc::is_utf8(d.title)) {
                     d.title = fc::prune_invalid_utf8(d.title);
@@ -1218,7 +1847,13 @@ namespace steemit {
                     d.json_metadata = fc::prune_invalid_utf8(d.json_metadata);
                 }
             }
-            return d;
+
+            if (!query.has_field("body")) {
+                d.body.clear();
+            }
+            if (!query.has_field("json_metadata")) {
+                d.json_metadata.clear();
+            }
         }
 
         template<typename Compare, typename Index, typename StartItr>
@@ -1257,15 +1892,28 @@ namespace steemit {
                 }
 
                 try {
-                    discussion insert_discussion = get_discussion(tidx_itr->comment, query.truncate_body);
-                    insert_discussion.promoted = asset(tidx_itr->promoted_balance, SBD_SYMBOL);
+                    // Filters only look at the comment and at the json_metadata of queries filtering tags, so the
+                    // content, payout, url and votes are filled in for the discussions which are returned only
+                    const auto &comment = my->_db.get(tidx_itr->comment);
+                    discussion insert_discussion(comment, my->_db);
+                    if (!query.filter_tags.empty()) {
+                        insert_discussion.json_metadata = my->_db.get_comment_json_metadata(comment);
+                    }
 
                     if (filter(insert_discussion)) {
                         ++filter_count;
                     } else if (exit(insert_discussion) || tag_exit(*tidx_itr)) {
                         break;
                     } else {
-                        result.insert({*tidx_itr, insert_discussion});
+                        set_content(insert_discussion);
+                        set_discussion_fields(insert_discussion, query);
+                        insert_discussion.promoted = asset(tidx_itr->promoted_balance, SBD_SYMBOL);
+                        if (query.has_field("active_votes")) {
+                            insert_discussion.active_votes = get_active_votes(insert_discussion.author, insert_discussion.permlink);
+                        }
+                        truncate_discussion(insert_discussion, query);
+
+                        result.insert({*tidx_itr, std::move(insert_discussion)});
                         --count;
                     }
                 } catch (const fc::exception &e) {
@@ -1289,7 +1937,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_trending(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_trending", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1301,12 +1949,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return c.children_rshares2 <= 0 || c.mode != first_payout ||
@@ -1345,7 +1989,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_promoted(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_promoted", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1357,12 +2001,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return c.children_rshares2 <= 0 ||
@@ -1405,7 +2045,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_trending30(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_trending30", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1417,12 +2057,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return c.children_rshares2 <= 0 ||
@@ -1462,7 +2098,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_created(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_created", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1474,12 +2110,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return query.filter_tags.find(c.category) !=
@@ -1517,7 +2149,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_active(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_active", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1529,12 +2161,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return query.filter_tags.find(c.category) !=
@@ -1572,7 +2200,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_cashout(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_cashout", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1584,12 +2212,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return c.children_rshares2 <= 0 ||
@@ -1630,7 +2254,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_payout(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_payout", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1642,12 +2266,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return c.net_rshares <= 0 ||
@@ -1686,7 +2306,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_votes(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_votes", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1698,12 +2318,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return query.filter_tags.find(c.category) !=
@@ -1741,7 +2357,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_children(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_children", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1753,12 +2369,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return query.filter_tags.find(c.category) !=
@@ -1796,8 +2408,7 @@ namespace steemit {
         }
 
         std::vector<discussion> database_api::get_discussions_by_hot(const discussion_query &query) const {
-
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_discussions_by_hot", fc::variant(query), [&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
@@ -1809,12 +2420,8 @@ namespace steemit {
                         }
                     }
 
-                    tags::comment_metadata meta = fc::json::from_string(c.json_metadata).as<tags::comment_metadata>();
-
-                    for (const std::set<std::string>::value_type &iterator : query.filter_tags) {
-                        if (meta.tags.find(iterator) != meta.tags.end()) {
-                            return true;
-                        }
+                    if (has_filtered_tag(c, query)) {
+                        return true;
                     }
 
                     return c.net_rshares <= 0 ||
@@ -1906,7 +2513,7 @@ namespace steemit {
                                 }
                             }
 
-                            result.push_back(get_discussion(feed_itr->comment));
+                            result.push_back(get_discussion(feed_itr->comment, query));
                             if (feed_itr->first_reblogged_by !=
                                 account_name_type()) {
                                 result.back().reblogged_by = std::vector<account_name_type>(feed_itr->reblogged_by.begin(), feed_itr->reblogged_by.end());
@@ -1980,7 +2587,7 @@ namespace steemit {
                                 }
                             }
 
-                            result.push_back(get_discussion(blog_itr->comment, query.truncate_body));
+                            result.push_back(get_discussion(blog_itr->comment, query));
                             if (blog_itr->reblogged_on > time_point_sec()) {
                                 result.back().first_reblogged_on = blog_itr->reblogged_on;
                             }
@@ -2033,7 +2640,7 @@ namespace steemit {
                                 continue;
                             }
 
-                            result.push_back(get_discussion(comment_itr->id));
+                            result.push_back(get_discussion(comment_itr->id, query));
                         }
                         catch (const fc::exception &e) {
                             edump((e.to_detail_string()));
@@ -2058,7 +2665,8 @@ namespace steemit {
                 const auto &ridx = my->_db.get_index<chain::category_index>().indices().get<by_rshares>();
                 auto itr = ridx.begin();
                 if (after != "" && nidx.size()) {
-                    auto nitr = nidx.lower_bound(after);
+                    const auto *after_name = my->_db.find_interned_string(after);
+                    auto nitr = after_name == nullptr ? nidx.end() : nidx.find(after_name->id);
                     if (nitr == nidx.end()) {
                         itr = ridx.end();
                     } else {
@@ -2067,7 +2675,7 @@ namespace steemit {
                 }
 
                 while (itr != ridx.end() && result.size() < limit) {
-                    result.push_back(category_api_obj(*itr));
+                    result.push_back(category_api_obj(*itr, my->_db));
                     ++itr;
                 }
                 return result;
@@ -2191,7 +2799,7 @@ namespace steemit {
                     while (itr != didx.end() && itr->author == author &&
                            count < limit) {
                         if (itr->parent_author.size() == 0) {
-                            result.push_back(*itr);
+                            result.emplace_back(*itr, my->_db);
                             set_pending_payout(result.back());
                             result.back().active_votes = get_active_votes(itr->author, to_string(itr->permlink));
                             ++count;
@@ -2236,7 +2844,17 @@ namespace steemit {
 
 
         state database_api::get_state(std::string path) const {
-            return my->_db.with_read_lock([&]() {
+            return my->cached_read("get_state", fc::variant(path), [&]() {
+                auto state_start = fc::time_point::now();
+                auto section_start = state_start;
+                auto end_section = [&](const char *section) {
+                    auto now = fc::time_point::now();
+                    if (my->_state_views) {
+                        my->_state_views->record(section, now - section_start);
+                    }
+                    section_start = now;
+                };
+
                 state _state;
                 _state.props = get_dynamic_global_properties();
                 _state.current_route = path;
@@ -2252,10 +2870,21 @@ namespace steemit {
                     }
 
                     /// FETCH CATEGORY STATE
-                    auto trending_tags = get_trending_tags(std::string(), 50);
-                    for (const auto &t : trending_tags) {
-                        _state.tag_idx.trending.push_back(std::string(t.name));
+                    optional<std::vector<std::string>> trending_tags;
+                    if (my->_state_views) {
+                        trending_tags = my->_state_views->find_trending_tags();
                     }
+                    if (!trending_tags) {
+                        trending_tags = std::vector<std::string>();
+                        for (const auto &t : get_trending_tags(std::string(), 50)) {
+                            trending_tags->push_back(std::string(t.name));
+                        }
+                        if (my->_state_views) {
+                            my->_state_views->set_trending_tags(*trending_tags);
+                        }
+                    }
+                    _state.tag_idx.trending = std::move(*trending_tags);
+                    end_section("trending_tags");
                     /// END FETCH CATEGORY STATE
 
                     std::set<std::string> accounts;
@@ -2266,8 +2895,10 @@ namespace steemit {
                     part.resize(std::max(part.size(), size_t(4))); // at least 4
 
                     auto tag = fc::to_lower(part[1]);
+                    const char *route_section = "discussions";
 
                     if (part[0].size() && part[0][0] == '@') {
+                        route_section = "account";
                         auto acnt = part[0].substr(1);
                         _state.accounts[acnt] = extended_account(my->_db.get_account(acnt), my->_db);
                         _state.accounts[acnt].tags_usage = get_tags_used_by_author(acnt);
@@ -2345,7 +2976,7 @@ namespace steemit {
                                     const auto link = acnt + "/" +
                                                       to_string(itr->permlink);
                                     eacnt.comments->push_back(link);
-                                    _state.content[link] = *itr;
+                                    _state.content[link] = discussion(*itr, my->_db);
                                     set_pending_payout(_state.content[link]);
                                     ++count;
                                 }
@@ -2362,7 +2993,7 @@ namespace steemit {
                                     const auto link =
                                             b.author + "/" + b.permlink;
                                     eacnt.blog->push_back(link);
-                                    _state.content[link] = my->_db.get_comment(b.author, b.permlink);
+                                    _state.content[link] = discussion(my->_db.get_comment(b.author, b.permlink), my->_db);
                                     set_pending_payout(_state.content[link]);
 
                                     if (b.reblog_on > time_point_sec()) {
@@ -2379,7 +3010,7 @@ namespace steemit {
                                     const auto link =
                                             f.author + "/" + f.permlink;
                                     eacnt.feed->push_back(link);
-                                    _state.content[link] = my->_db.get_comment(f.author, f.permlink);
+                                    _state.content[link] = discussion(my->_db.get_comment(f.author, f.permlink), my->_db);
                                     set_pending_payout(_state.content[link]);
                                     if (f.reblog_by.size()) {
                                         if (f.reblog_by.size()) {
@@ -2394,6 +3025,7 @@ namespace steemit {
                     }
                         /// pull a complete discussion
                     else if (part[1].size() && part[1][0] == '@') {
+                        route_section = "discussion";
 
                         auto account = part[1].substr(1);
                         auto category = part[0];
@@ -2406,6 +3038,7 @@ namespace steemit {
                         _state.content[key] = std::move(dis);
                     } else if (part[0] == "witnesses" ||
                                part[0] == "~witnesses") {
+                        route_section = "witnesses";
                         auto wits = get_witnesses_by_vote("", 50);
                         for (const auto &w : wits) {
                             _state.witnesses[w.owner] = w;
@@ -2598,6 +3231,7 @@ namespace steemit {
                             _state.content[key] = std::move(d);
                         }
                     } else if (part[0] == "tags") {
+                        route_section = "tags";
                         _state.tag_idx.trending.clear();
                         auto trending_tags = get_trending_tags(std::string(), 250);
                         for (const auto &t : trending_tags) {
@@ -2606,25 +3240,43 @@ namespace steemit {
                             _state.tags[name] = t;
                         }
                     } else {
+                        route_section = "unknown";
                         elog("What... no matches");
                     }
+                    end_section(route_section);
 
                     for (const auto &a : accounts) {
                         _state.accounts.erase("");
+                        auto cached = my->_state_views ? my->_state_views->find_account(a) : optional<extended_account>();
+                        if (cached) {
+                            _state.accounts[a] = std::move(*cached);
+                            continue;
+                        }
+
                         _state.accounts[a] = extended_account(my->_db.get_account(a), my->_db);
                         if (my->_follow_api) {
                             _state.accounts[a].reputation = my->_follow_api->get_account_reputations(a, 1)[0].reputation;
                         }
+                        if (my->_state_views) {
+                            my->_state_views->insert_account(_state.accounts[a]);
+                        }
                     }
+                    end_section("accounts");
+
                     for (auto &d : _state.content) {
                         d.second.active_votes = get_active_votes(d.second.author, d.second.permlink);
                     }
+                    end_section("active_votes");
 
                     _state.witness_schedule = my->_db.get_witness_schedule_object();
 
                 } catch (const fc::exception &e) {
                     _state.error = e.to_detail_string();
                 }
+
+                if (my->_state_views) {
+                    my->_state_views->record("total", fc::time_point::now() - state_start);
+                }
                 return _state;
             });
         }
@@ -2642,6 +3294,17 @@ namespace steemit {
                     result.transaction_num = itr->trx_in_block;
                     return result;
                 }
+
+                auto location = my->_db.find_transaction_location(id);
+                if (location.valid()) {
+                    auto blk = my->_db.fetch_block_by_number(location->block_num);
+                    FC_ASSERT(blk.valid());
+                    FC_ASSERT(blk->transactions.size() > location->trx_in_block);
+                    annotated_signed_transaction result = blk->transactions[location->trx_in_block];
+                    result.block_num = location->block_num;
+                    result.transaction_num = location->trx_in_block;
+                    return result;
+                }
                 FC_ASSERT(false, "Unknown Transaction ${t}", ("t", id));
             });
         }
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <fc/variant.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace steemit {
+    namespace app {
+
+        namespace detail { class api_admission_impl; }
+
+        enum class api_priority {
+            high, ///< broadcasts and logins, never limited by other callers
+            normal, ///< calls estimated to be cheap
+            low ///< scans and other calls estimated to be expensive
+        };
+
+        struct api_admission_limits {
+            uint32_t max_queued_calls = 1000; ///< calls waiting for an API thread
+            uint32_t max_session_calls = 16; ///< calls in flight on one connection
+            uint32_t max_method_calls = 32; ///< calls in flight of one method, except high priority methods
+            uint64_t max_normal_cost = 100; ///< calls estimated to cost more run with low priority
+        };
+
+        /**
+         * Decides which API calls are executed and in which order, so a flood of expensive calls is rejected
+         * before it delays cheap calls, broadcasts and block application.
+         *
+         * A call is admitted while its connection and its method are below their limits of calls in flight,
+         * and rejected with an exception otherwise. Admitted read only calls then wait for one of the API
+         * threads; waiting calls are served high priority first, and are rejected right away when the queue
+         * is full rather than left to time out.
+         *
+         * The cost of a call is the weight of its method times the limit of the query it was given, if any.
+         */
+        class api_admission {
+        public:
+            /**
+             * Releases the call's place in the limits when destroyed.
+             */
+            class ticket {
+            public:
+                ~ticket();
+
+                api_priority priority() const {
+                    return _priority;
+                }
+
+            private:
+                friend class api_admission;
+
+                ticket(api_admission &owner, const void *session, std::string method, api_priority priority);
+
+                api_admission &_owner;
+                const void *_session;
+                std::string _method;
+                api_priority _priority;
+            };
+
+            /**
+             * Holds an API thread when running a call, hands it to the next waiting call when destroyed.
+             */
+            class thread_slot {
+            public:
+                ~thread_slot();
+
+                uint32_t thread() const {
+                    return _thread;
+                }
+
+            private:
+                friend class api_admission;
+
+                thread_slot(api_admission &owner, uint32_t thread);
+
+                api_admission &_owner;
+                uint32_t _thread;
+            };
+
+            /**
+             * @param thread_count number of API threads calls are waiting for
+             * @param weights cost of one result of a method by "<api>.<method>", methods not listed weigh 1
+             * @param high_priority_apis APIs whose methods always run with high priority
+             */
+            api_admission(const api_admission_limits &limits, uint32_t thread_count,
+                          std::map<std::string, uint32_t> weights, std::vector<std::string> high_priority_apis);
+
+            ~api_admission();
+
+            uint64_t estimate_cost(const std::string &method, const fc::variants &args) const;
+
+            /**
+             * Admit a call of the method named "<api>.<method>" made on the session, throws if the session or
+             * the method has too many calls in flight.
+             */
+            std::unique_ptr<ticket> admit(const void *session, const std::string &method, const fc::variants &args);
+
+            /**
+             * Wait until an API thread is free for the admitted call, throws if too many calls are waiting.
+             */
+            std::unique_ptr<thread_slot> acquire_thread(const ticket &t);
+
+        private:
+            void release(const ticket &t);
+
+            void release(const thread_slot &s);
+
+            std::unique_ptr<detail::api_admission_impl> my;
+        };
+
+    }
+}
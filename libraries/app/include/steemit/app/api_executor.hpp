@@ -0,0 +1,51 @@
+#pragma once
+
+#include <steemit/app/api_admission.hpp>
+#include <steemit/app/api_metrics.hpp>
+
+#include <fc/rpc/api_connection.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace steemit {
+    namespace app {
+
+        /**
+         * Executes the API calls received on all sessions. Every call is admitted by the api_admission and timed
+         * by the api_metrics. Calls of methods marked with FC_API_READ_ONLY run on a pool of API threads, where
+         * they take the read lock of the database themselves; all other calls run on the calling thread.
+         */
+        class api_executor {
+        public:
+            /**
+             * @param thread_count number of API threads, with none read only calls run on the calling thread too
+             */
+            api_executor(uint32_t thread_count, std::shared_ptr<api_admission> admission,
+                         std::shared_ptr<api_metrics> metrics);
+
+            ~api_executor();
+
+            /**
+             * Execute a call of the method named "<api>.<method>" received on the session and return its result.
+             *
+             * A read only call owns everything it uses, so it may safely run to its end on an API thread after
+             * the caller stopped waiting for it.
+             */
+            fc::variant execute(const void *session, const std::string &name,
+                                const fc::rpc::api_connection::call_info &info, const std::function<fc::variant()> &call);
+
+            uint32_t thread_count() const {
+                return _threads.size();
+            }
+
+        private:
+            std::vector<std::shared_ptr<fc::thread>> _threads;
+            std::shared_ptr<api_admission> _admission;
+            std::shared_ptr<api_metrics> _metrics;
+        };
+
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <steemit/chain/profiler.hpp>
+
+#include <fc/variant.hpp>
+
+#include <map>
+#include <mutex>
+
+namespace steemit {
+    namespace app {
+
+        struct api_method_stats {
+            std::string name; ///< api and method, e.g. database_api.get_block
+            uint64_t errors = 0;
+            uint64_t bytes_in = 0; ///< size of the requests, batches are counted separately
+            uint64_t bytes_out = 0; ///< size of the replies, batches are counted separately
+            chain::timing_stats total; ///< from receiving the call until its result is ready
+            chain::timing_stats queued; ///< waiting for an API thread
+            chain::timing_stats lock_wait; ///< waiting for the read lock of the database
+        };
+
+        /**
+         * Counts and times the calls of every API method across all sessions. Calls slower than the slow call
+         * threshold are logged with their arguments.
+         */
+        class api_metrics {
+        public:
+            struct call_timing {
+                fc::microseconds total;
+                fc::microseconds queued;
+                fc::microseconds lock_wait;
+            };
+
+            /**
+             * @param slow_call_threshold calls taking longer are logged, zero disables the log
+             */
+            explicit api_metrics(const fc::microseconds &slow_call_threshold);
+
+            void record_call(const std::string &name, const fc::variants &args, const call_timing &timing, bool failed);
+
+            /**
+             * Add the size of a request and its reply to a method called before, or to "batch" for batches.
+             */
+            void record_traffic(const std::string &name, size_t bytes_in, size_t bytes_out);
+
+            /**
+             * @return stats of every method called so far, most expensive first
+             */
+            std::vector<api_method_stats> get_stats() const;
+
+            /**
+             * Render the stats in the Prometheus text exposition format.
+             */
+            std::string to_prometheus() const;
+
+        private:
+            struct method_metrics {
+                uint64_t errors = 0;
+                uint64_t bytes_in = 0;
+                uint64_t bytes_out = 0;
+                chain::timing_histogram total;
+                chain::timing_histogram queued;
+                chain::timing_histogram lock_wait;
+            };
+
+            mutable std::mutex _mutex;
+            fc::microseconds _slow_call_threshold;
+            std::map<std::string, method_metrics> _methods; ///< only methods which exist, so the map is bounded
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::app::api_method_stats, (name)(errors)(bytes_in)(bytes_out)(total)(queued)(lock_wait))
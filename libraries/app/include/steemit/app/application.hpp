@@ -50,6 +50,14 @@ namespace steemit {
 
         class login_api;
 
+        class plugin_pipeline;
+
+        class response_cache;
+
+        class state_views;
+
+        class api_metrics;
+
         class application {
         public:
             application();
@@ -92,6 +100,29 @@ namespace steemit {
                 return result;
             }
 
+            /**
+             * Return true if the plugin was configured with async-plugins to consume blocks through
+             * the plugin pipeline.
+             */
+            bool is_plugin_async(const std::string &name) const;
+
+            std::shared_ptr<plugin_pipeline> get_plugin_pipeline() const;
+
+            /**
+             * Return the cache of API results shared by all sessions, or nullptr if it is disabled.
+             */
+            std::shared_ptr<response_cache> get_response_cache() const;
+
+            /**
+             * Return the parts of get_state maintained across calls, or nullptr if they are disabled.
+             */
+            std::shared_ptr<state_views> get_state_views() const;
+
+            /**
+             * Return the latency and traffic metrics of API methods across all sessions.
+             */
+            std::shared_ptr<api_metrics> get_api_metrics() const;
+
             graphene::net::node_ptr p2p_node();
 
             std::shared_ptr<chain::database> chain_database() const;
@@ -99,6 +130,12 @@ namespace steemit {
 
             void set_block_production(bool producing_blocks);
 
+            /**
+             * Push a transaction received from the network or the API. Stateless checks run on the
+             * precheck thread pool, so the write lock is only taken for transactions which pass them.
+             */
+            void push_transaction(const protocol::signed_transaction &trx);
+
             fc::optional<api_access_info> get_api_access_info(const string &username) const;
 
             void set_api_access_info(const string &username, api_access_info &&permissions);
@@ -125,6 +162,38 @@ namespace steemit {
                 });
             }
 
+            /**
+             * Register an API which keeps no state of its own for a session, so one instance created on first use
+             * is shared by every session instead of being built for each connection. APIs which hold per-session
+             * state, like callbacks or the dev key prefix of debug_node_api, must use register_api_factory.
+             *
+             * @param create builds the instance, it is called once and the result is kept by the application
+             * @param wrap builds the fc::api of the instance, the same one is handed to every session
+             */
+            void register_shared_api_factory(const string &name,
+                                             std::function<std::shared_ptr<void>(const api_context &)> create,
+                                             std::function<fc::api_ptr(const std::shared_ptr<void> &)> wrap);
+
+            template<typename Api>
+            void register_shared_api_factory(const string &name) {
+#ifndef STEEMIT_BUILD_TESTNET
+                idump((name));
+#endif
+                register_shared_api_factory(name, &create_shared_api<Api>, [](const std::shared_ptr<void> &instance) -> fc::api_ptr {
+                    return std::make_shared<fc::api<Api>>(std::static_pointer_cast<Api>(instance));
+                });
+            }
+
+            /**
+             * Return the instance of the named shared API used by all sessions, creating it on first use.
+             */
+            template<typename Api>
+            std::shared_ptr<Api> get_shared_api(const string &name) {
+                return std::static_pointer_cast<Api>(get_shared_api_instance(name, &create_shared_api<Api>));
+            }
+
+            std::shared_ptr<void> get_shared_api_instance(const string &name, const std::function<std::shared_ptr<void>(const api_context &)> &create);
+
             /**
              * Instantiate the named API.  Currently this simply calls the previously registered factory method.
              */
@@ -140,6 +209,13 @@ namespace steemit {
             fc::http::websocket_client _client;
 
         private:
+            template<typename Api>
+            static std::shared_ptr<void> create_shared_api(const api_context &ctx) {
+                std::shared_ptr<Api> api = std::make_shared<Api>(ctx);
+                api->on_api_startup();
+                return api;
+            }
+
             std::shared_ptr<detail::application_impl> my;
 
             boost::program_options::options_description _cli_options;
@@ -2,6 +2,7 @@
 
 #include <steemit/protocol/operations.hpp>
 #include <steemit/chain/steem_object_types.hpp>
+#include <steemit/chain/history_log.hpp>
 
 namespace steemit {
     namespace app {
@@ -11,6 +12,8 @@ namespace steemit {
 
             applied_operation(const steemit::chain::operation_object &op_obj);
 
+            applied_operation(const steemit::chain::history_operation &op);
+
             steemit::protocol::transaction_id_type trx_id;
             uint32_t block = 0;
             uint32_t trx_in_block = 0;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <steemit/app/api_metrics.hpp>
 #include <steemit/app/applied_operation.hpp>
+#include <steemit/app/plugin_pipeline.hpp>
 #include <steemit/app/state.hpp>
 
 #include <steemit/chain/database.hpp>
@@ -68,6 +70,16 @@ namespace steemit {
             all
         };
 
+        enum block_format {
+            json, ///< blocks as objects
+            raw ///< base64 of the fc::raw encoding of blocks, as accepted by push_raw_block
+        };
+
+        struct block_range {
+            std::vector<signed_block> blocks; ///< blocks of a json range
+            std::vector<std::string> raw_blocks; ///< blocks of a raw range
+        };
+
         class database_api_impl;
 
 /**
@@ -85,6 +97,21 @@ namespace steemit {
                     FC_ASSERT(select_tags.find(iterator) ==
                               select_tags.end());
                 }
+
+                if (fields) {
+                    for (const auto &field : *fields) {
+                        FC_ASSERT(field == "body" || field == "json_metadata" || field == "active_votes" ||
+                                  field == "url" || field == "author_reputation",
+                                "Unknown discussion field ${f}", ("f", field));
+                    }
+                }
+            }
+
+            /**
+             * @return true if the optional field of the discussion has to be filled in
+             */
+            bool has_field(const std::string &field) const {
+                return !fields || fields->find(field) != fields->end();
             }
 
             uint32_t limit = 0; ///< the discussions return amount top limit
@@ -96,6 +123,18 @@ namespace steemit {
             optional<std::string> start_permlink; ///< the permlink of discussion to start searching from
             optional<std::string> parent_author; ///< the author of parent discussion
             optional<std::string> parent_permlink; ///< the permlink of parent discussion
+            optional<std::set<std::string>> fields; ///< optional fields to fill in out of body, json_metadata, active_votes, url (with root_title) and author_reputation, all if not set
+        };
+
+/**
+ * @brief Operations sent by set_block_operations_callback
+ */
+        struct block_operations_filter {
+            std::set<std::string> operations; ///< names of the operation types to send, e.g. "vote" or "author_reward", all if empty
+            std::set<std::string> accounts; ///< send only operations impacting one of these accounts, all if empty
+            bool virtual_ops = true; ///< send virtual operations
+            bool irreversible = false; ///< send blocks once they become irreversible instead of when they are applied
+            bool binary = false; ///< send operations as the hex of their fc::raw encoding instead of JSON
         };
 
 /**
@@ -115,12 +154,27 @@ namespace steemit {
             // Subscriptions //
             ///////////////////
 
+            /**
+             * @brief Receive changes of the accounts and comments looked up with get_accounts, lookup_account_names
+             * and get_content, once per block, instead of polling them
+             * @param cb Called with {block_num, accounts, comments, removed} for every block changing any of them
+             * @param clear_filter Forget the objects looked up so far
+             */
             void set_subscribe_callback(std::function<void(const variant &)> cb, bool clear_filter);
 
             void set_pending_transaction_callback(std::function<void(const variant &)> cb);
 
             void set_block_applied_callback(std::function<void(const variant &block_header)> cb);
 
+            /**
+             * @brief Receive the operations of every block, including virtual operations, in one notification per
+             * block instead of polling get_block and get_ops_in_block
+             * @param cb Called with {block_num, block_id, timestamp, operations} for every block, also when no
+             * operation passes the filter; operations are block_operation objects in the order they were applied
+             * @param filter Operations to send and when to send them
+             */
+            void set_block_operations_callback(std::function<void(const variant &)> cb, const block_operations_filter &filter);
+
             /**
              * @brief Stop receiving any notifications
              *
@@ -166,6 +220,16 @@ namespace steemit {
              */
             optional<signed_block> get_block(uint32_t block_num) const;
 
+            /**
+             * @brief Retrieve a contiguous range of blocks. Irreversible blocks are read from the block log without
+             * locking the database, raw blocks are sent as they are stored.
+             * @param start Height of the first block to return
+             * @param count Number of blocks to return, at most 1000
+             * @param format Whether to return blocks as objects or as their binary encoding
+             * @return the blocks from start on, fewer than count if the head block is reached
+             */
+            block_range get_blocks(uint32_t start, uint32_t count, block_format format = json) const;
+
             /**
              *  @brief Get sequence of operations included/generated within a particular block
              *  @param block_num Height of the block whose generated virtual operations should be returned
@@ -211,6 +275,36 @@ namespace steemit {
 
             scheduled_hardfork get_next_scheduled_hardfork() const;
 
+            /**
+             * @brief Retrieve timing of block application phases
+             * @return stats for whole blocks, single transactions and every phase, most expensive phases first
+             */
+            vector<timing_stats> get_block_profile_stats() const;
+
+            /**
+             * @brief Retrieve timing of evaluators and plugin handlers per operation type
+             * @return stats of every operation type applied so far, most expensive first
+             */
+            vector<operation_profile_stats> get_operation_profile_stats() const;
+
+            /**
+             * @brief Retrieve timing of the sections of get_state computed on this node
+             * @return stats of every section, most expensive first, empty if state views are disabled
+             */
+            vector<timing_stats> get_state_profile_stats() const;
+
+            /**
+             * @brief Retrieve latency, errors and traffic of every API method called on this node
+             * @return stats of every method called so far, most expensive first
+             */
+            vector<api_method_stats> get_api_call_stats() const;
+
+            /**
+             * @brief Retrieve progress of the plugins consuming blocks asynchronously
+             * @return head and processed block, lag and queue size of every consumer
+             */
+            vector<pipeline_consumer_status> get_plugin_pipeline_status() const;
+
             //////////
             // Keys //
             //////////
@@ -489,6 +583,16 @@ namespace steemit {
              */
             std::map<uint32_t, applied_operation> get_account_history(std::string account, uint64_t from, uint32_t limit) const;
 
+            /**
+             *  Same as get_account_history, but only returns operations of the given types and skips the others
+             *  without reading them.
+             *
+             *  @param op_types - names of the operation types, e.g. "transfer" or "transfer_operation"
+             *  @param from - the absolute sequence number, -1 means most recent
+             *  @param limit - the maximum number of operations returned (0 to 2000]
+             */
+            std::map<uint32_t, applied_operation> get_account_history_by_type(std::string account, std::vector<std::string> op_types, uint64_t from, uint32_t limit) const;
+
             ////////////////////////////
             // Handlers - not exposed //
             ////////////////////////////
@@ -499,8 +603,25 @@ namespace steemit {
 
             void set_url(discussion &d) const;
 
+            /**
+             * Read title, body and json_metadata of the discussion from the content store
+             */
+            void set_content(discussion &d) const;
+
             discussion get_discussion(comment_id_type, uint32_t truncate_body = 0) const;
 
+            /**
+             * Get the discussion with only the optional fields selected by the query
+             */
+            discussion get_discussion(comment_id_type, const discussion_query &query) const;
+
+            /**
+             * Fill in payout, reputation and url of a discussion which already has its content
+             */
+            void set_discussion_fields(discussion &d, const discussion_query &query) const;
+
+            void truncate_discussion(discussion &d, const discussion_query &query) const;
+
             static bool filter_default(const comment_api_obj &c) {
                 return false;
             }
@@ -537,15 +658,19 @@ FC_REFLECT(steemit::app::scheduled_hardfork, (hf_version)(live_time));
 FC_REFLECT(steemit::app::liquidity_balance, (account)(weight));
 FC_REFLECT(steemit::app::withdraw_route, (from_account)(to_account)(percent)(auto_vest));
 
-FC_REFLECT(steemit::app::discussion_query, (select_tags)(filter_tags)(select_authors)(truncate_body)(start_author)(start_permlink)(parent_author)(parent_permlink)(limit));
+FC_REFLECT(steemit::app::block_operations_filter, (operations)(accounts)(virtual_ops)(irreversible)(binary));
+FC_REFLECT(steemit::app::discussion_query, (select_tags)(filter_tags)(select_authors)(truncate_body)(start_author)(start_permlink)(parent_author)(parent_permlink)(limit)(fields));
 
 FC_REFLECT_ENUM(steemit::app::withdraw_route_type, (incoming)(outgoing)(all));
+FC_REFLECT_ENUM(steemit::app::block_format, (json)(raw));
+FC_REFLECT(steemit::app::block_range, (blocks)(raw_blocks));
 
 FC_API(steemit::app::database_api,
 // Subscriptions
         (set_subscribe_callback)
                 (set_pending_transaction_callback)
                 (set_block_applied_callback)
+                (set_block_operations_callback)
                 (cancel_all_subscriptions)
 
                 // tags
@@ -568,6 +693,7 @@ FC_API(steemit::app::database_api,
                 // Blocks and transactions
                 (get_block_header)
                 (get_block)
+                (get_blocks)
                 (get_ops_in_block)
                 (get_state)
                 (get_trending_categories)
@@ -585,6 +711,11 @@ FC_API(steemit::app::database_api,
                 (get_witness_schedule)
                 (get_hardfork_version)
                 (get_next_scheduled_hardfork)
+                (get_block_profile_stats)
+                (get_operation_profile_stats)
+                (get_state_profile_stats)
+                (get_api_call_stats)
+                (get_plugin_pipeline_status)
 
                 // Keys
                 (get_key_references)
@@ -597,6 +728,7 @@ FC_API(steemit::app::database_api,
                 (get_account_count)
                 (get_conversion_requests)
                 (get_account_history)
+                (get_account_history_by_type)
                 (get_owner_history)
                 (get_recovery_request)
                 (get_escrow)
@@ -637,4 +769,77 @@ FC_API(steemit::app::database_api,
                 (get_witness_count)
                 (get_active_witnesses)
                 (get_miner_queue)
+)
+
+FC_API_READ_ONLY(steemit::app::database_api,
+        (get_trending_tags)
+                (get_tags_used_by_author)
+                (get_discussions_by_trending)
+                (get_discussions_by_trending30)
+                (get_discussions_by_created)
+                (get_discussions_by_active)
+                (get_discussions_by_cashout)
+                (get_discussions_by_payout)
+                (get_discussions_by_votes)
+                (get_discussions_by_children)
+                (get_discussions_by_hot)
+                (get_discussions_by_feed)
+                (get_discussions_by_blog)
+                (get_discussions_by_comments)
+                (get_discussions_by_promoted)
+                (get_block_header)
+                (get_block)
+                (get_blocks)
+                (get_ops_in_block)
+                (get_state)
+                (get_trending_categories)
+                (get_best_categories)
+                (get_active_categories)
+                (get_recent_categories)
+                (get_config)
+                (get_dynamic_global_properties)
+                (get_chain_properties)
+                (get_feed_history)
+                (get_current_median_history_price)
+                (get_witness_schedule)
+                (get_hardfork_version)
+                (get_next_scheduled_hardfork)
+                (get_key_references)
+                (get_accounts)
+                (get_account_references)
+                (lookup_account_names)
+                (lookup_accounts)
+                (get_account_count)
+                (get_conversion_requests)
+                (get_account_history)
+                (get_account_history_by_type)
+                (get_owner_history)
+                (get_recovery_request)
+                (get_escrow)
+                (get_withdraw_routes)
+                (get_account_bandwidth)
+                (get_savings_withdraw_from)
+                (get_savings_withdraw_to)
+                (get_order_book)
+                (get_open_orders)
+                (get_liquidity_queue)
+                (get_transaction_hex)
+                (get_transaction)
+                (get_required_signatures)
+                (get_potential_signatures)
+                (verify_authority)
+                (verify_account_authority)
+                (get_active_votes)
+                (get_account_votes)
+                (get_content)
+                (get_content_replies)
+                (get_discussions_by_author_before_date)
+                (get_replies_by_last_update)
+                (get_witnesses)
+                (get_witness_by_account)
+                (get_witnesses_by_vote)
+                (lookup_witness_accounts)
+                (get_witness_count)
+                (get_active_witnesses)
+                (get_miner_queue)
 )
\ No newline at end of file
@@ -23,26 +23,14 @@
  */
 #pragma once
 
-#include <fc/container/flat.hpp>
-#include <steemit/protocol/operations.hpp>
-#include <steemit/protocol/transaction.hpp>
-#include <steemit/chain/steem_object_types.hpp>
-
-#include <fc/string.hpp>
+#include <steemit/protocol/impacted.hpp>
 
 namespace steemit {
     namespace app {
 
-        using namespace fc;
-
-        void operation_get_impacted_accounts(
-                const steemit::protocol::operation &op,
-                fc::flat_set<protocol::account_name_type> &result);
-
-        void transaction_get_impacted_accounts(
-                const steemit::protocol::transaction &tx,
-                fc::flat_set<protocol::account_name_type> &result
-        );
+        /// Moved to the protocol library so chain::operation_notification can cache the result
+        using protocol::operation_get_impacted_accounts;
+        using protocol::transaction_get_impacted_accounts;
 
     }
 } // steemit::app
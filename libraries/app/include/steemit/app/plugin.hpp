@@ -78,6 +78,17 @@ namespace steemit {
              */
             virtual void plugin_shutdown() = 0;
 
+            /**
+             * @brief Rebuild the plugin indexes without replaying the blockchain.
+             *
+             * Called for plugins listed with --reindex-plugin, after the database is open and before startup(), with
+             * the write lock held. Plugins which support it wipe their indexes and rebuild them from the chain state
+             * and the stored operation history, see database::replay_operation_history().
+             *
+             * @return false if the plugin cannot be rebuilt this way
+             */
+            virtual bool plugin_reindex() = 0;
+
             /**
              * @brief Fill in command line parameters used by the plugin.
              *
@@ -113,6 +124,8 @@ namespace steemit {
 
             virtual void plugin_shutdown() override;
 
+            virtual bool plugin_reindex() override;
+
             virtual void plugin_set_program_options(
                     boost::program_options::options_description &command_line_options,
                     boost::program_options::options_description &config_file_options
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <steemit/chain/database.hpp>
+
+#include <memory>
+
+namespace steemit {
+    namespace app {
+
+        namespace detail { class plugin_pipeline_impl; }
+
+        /**
+         * A plugin which consumes the chain through the plugin pipeline instead of the database signals.
+         *
+         * Callbacks run on a thread owned by the pipeline, without any lock held, and may lag behind
+         * the chain. They are invoked in the order blocks were applied and popped, so a block is only
+         * ever popped after it has been applied, and the consumer must undo whatever it did for it.
+         * Consumers must keep their state outside of the chain database.
+         *
+         * Plugins whose objects live in the chain database, like tags, follow, market_history,
+         * blockchain_statistics and account_history, cannot be consumers. Their objects are part of the
+         * undo state of each block, so they must be written in line, under the write lock, and stay
+         * synchronous. Only plugins with their own storage, like block_info, run on the pipeline.
+         */
+        class pipeline_consumer {
+        public:
+            virtual ~pipeline_consumer() {
+            }
+
+            virtual void on_apply_block(const chain::block_notification &note) = 0;
+
+            virtual void on_pop_block(const chain::signed_block &block) = 0;
+        };
+
+        struct pipeline_consumer_status {
+            std::string name;
+            uint32_t head_block_num = 0; ///< last block pushed to the consumer
+            uint32_t processed_block_num = 0; ///< last block the consumer has processed
+            uint32_t lag = 0; ///< number of blocks the consumer is behind
+            uint32_t queue_size = 0; ///< number of notifications waiting to be processed
+        };
+
+        /**
+         * Decouples plugins from block application. The database collects the operations of every
+         * applied block, which the pipeline queues to each consumer's thread, so the time a consumer
+         * takes does not add to block latency or to the time the write lock is held.
+         */
+        class plugin_pipeline {
+        public:
+            plugin_pipeline(std::shared_ptr<chain::database> db);
+
+            ~plugin_pipeline();
+
+            void add_consumer(const std::string &name, std::shared_ptr<pipeline_consumer> consumer);
+
+            bool has_consumer(const std::string &name) const;
+
+            std::vector<pipeline_consumer_status> get_status() const;
+
+            /**
+             * Stop feeding consumers and wait until they have processed everything queued.
+             */
+            void shutdown();
+
+        private:
+            std::unique_ptr<detail::plugin_pipeline_impl> my;
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::app::pipeline_consumer_status, (name)(head_block_num)(processed_block_num)(lag)(queue_size))
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace steemit {
+    namespace app {
+
+        /**
+         * Results of API calls shared by all sessions and kept until the next block is applied, so identical
+         * queries within a block are answered with a hash lookup. Results are keyed by method and arguments
+         * and stored type erased, a key must always map to results of the same type.
+         *
+         * Results are computed from the state of the last applied block and pending transactions are not
+         * reflected until the next block clears the cache.
+         *
+         * The cache is bounded by the estimated size of its keys and results, as a single get_state result may
+         * weigh as much as thousands of small queries.
+         */
+        class response_cache {
+        public:
+            explicit response_cache(uint64_t max_bytes);
+
+            /**
+             * Return the cached result for the key or nullptr if there is none.
+             */
+            std::shared_ptr<const void> find(const std::string &key) const;
+
+            /**
+             * Value to pass to insert() for a result computed from now on.
+             */
+            uint64_t generation() const;
+
+            /**
+             * Cache the result of estimated size in bytes, unless the cache was cleared since the generation the
+             * result was computed at or the result alone exceeds the size of the cache.
+             */
+            void insert(const std::string &key, std::shared_ptr<const void> result, uint64_t size, uint64_t generation);
+
+            /**
+             * Estimated size of the cached keys and results in bytes.
+             */
+            uint64_t size() const;
+
+            void clear();
+
+        private:
+            struct entry {
+                std::shared_ptr<const void> result;
+                uint64_t size;
+            };
+
+            mutable std::mutex _mutex;
+            std::unordered_map<std::string, entry> _results;
+            uint64_t _size = 0;
+            uint64_t _generation = 0;
+            uint64_t _max_bytes;
+        };
+
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <steemit/app/state.hpp>
+#include <steemit/chain/block_notification.hpp>
+#include <steemit/chain/profiler.hpp>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace steemit {
+    namespace app {
+
+        /**
+         * Parts of get_state which are the same for every caller, shared by all sessions and maintained from the
+         * chain signals instead of being rebuilt on every call:
+         *
+         * - the names of the trending tags, built by the first caller after a block and kept until the next block
+         * - the accounts referenced by discussions, kept until a block changes one of the objects they are
+         *   built from: the account, its metadata, authority and forum bandwidth, and its reputation
+         *
+         * Views are filled by callers holding the read lock of the database and invalidated by the signal
+         * handlers holding the write lock, so a view never outlives the state it was built from by more than
+         * the pending transactions of the current block. After a fork every view is dropped.
+         *
+         * Also collects the time spent in each section of get_state.
+         */
+        class state_views {
+        public:
+            explicit state_views(uint32_t max_accounts);
+
+            /**
+             * Return the trending tag names built for the current block, or an invalid optional if they have
+             * to be built by the caller.
+             */
+            optional<std::vector<std::string>> find_trending_tags() const;
+
+            void set_trending_tags(std::vector<std::string> tags);
+
+            /**
+             * Return the account with its reputation, or an invalid optional if it is not in the view.
+             */
+            optional<extended_account> find_account(const std::string &name) const;
+
+            void insert_account(const extended_account &account);
+
+            /**
+             * Called by the changed_objects handler holding the write lock, drops the accounts whose objects
+             * the block changed.
+             */
+            void on_changed_objects(const chain::database &db, const chain::changed_objects_notification &note);
+
+            /**
+             * Called by the applied_block handler.
+             */
+            void on_block(uint32_t block_num);
+
+            void record(const std::string &section, const fc::microseconds &duration);
+
+            /**
+             * @return stats of every section of get_state, most expensive first
+             */
+            std::vector<chain::timing_stats> get_stats() const;
+
+        private:
+            template<typename Object>
+            void erase_accounts(const chain::database &db, const chain::changed_object_ids &ids,
+                                account_name_type Object::*account);
+
+            mutable std::mutex _mutex;
+            uint32_t _max_accounts;
+            uint32_t _block_num = 0;
+            optional<std::vector<std::string>> _trending_tags;
+            std::unordered_map<std::string, extended_account> _accounts;
+            std::map<std::string, chain::timing_histogram> _sections;
+        };
+
+    }
+}
@@ -3,6 +3,7 @@
 #include <steemit/chain/account_object.hpp>
 #include <steemit/chain/block_summary_object.hpp>
 #include <steemit/chain/comment_object.hpp>
+#include <steemit/chain/content_store.hpp>
 #include <steemit/chain/global_property_object.hpp>
 #include <steemit/chain/history_object.hpp>
 #include <steemit/chain/steem_objects.hpp>
@@ -54,16 +55,13 @@ namespace steemit {
         typedef chain::account_bandwidth_object account_bandwidth_api_obj;
 
         struct comment_api_obj {
-            comment_api_obj(const chain::comment_object &o) :
+            comment_api_obj(const chain::comment_object &o, const chain::database &db) :
                     id(o.id),
-                    category(to_string(o.category)),
+                    category(to_string(db.get_interned_string(o.category))),
                     parent_author(o.parent_author),
-                    parent_permlink(to_string(o.parent_permlink)),
+                    parent_permlink(to_string(db.get_interned_string(o.parent_permlink))),
                     author(o.author),
                     permlink(to_string(o.permlink)),
-                    title(to_string(o.title)),
-                    body(to_string(o.body)),
-                    json_metadata(to_string(o.json_metadata)),
                     last_update(o.last_update),
                     created(o.created),
                     active(o.active),
@@ -95,6 +93,17 @@ namespace steemit {
             comment_api_obj() {
             }
 
+            /**
+             * Title, body and json_metadata are kept in the content store rather than in the comment_object,
+             * so the constructor leaves them empty and callers returning them set them from
+             * database::get_comment_content().
+             */
+            void set_content(chain::comment_content content) {
+                title = std::move(content.title);
+                body = std::move(content.body);
+                json_metadata = std::move(content.json_metadata);
+            }
+
             comment_id_type id;
             string category;
             account_name_type parent_author;
@@ -145,9 +154,9 @@ namespace steemit {
         };
 
         struct category_api_obj {
-            category_api_obj(const chain::category_object &c) :
+            category_api_obj(const chain::category_object &c, const chain::database &db) :
                     id(c.id),
-                    name(to_string(c.name)),
+                    name(to_string(db.get_interned_string(c.name))),
                     abs_rshares(c.abs_rshares),
                     total_payouts(c.total_payouts),
                     discussions(c.discussions),
@@ -192,18 +201,11 @@ namespace steemit {
                     id(a.id),
                     name(a.name),
                     memo_key(a.memo_key),
-                    json_metadata(to_string(a.json_metadata)),
                     proxy(a.proxy),
                     last_account_update(a.last_account_update),
                     created(a.created),
-                    mined(a.mined),
                     owner_challenged(a.owner_challenged),
                     active_challenged(a.active_challenged),
-                    last_owner_proved(a.last_owner_proved),
-                    last_active_proved(a.last_active_proved),
-                    recovery_account(a.recovery_account),
-                    reset_account(a.reset_account),
-                    last_account_recovery(a.last_account_recovery),
                     comment_count(a.comment_count),
                     lifetime_vote_count(a.lifetime_vote_count),
                     post_count(a.post_count),
@@ -237,6 +239,15 @@ namespace steemit {
                     proxied_vsf_votes.push_back(a.proxied_vsf_votes[i]);
                 }
 
+                const auto &meta = db.get<account_metadata_object, by_account>(name);
+                json_metadata = to_string(meta.json_metadata);
+                mined = meta.mined;
+                last_owner_proved = meta.last_owner_proved;
+                last_active_proved = meta.last_active_proved;
+                recovery_account = meta.recovery_account;
+                reset_account = meta.reset_account;
+                last_account_recovery = meta.last_account_recovery;
+
                 const auto &auth = db.get<account_authority_object, by_account>(name);
                 owner = authority(auth.owner);
                 active = authority(auth.active);
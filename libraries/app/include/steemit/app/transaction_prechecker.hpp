@@ -0,0 +1,41 @@
+#pragma once
+
+#include <steemit/chain/database.hpp>
+
+#include <memory>
+
+namespace steemit {
+    namespace app {
+
+        namespace detail { class transaction_prechecker_impl; }
+
+        /**
+         * Runs database::precheck_transaction() for incoming transactions on a pool of worker threads, so
+         * malformed, expired or badly signed transactions are rejected without touching the write lock.
+         * Transactions which pass are queued on the thread which created the prechecker and pushed to the
+         * database in batches, one write lock acquisition per batch.
+         */
+        class transaction_prechecker {
+        public:
+            /**
+             * @param skip validation steps skipped both by the precheck and by the push
+             */
+            transaction_prechecker(std::shared_ptr<chain::database> db, uint32_t thread_count,
+                                   uint32_t skip = chain::database::skip_nothing);
+
+            ~transaction_prechecker();
+
+            /**
+             * Precheck the transaction and push it to the pending state. Returns once the transaction
+             * has been pushed, throws the exception it was rejected with otherwise.
+             *
+             * With no worker threads configured this is the same as database::push_transaction().
+             */
+            void push_transaction(const chain::signed_transaction &trx);
+
+        private:
+            std::unique_ptr<detail::transaction_prechecker_impl> my;
+        };
+
+    }
+}
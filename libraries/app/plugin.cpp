@@ -51,6 +51,10 @@ namespace steemit {
             return;
         }
 
+        bool plugin::plugin_reindex() {
+            return false;
+        }
+
         void plugin::plugin_set_program_options(
                 boost::program_options::options_description &command_line_options,
                 boost::program_options::options_description &config_file_options
@@ -0,0 +1,161 @@
+#include <steemit/app/plugin_pipeline.hpp>
+
+#include <fc/thread/thread.hpp>
+#include <fc/thread/future.hpp>
+
+#include <atomic>
+
+namespace steemit {
+    namespace app {
+
+        namespace detail {
+            struct pipeline_stage {
+                std::string name;
+                std::shared_ptr<pipeline_consumer> consumer;
+                std::shared_ptr<fc::thread> thread;
+
+                std::atomic<uint32_t> head_block_num{0};
+                std::atomic<uint32_t> processed_block_num{0};
+                std::atomic<uint32_t> queue_size{0};
+
+                fc::future<void> last_task;
+            };
+
+            class plugin_pipeline_impl {
+            public:
+                plugin_pipeline_impl(std::shared_ptr<chain::database> db)
+                        : _db(db) {
+                }
+
+                void on_applied_block(const chain::block_notification &note) {
+                    auto shared_note = std::make_shared<const chain::block_notification>(note);
+                    uint32_t block_num = shared_note->block.block_num();
+
+                    for (auto &stage : _stages) {
+                        stage->head_block_num = block_num;
+                        post(*stage, [stage, shared_note, block_num]() {
+                            stage->consumer->on_apply_block(*shared_note);
+                            stage->processed_block_num = block_num;
+                        }, "pipeline apply block");
+                    }
+                }
+
+                void on_popped_block(const chain::signed_block &block) {
+                    auto shared_block = std::make_shared<const chain::signed_block>(block);
+                    uint32_t block_num = shared_block->block_num();
+
+                    for (auto &stage : _stages) {
+                        stage->head_block_num = block_num - 1;
+                        post(*stage, [stage, shared_block, block_num]() {
+                            stage->consumer->on_pop_block(*shared_block);
+                            stage->processed_block_num = block_num - 1;
+                        }, "pipeline pop block");
+                    }
+                }
+
+                /// Tasks posted to an fc::thread run in the order they were posted
+                void post(pipeline_stage &stage, std::function<void()> task, const char *desc) {
+                    ++stage.queue_size;
+                    pipeline_stage *s = &stage;
+                    stage.last_task = stage.thread->async([s, task]() {
+                        try {
+                            task();
+                        } catch (const fc::exception &e) {
+                            elog("Pipeline consumer ${name} failed: ${e}", ("name", s->name)("e", e.to_detail_string()));
+                        } catch (const std::exception &e) {
+                            elog("Pipeline consumer ${name} failed: ${e}", ("name", s->name)("e", e.what()));
+                        }
+                        --s->queue_size;
+                    }, desc);
+                }
+
+                std::shared_ptr<chain::database> _db;
+                std::vector<std::shared_ptr<pipeline_stage>> _stages;
+
+                boost::signals2::scoped_connection _applied_block_connection;
+                boost::signals2::scoped_connection _popped_block_connection;
+            };
+        }
+
+        plugin_pipeline::plugin_pipeline(std::shared_ptr<chain::database> db)
+                : my(new detail::plugin_pipeline_impl(db)) {
+        }
+
+        plugin_pipeline::~plugin_pipeline() {
+            shutdown();
+        }
+
+        void plugin_pipeline::add_consumer(const std::string &name, std::shared_ptr<pipeline_consumer> consumer) {
+            FC_ASSERT(consumer, "Pipeline consumer ${name} is null", ("name", name));
+            FC_ASSERT(!has_consumer(name), "Pipeline consumer ${name} is already registered", ("name", name));
+
+            if (my->_stages.empty()) {
+                my->_applied_block_connection = my->_db->applied_block_operations.connect([this](const chain::block_notification &note) {
+                    my->on_applied_block(note);
+                });
+                my->_popped_block_connection = my->_db->popped_block.connect([this](const chain::signed_block &block) {
+                    my->on_popped_block(block);
+                });
+                my->_db->set_collect_block_operations(true);
+            }
+
+            auto stage = std::make_shared<detail::pipeline_stage>();
+            stage->name = name;
+            stage->consumer = consumer;
+            stage->thread = std::make_shared<fc::thread>("pipeline " + name);
+            my->_stages.push_back(stage);
+
+            ilog("Plugin ${name} processes blocks asynchronously", ("name", name));
+        }
+
+        bool plugin_pipeline::has_consumer(const std::string &name) const {
+            for (const auto &stage : my->_stages) {
+                if (stage->name == name) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<pipeline_consumer_status> plugin_pipeline::get_status() const {
+            std::vector<pipeline_consumer_status> result;
+            result.reserve(my->_stages.size());
+
+            for (const auto &stage : my->_stages) {
+                pipeline_consumer_status status;
+                status.name = stage->name;
+                status.head_block_num = stage->head_block_num;
+                status.processed_block_num = stage->processed_block_num;
+                status.lag = status.head_block_num > status.processed_block_num
+                             ? status.head_block_num - status.processed_block_num : 0;
+                status.queue_size = stage->queue_size;
+                result.push_back(status);
+            }
+
+            return result;
+        }
+
+        void plugin_pipeline::shutdown() {
+            if (my->_stages.empty()) {
+                return;
+            }
+
+            my->_applied_block_connection.disconnect();
+            my->_popped_block_connection.disconnect();
+            my->_db->set_collect_block_operations(false);
+
+            for (auto &stage : my->_stages) {
+                try {
+                    if (stage->last_task.valid()) {
+                        stage->last_task.wait();
+                    }
+                    stage->thread->quit();
+                } catch (const fc::exception &e) {
+                    elog("Error stopping pipeline consumer ${name}: ${e}", ("name", stage->name)("e", e.to_detail_string()));
+                }
+            }
+            my->_stages.clear();
+        }
+
+    }
+}
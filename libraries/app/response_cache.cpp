@@ -0,0 +1,60 @@
+#include <steemit/app/response_cache.hpp>
+
+namespace steemit {
+    namespace app {
+
+        response_cache::response_cache(uint64_t max_bytes)
+                : _max_bytes(max_bytes) {
+        }
+
+        std::shared_ptr<const void> response_cache::find(const std::string &key) const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto itr = _results.find(key);
+            if (itr == _results.end()) {
+                return std::shared_ptr<const void>();
+            }
+            return itr->second.result;
+        }
+
+        uint64_t response_cache::generation() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _generation;
+        }
+
+        void response_cache::insert(const std::string &key, std::shared_ptr<const void> result, uint64_t size,
+                                    uint64_t generation) {
+            size += key.size();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (generation != _generation || size > _max_bytes) {
+                return;
+            }
+
+            auto itr = _results.find(key);
+            if (itr != _results.end()) {
+                _size -= itr->second.size;
+                _results.erase(itr);
+            }
+            if (_size + size > _max_bytes) {
+                // Queries with many distinct arguments, start over rather than tracking use of entries
+                _results.clear();
+                _size = 0;
+            }
+            _results[key] = entry{std::move(result), size};
+            _size += size;
+        }
+
+        uint64_t response_cache::size() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _size;
+        }
+
+        void response_cache::clear() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _results.clear();
+            _size = 0;
+            ++_generation;
+        }
+
+    }
+}
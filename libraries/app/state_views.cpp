@@ -0,0 +1,118 @@
+#include <steemit/app/state_views.hpp>
+
+#include <steemit/chain/account_object.hpp>
+#include <steemit/follow/follow_objects.hpp>
+
+#include <algorithm>
+
+namespace steemit {
+    namespace app {
+
+        state_views::state_views(uint32_t max_accounts)
+                : _max_accounts(max_accounts) {
+        }
+
+        optional<std::vector<std::string>> state_views::find_trending_tags() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _trending_tags;
+        }
+
+        void state_views::set_trending_tags(std::vector<std::string> tags) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _trending_tags = std::move(tags);
+        }
+
+        optional<extended_account> state_views::find_account(const std::string &name) const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto itr = _accounts.find(name);
+            if (itr == _accounts.end()) {
+                return optional<extended_account>();
+            }
+            return itr->second;
+        }
+
+        void state_views::insert_account(const extended_account &account) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::string name = account.name;
+            if (_accounts.size() >= _max_accounts && !_accounts.count(name)) {
+                _accounts.clear();
+            }
+            _accounts[name] = account;
+        }
+
+        template<typename Object>
+        void state_views::erase_accounts(const chain::database &db, const chain::changed_object_ids &ids,
+                                         account_name_type Object::*account) {
+            if (!ids.removed.empty()) {
+                // The account a removed object belonged to can't be looked up anymore
+                _accounts.clear();
+                return;
+            }
+            for (const auto &changed : {&ids.created, &ids.modified}) {
+                for (auto id : *changed) {
+                    const auto *object = db.find<Object>(typename Object::id_type(id));
+                    if (object != nullptr) {
+                        _accounts.erase(std::string(object->*account));
+                    }
+                }
+            }
+        }
+
+        void state_views::on_changed_objects(const chain::database &db, const chain::changed_objects_notification &note) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (const auto &ids : note.objects) {
+                switch (ids.type) {
+                    case chain::account_object_type:
+                        erase_accounts(db, ids, &chain::account_object::name);
+                        break;
+                    case chain::account_metadata_object_type:
+                        erase_accounts(db, ids, &chain::account_metadata_object::account);
+                        break;
+                    case chain::account_authority_object_type:
+                        erase_accounts(db, ids, &chain::account_authority_object::account);
+                        break;
+                    case chain::account_bandwidth_object_type:
+                        erase_accounts(db, ids, &chain::account_bandwidth_object::account);
+                        break;
+                    case follow::reputation_object_type:
+                        erase_accounts(db, ids, &follow::reputation_object::account);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        void state_views::on_block(uint32_t block_num) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _trending_tags.reset();
+
+            if (block_num != _block_num + 1) {
+                // Popped blocks undo changes without a changed objects notification
+                _accounts.clear();
+            }
+            _block_num = block_num;
+        }
+
+        void state_views::record(const std::string &section, const fc::microseconds &duration) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _sections[section].add(duration);
+        }
+
+        std::vector<chain::timing_stats> state_views::get_stats() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::vector<chain::timing_stats> result;
+            result.reserve(_sections.size());
+            for (const auto &section : _sections) {
+                result.push_back(section.second.get_stats(section.first));
+            }
+
+            std::sort(result.begin(), result.end(),
+                    [](const chain::timing_stats &a, const chain::timing_stats &b) {
+                        return a.total_us > b.total_us;
+                    });
+            return result;
+        }
+
+    }
+}
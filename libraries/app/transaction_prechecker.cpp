@@ -0,0 +1,101 @@
+#include <steemit/app/transaction_prechecker.hpp>
+
+#include <fc/thread/thread.hpp>
+#include <fc/thread/future.hpp>
+
+#include <atomic>
+
+namespace steemit {
+    namespace app {
+
+        namespace detail {
+            struct queued_transaction {
+                chain::prechecked_transaction trx;
+                fc::promise<void>::ptr pushed;
+            };
+
+            class transaction_prechecker_impl {
+            public:
+                transaction_prechecker_impl(std::shared_ptr<chain::database> db, uint32_t skip)
+                        : _db(db), _skip(skip), _thread(&fc::thread::current()) {
+                }
+
+                /// Runs on _thread only
+                void enqueue(queued_transaction &&qt) {
+                    _queue.push_back(std::move(qt));
+                    if (!_flush_task.valid() || _flush_task.ready()) {
+                        _flush_task = _thread->async([this]() { flush(); }, "flush prechecked transactions");
+                    }
+                }
+
+                void flush() {
+                    std::vector<queued_transaction> batch;
+                    batch.swap(_queue);
+
+                    std::vector<chain::prechecked_transaction> trxs;
+                    trxs.reserve(batch.size());
+                    for (auto &qt : batch) {
+                        trxs.push_back(std::move(qt.trx));
+                    }
+
+                    std::vector<fc::exception_ptr> errors;
+                    try {
+                        errors = _db->push_transactions(trxs, _skip);
+                    } catch (const fc::exception &e) {
+                        errors.assign(batch.size(), e.dynamic_copy_exception());
+                    }
+
+                    for (size_t i = 0; i < batch.size(); ++i) {
+                        if (errors[i]) {
+                            batch[i].pushed->set_exception(errors[i]);
+                        } else {
+                            batch[i].pushed->set_value();
+                        }
+                    }
+                }
+
+                std::shared_ptr<chain::database> _db;
+                uint32_t _skip;
+                fc::thread *_thread;
+                std::vector<std::shared_ptr<fc::thread>> _thread_pool;
+                std::atomic<uint32_t> _next_thread{0};
+
+                std::vector<queued_transaction> _queue;
+                fc::future<void> _flush_task;
+            };
+        }
+
+        transaction_prechecker::transaction_prechecker(std::shared_ptr<chain::database> db, uint32_t thread_count,
+                                                       uint32_t skip)
+                : my(new detail::transaction_prechecker_impl(db, skip)) {
+            my->_thread_pool.resize(thread_count);
+            for (uint32_t i = 0; i < thread_count; ++i) {
+                my->_thread_pool[i] = std::make_shared<fc::thread>("precheck");
+            }
+        }
+
+        transaction_prechecker::~transaction_prechecker() {
+        }
+
+        void transaction_prechecker::push_transaction(const chain::signed_transaction &trx) {
+            if (my->_thread_pool.empty()) {
+                my->_db->push_transaction(trx, my->_skip);
+                return;
+            }
+
+            auto &worker = my->_thread_pool[my->_next_thread++ % my->_thread_pool.size()];
+
+            detail::queued_transaction qt;
+            qt.trx.trx = trx;
+            qt.trx.signature_keys = worker->async([&]() {
+                return my->_db->precheck_transaction(trx, my->_skip);
+            }, "precheck transaction").wait();
+            qt.pushed = fc::promise<void>::ptr(new fc::promise<void>("push prechecked transaction"));
+
+            fc::future<void> pushed(qt.pushed);
+            my->_thread->async([&]() { my->enqueue(std::move(qt)); }, "enqueue prechecked transaction").wait();
+            pushed.wait();
+        }
+
+    }
+}
@@ -1,5 +1,7 @@
 #include <steemit/chain/block_log.hpp>
+#include <algorithm>
 #include <fstream>
+#include <mutex>
 
 #define LOG_READ  (std::ios::in | std::ios::binary)
 #define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
@@ -19,6 +21,9 @@ namespace steemit {
                 bool block_write;
                 bool index_write;
 
+                /// Reads switch the streams out of write mode and seek, so they are serialized with writes
+                std::mutex mutex;
+
                 inline void check_block_read() {
                     if (block_write) {
                         block_stream.close();
@@ -53,6 +58,30 @@ namespace steemit {
                         index_write = true;
                     }
                 }
+
+                std::pair<signed_block, uint64_t> read_block(uint64_t pos) {
+                    check_block_read();
+
+                    block_stream.seekg(pos);
+                    std::pair<signed_block, uint64_t> result;
+                    fc::raw::unpack(block_stream, result.first);
+                    result.second = uint64_t(block_stream.tellg()) + 8;
+                    return result;
+                }
+
+                uint64_t get_block_pos(uint32_t block_num) {
+                    check_index_read();
+
+                    if (!(head.valid() && block_num <=
+                                          protocol::block_header::num_from_id(head_id) &&
+                          block_num > 0)) {
+                        return block_log::npos;
+                    }
+                    index_stream.seekg(sizeof(uint64_t) * (block_num - 1));
+                    uint64_t pos;
+                    index_stream.read((char *)&pos, sizeof(pos));
+                    return pos;
+                }
             };
         }
 
@@ -153,6 +182,7 @@ namespace steemit {
 
         uint64_t block_log::append(const signed_block &b) {
             try {
+                std::lock_guard<std::mutex> lock(my->mutex);
                 my->check_block_write();
                 my->check_index_write();
 
@@ -174,26 +204,23 @@ namespace steemit {
         }
 
         void block_log::flush() {
+            std::lock_guard<std::mutex> lock(my->mutex);
             my->block_stream.flush();
             my->index_stream.flush();
         }
 
         std::pair<signed_block, uint64_t> block_log::read_block(uint64_t pos) const {
-            my->check_block_read();
-
-            my->block_stream.seekg(pos);
-            std::pair<signed_block, uint64_t> result;
-            fc::raw::unpack(my->block_stream, result.first);
-            result.second = uint64_t(my->block_stream.tellg()) + 8;
-            return result;
+            std::lock_guard<std::mutex> lock(my->mutex);
+            return my->read_block(pos);
         }
 
         optional<signed_block> block_log::read_block_by_num(uint32_t block_num) const {
             try {
+                std::lock_guard<std::mutex> lock(my->mutex);
                 optional<signed_block> b;
-                uint64_t pos = get_block_pos(block_num);
+                uint64_t pos = my->get_block_pos(block_num);
                 if (pos != npos) {
-                    b = read_block(pos).first;
+                    b = my->read_block(pos).first;
                     FC_ASSERT(b->block_num() ==
                               block_num, "Wrong block was read from block log.", ("returned", b->block_num())("expected", block_num));
                 }
@@ -202,27 +229,65 @@ namespace steemit {
             FC_LOG_AND_RETHROW()
         }
 
-        uint64_t block_log::get_block_pos(uint32_t block_num) const {
-            my->check_index_read();
+        std::vector<std::vector<char>> block_log::read_raw_blocks(uint32_t block_num, uint32_t count) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                std::vector<std::vector<char>> result;
 
-            if (!(my->head.valid() && block_num <=
-                                      protocol::block_header::num_from_id(my->head_id) &&
-                  block_num > 0)) {
-                      return npos;
+                if (!my->head.valid() || block_num == 0) {
+                    return result;
+                }
+                uint32_t head_num = protocol::block_header::num_from_id(my->head_id);
+                if (block_num > head_num) {
+                    return result;
+                }
+                count = std::min(count, head_num - block_num + 1);
+                if (count == 0) {
+                    return result;
+                }
+
+                // Positions of the blocks and of the block after the last one, each block is followed by its position
+                std::vector<uint64_t> positions(count + 1);
+                my->check_index_read();
+                my->index_stream.seekg(sizeof(uint64_t) * (block_num - 1));
+                my->index_stream.read((char *)positions.data(), sizeof(uint64_t) * count);
+
+                my->check_block_read();
+                if (block_num + count <= head_num) {
+                    my->index_stream.read((char *)&positions[count], sizeof(uint64_t));
+                } else {
+                    my->block_stream.seekg(0, std::ios::end);
+                    positions[count] = my->block_stream.tellg();
+                }
+
+                std::vector<char> data(positions[count] - positions[0]);
+                my->block_stream.seekg(positions[0]);
+                my->block_stream.read(data.data(), data.size());
+
+                result.reserve(count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    auto begin = data.begin() + (positions[i] - positions[0]);
+                    auto end = data.begin() + (positions[i + 1] - positions[0] - sizeof(uint64_t));
+                    result.emplace_back(begin, end);
+                }
+                return result;
             }
-            my->index_stream.seekg(sizeof(uint64_t) * (block_num - 1));
-            uint64_t pos;
-            my->index_stream.read((char *)&pos, sizeof(pos));
-            return pos;
+            FC_CAPTURE_AND_RETHROW((block_num)(count))
+        }
+
+        uint64_t block_log::get_block_pos(uint32_t block_num) const {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            return my->get_block_pos(block_num);
         }
 
         signed_block block_log::read_head() const {
+            std::lock_guard<std::mutex> lock(my->mutex);
             my->check_block_read();
 
             uint64_t pos;
             my->block_stream.seekg(-sizeof(pos), std::ios::end);
             my->block_stream.read((char *)&pos, sizeof(pos));
-            return read_block(pos).first;
+            return my->read_block(pos).first;
         }
 
         const optional<signed_block> &block_log::head() const {
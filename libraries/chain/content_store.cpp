@@ -0,0 +1,215 @@
+#include <steemit/chain/content_store.hpp>
+
+#include <fc/io/raw.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace steemit {
+    namespace chain {
+
+        namespace bip = boost::interprocess;
+
+        namespace detail {
+            static const uint64_t header_size = sizeof(uint64_t);
+            static const uint64_t initial_file_size = 64 * 1024 * 1024;
+
+            class content_store_impl {
+            public:
+                fc::path file;
+                bool read_only = false;
+                bip::file_mapping mapping;
+                bip::mapped_region region;
+                mutable std::mutex mutex;
+
+                char *data() const {
+                    return static_cast<char *>(region.get_address());
+                }
+
+                uint64_t mapped_size() const {
+                    return region.get_size();
+                }
+
+                uint64_t &end() const {
+                    return *reinterpret_cast<uint64_t *>(data());
+                }
+
+                void map() {
+                    auto mode = read_only ? bip::read_only : bip::read_write;
+                    mapping = bip::file_mapping(file.generic_string().c_str(), mode);
+                    region = bip::mapped_region(mapping, mode);
+                }
+
+                void unmap() {
+                    region = bip::mapped_region();
+                    mapping = bip::file_mapping();
+                }
+
+                /**
+                 * Return the packed content of the record at the handle and set its size, the lock must be held.
+                 *
+                 * A reader maps the file once, while the writer of another process keeps growing it. Records
+                 * past the mapping of the reader are read after mapping the file again.
+                 */
+                const char *record(uint64_t handle, uint32_t &size) {
+                    FC_ASSERT(region.get_address() != nullptr);
+                    if (read_only && end() > mapped_size()) {
+                        unmap();
+                        map();
+                    }
+                    uint64_t limit = std::min(end(), mapped_size());
+                    FC_ASSERT(handle >= header_size && handle + sizeof(size) <= limit, "Invalid content handle");
+                    std::memcpy(&size, data() + handle, sizeof(size));
+                    FC_ASSERT(handle + sizeof(size) + size <= limit, "Invalid content handle");
+                    return data() + handle + sizeof(size);
+                }
+
+                void grow(uint64_t required) {
+                    uint64_t new_size = std::max(mapped_size() * 2, required);
+                    region.flush();
+                    unmap();
+                    fc::resize_file(file, new_size);
+                    map();
+                }
+            };
+        }
+
+        content_store::content_store()
+                : my(new detail::content_store_impl()) {
+        }
+
+        content_store::~content_store() {
+            close();
+        }
+
+        void content_store::open(const fc::path &file, bool read_only) {
+            try {
+                close();
+                my->file = file;
+                my->read_only = read_only;
+
+                if (read_only) {
+                    FC_ASSERT(fc::exists(file) && fc::file_size(file) >= detail::header_size,
+                            "Content store does not exist, it is created by the node writing the chain state");
+                } else if (!fc::exists(file) ||
+                           fc::file_size(file) < detail::header_size) {
+                    std::ofstream(file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                    fc::resize_file(file, detail::initial_file_size);
+                }
+
+                my->map();
+
+                if (read_only) {
+                    return;
+                }
+
+                if (my->end() < detail::header_size) {
+                    my->end() = detail::header_size;
+                }
+                FC_ASSERT(my->end() <= my->mapped_size(), "Content store is corrupted",
+                        ("end", my->end())("size", my->mapped_size()));
+            }
+            FC_CAPTURE_AND_RETHROW((file)(read_only))
+        }
+
+        void content_store::close() {
+            if (is_open()) {
+                flush();
+            }
+            my.reset(new detail::content_store_impl());
+        }
+
+        bool content_store::is_open() const {
+            return my->region.get_address() != nullptr;
+        }
+
+        void content_store::reset() {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            FC_ASSERT(is_open() && !my->read_only);
+            my->end() = detail::header_size;
+        }
+
+        uint64_t content_store::append(const comment_content &content) {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                FC_ASSERT(is_open() && !my->read_only);
+
+                auto packed = fc::raw::pack(content);
+                uint32_t size = packed.size();
+                uint64_t handle = my->end();
+                uint64_t required = handle + sizeof(size) + size;
+
+                if (required > my->mapped_size()) {
+                    my->grow(required);
+                }
+
+                std::memcpy(my->data() + handle, &size, sizeof(size));
+                std::memcpy(my->data() + handle + sizeof(size), packed.data(), size);
+                my->end() = required;
+
+                return handle;
+            }
+            FC_CAPTURE_AND_RETHROW()
+        }
+
+        comment_content content_store::read(uint64_t handle) const {
+            try {
+                comment_content result;
+                if (handle == 0) {
+                    return result;
+                }
+
+                // The mapping may be replaced by a concurrent append, so only the copy is made under the lock
+                std::vector<char> packed;
+                {
+                    std::lock_guard<std::mutex> lock(my->mutex);
+                    uint32_t size;
+                    const char *record = my->record(handle, size);
+                    packed.assign(record, record + size);
+                }
+
+                fc::datastream<const char *> ds(packed.data(), packed.size());
+                fc::raw::unpack(ds, result);
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((handle))
+        }
+
+        std::string content_store::read_json_metadata(uint64_t handle) const {
+            try {
+                std::string result;
+                if (handle == 0) {
+                    return result;
+                }
+
+                // Title and body are skipped in place, only the json_metadata is copied
+                std::lock_guard<std::mutex> lock(my->mutex);
+                uint32_t size;
+                fc::datastream<const char *> ds(my->record(handle, size), size);
+                for (int i = 0; i < 2; ++i) {
+                    fc::unsigned_int length;
+                    fc::raw::unpack(ds, length);
+                    FC_ASSERT(length.value <= ds.remaining(), "Invalid content record");
+                    ds.skip(length.value);
+                }
+                fc::raw::unpack(ds, result);
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((handle))
+        }
+
+        void content_store::flush() {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            if (is_open() && !my->read_only) {
+                my->region.flush();
+            }
+        }
+
+    }
+}
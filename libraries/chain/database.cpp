@@ -3,6 +3,7 @@
 #include <boost/iostreams/device/mapped_file.hpp>
 
 #include <steemit/protocol/steem_operations.hpp>
+#include <steemit/protocol/operation_util_impl.hpp>
 
 #include <steemit/chain/block_summary_object.hpp>
 #include <steemit/chain/compound.hpp>
@@ -21,6 +22,8 @@
 #include <steemit/chain/operation_notification.hpp>
 
 #include <fc/smart_ref_impl.hpp>
+#include <fc/scoped_exit.hpp>
+#include <fc/thread/thread.hpp>
 
 #include <fc/container/deque.hpp>
 
@@ -95,6 +98,8 @@ namespace steemit {
             try {
                 init_schema();
                 chainbase::database::open(shared_mem_dir, chainbase_flags, shared_file_size);
+                _content_store.open(shared_mem_dir / "content_store.bin",
+                        !(chainbase_flags & chainbase::database::read_write));
 
                 initialize_indexes();
                 initialize_evaluators();
@@ -102,12 +107,37 @@ namespace steemit {
                 if (chainbase_flags & chainbase::database::read_write) {
                     if (!find<dynamic_global_property_object>()) {
                         with_write_lock([&]() {
+                            _content_store.reset();
                             init_genesis(initial_supply);
                         });
                     }
 
                     _block_log.open(data_dir / "block_log");
 
+                    if (_store_trx_index) {
+                        auto trx_index_file = data_dir / "transaction_index";
+                        _trx_index_log.open(trx_index_file);
+
+                        uint32_t log_head_num = _block_log.head() ? _block_log.head()->block_num() : 0;
+                        if (_trx_index_log.head_block_num() > log_head_num) {
+                            wlog("Transaction index is ahead of block log, rebuilding it");
+                            _trx_index_log.close();
+                            fc::remove_all(trx_index_file);
+                            fc::remove_all(fc::path(trx_index_file.generic_string() + ".data"));
+                            _trx_index_log.open(trx_index_file);
+                        }
+
+                        update_transaction_index();
+                    }
+
+                    if (_store_account_history) {
+                        _history_log.open(shared_mem_dir / "account_history");
+                    }
+
+                    if (_store_vote_archive) {
+                        _vote_archive.open(shared_mem_dir / "vote_archive");
+                    }
+
                     auto log_head = _block_log.head();
 
                     // Rewind all undo state. This should return us to the state at the last irreversible block.
@@ -116,6 +146,12 @@ namespace steemit {
                         FC_ASSERT(revision() ==
                                   head_block_num(), "Chainbase revision does not match head block num",
                                 ("rev", revision())("head_block", head_block_num()));
+
+                        // History kept in shared memory by an older node is moved here, with no undo
+                        // session recording it, rather than by the next block
+                        if (_store_account_history) {
+                            update_history_log();
+                        }
                     });
 
                     if (head_block_num()) {
@@ -126,6 +162,15 @@ namespace steemit {
 
                         _fork_db.start_block(*head_block);
                     }
+                } else {
+                    // Irreversible history and votes are only in files the node writing the chain keeps appending to
+                    if (_store_account_history) {
+                        _history_log.open(shared_mem_dir / "account_history", true);
+                    }
+
+                    if (_store_vote_archive) {
+                        _vote_archive.open(shared_mem_dir / "vote_archive", true);
+                    }
                 }
 
                 with_read_lock([&]() {
@@ -199,9 +244,18 @@ namespace steemit {
         void database::wipe(const fc::path &data_dir, const fc::path &shared_mem_dir, bool include_blocks) {
             close();
             chainbase::database::wipe(shared_mem_dir);
+            fc::remove_all(shared_mem_dir / "content_store.bin");
+            for (const auto &ext : {"", ".ops", ".blocks", ".entries"}) {
+                fc::remove_all(shared_mem_dir / (std::string("account_history") + ext));
+            }
+            for (const auto &ext : {"", ".comments", ".votes"}) {
+                fc::remove_all(shared_mem_dir / (std::string("vote_archive") + ext));
+            }
             if (include_blocks) {
                 fc::remove_all(data_dir / "block_log");
                 fc::remove_all(data_dir / "block_log.index");
+                fc::remove_all(data_dir / "transaction_index");
+                fc::remove_all(data_dir / "transaction_index.data");
             }
         }
 
@@ -214,8 +268,13 @@ namespace steemit {
 
                 chainbase::database::flush();
                 chainbase::database::close();
+                _content_store.close();
 
                 _block_log.close();
+                _trx_index_log.close();
+                _history_log.close();
+                _vote_archive.close();
+                _pending_archived_votes.clear();
 
                 _fork_db.reset();
             }
@@ -314,6 +373,10 @@ namespace steemit {
             } FC_LOG_AND_RETHROW()
         }
 
+        const block_log &database::get_block_log() const {
+            return _block_log;
+        }
+
         const signed_transaction database::get_recent_transaction(const transaction_id_type &trx_id) const {
             try {
                 auto &index = get_index<transaction_index>().indices().get<by_trx_id>();
@@ -370,6 +433,12 @@ namespace steemit {
             return find<account_object, by_name>(name);
         }
 
+        const account_metadata_object &database::get_account_metadata(const account_name_type &name) const {
+            try {
+                return get<account_metadata_object, by_account>(name);
+            } FC_CAPTURE_AND_RETHROW((name))
+        }
+
         const comment_object &database::get_comment(const account_name_type &author, const shared_string &permlink) const {
             try {
                 return get<comment_object, by_permlink>(boost::make_tuple(author, permlink));
@@ -390,16 +459,41 @@ namespace steemit {
             return find<comment_object, by_permlink>(boost::make_tuple(author, permlink));
         }
 
-        const category_object &database::get_category(const shared_string &name) const {
+        const category_object &database::get_category(const interned_string_id_type &name) const {
             try {
                 return get<category_object, by_name>(name);
             } FC_CAPTURE_AND_RETHROW((name))
         }
 
-        const category_object *database::find_category(const shared_string &name) const {
+        const category_object *database::find_category(const interned_string_id_type &name) const {
             return find<category_object, by_name>(name);
         }
 
+        interned_string_id_type database::intern_string(const string &value) {
+            const auto *existing = find_interned_string(value);
+            if (existing != nullptr) {
+                return existing->id;
+            }
+            return create<interned_string_object>([&](interned_string_object &s) {
+                s.hash = interned_string_object::hash_of(value);
+                from_string(s.value, value);
+            }).id;
+        }
+
+        const interned_string_object *database::find_interned_string(const string &value) const {
+            return find<interned_string_object, by_value>(boost::make_tuple(interned_string_object::hash_of(value), value));
+        }
+
+        const shared_string &database::get_interned_string(const interned_string_id_type &id) const {
+            try {
+                return get<interned_string_object>(id).value;
+            } FC_CAPTURE_AND_RETHROW((id))
+        }
+
+        const comment_object &database::get_parent_comment(const comment_object &comment) const {
+            return get(comment.parent_comment);
+        }
+
         const escrow_object &database::get_escrow(const account_name_type &name, uint32_t escrow_id) const {
             try {
                 return get<escrow_object, by_from_id>(boost::make_tuple(name, escrow_id));
@@ -761,6 +855,7 @@ namespace steemit {
                     detail::with_skip_flags(*this, skip,
                             [&]() {
                                 with_write_lock([&]() {
+                                    make_room_for_pending_transaction(trx);
                                     _push_transaction(trx);
                                 });
                             });
@@ -774,6 +869,104 @@ namespace steemit {
             FC_CAPTURE_AND_RETHROW((trx))
         }
 
+        flat_set<public_key_type> database::precheck_transaction(const signed_transaction &trx, uint32_t skip) {
+            try {
+                if (!(skip & skip_validate)) {
+                    trx.validate();
+                }
+
+                with_read_lock([&]() {
+                    FC_ASSERT(fc::raw::pack_size(trx) <=
+                              (get_dynamic_global_properties().maximum_block_size -
+                               256));
+
+                    if (BOOST_LIKELY(head_block_num() > 0)) {
+                        if (!(skip & skip_tapos_check)) {
+                            const auto &tapos_block_summary = get<block_summary_object>(trx.ref_block_num);
+                            FC_ASSERT(trx.ref_block_prefix ==
+                                      tapos_block_summary.block_id._hash[1],
+                                    "", ("trx.ref_block_prefix", trx.ref_block_prefix)
+                                    ("tapos_block_summary", tapos_block_summary.block_id._hash[1]));
+                        }
+
+                        fc::time_point_sec now = head_block_time();
+                        FC_ASSERT(trx.expiration <= now +
+                                                    fc::seconds(STEEMIT_MAX_TIME_UNTIL_EXPIRATION), "",
+                                ("trx.expiration", trx.expiration)("now", now)("max_til_exp", STEEMIT_MAX_TIME_UNTIL_EXPIRATION));
+                        FC_ASSERT(now <
+                                  trx.expiration, "", ("now", now)("trx.exp", trx.expiration));
+                    }
+                });
+
+                // Signatures are not checked when pushed with these flags either
+                if (skip & (skip_transaction_signatures | skip_authority_check)) {
+                    return flat_set<public_key_type>();
+                }
+                return trx.get_signature_keys(STEEMIT_CHAIN_ID);
+            }
+            FC_CAPTURE_AND_RETHROW((trx))
+        }
+
+        vector<fc::exception_ptr> database::push_transactions(const vector<prechecked_transaction> &trxs, uint32_t skip) {
+            vector<fc::exception_ptr> result(trxs.size());
+
+            try {
+                set_producing(true);
+                detail::with_skip_flags(*this, skip, [&]() {
+                    with_write_lock([&]() {
+                        for (size_t i = 0; i < trxs.size(); ++i) {
+                            try {
+                                make_room_for_pending_transaction(trxs[i].trx);
+                                _current_trx_signature_keys = &trxs[i].signature_keys;
+                                _push_transaction(trxs[i].trx);
+                                _current_trx_signature_keys = nullptr;
+                            }
+                            catch (const fc::exception &e) {
+                                _current_trx_signature_keys = nullptr;
+                                result[i] = e.dynamic_copy_exception();
+                            }
+                        }
+                    });
+                });
+                set_producing(false);
+            }
+            catch (...) {
+                set_producing(false);
+                throw;
+            }
+
+            return result;
+        }
+
+        void database::make_room_for_pending_transaction(const signed_transaction &trx) {
+            uint64_t trx_size = fc::raw::pack_size(trx);
+            FC_ASSERT(!_max_pending_tx_size || trx_size <= _max_pending_tx_size,
+                    "Transaction is larger than the pending transaction pool", ("size", trx_size));
+
+            bool count_full = _max_pending_tx_count && _pending_tx.size() >= _max_pending_tx_count;
+            bool size_full = _max_pending_tx_size && _pending_tx_size + trx_size > _max_pending_tx_size;
+            if (!count_full && !size_full) {
+                return;
+            }
+
+            // Drop the oldest tenth of the pool at once, so the rest is re-applied once per many pushes
+            // instead of on every push to a full pool
+            uint32_t max_count = _max_pending_tx_count ? _max_pending_tx_count - std::max<uint32_t>(_max_pending_tx_count / 10, 1) : 0;
+            uint64_t max_size = _max_pending_tx_size - _max_pending_tx_size / 10;
+            size_t dropped = 0;
+            uint64_t kept_size = _pending_tx_size;
+            while (dropped < _pending_tx.size() &&
+                   ((_max_pending_tx_count && _pending_tx.size() - dropped > max_count) ||
+                    (_max_pending_tx_size && kept_size + trx_size > max_size))) {
+                kept_size -= fc::raw::pack_size(_pending_tx[dropped]);
+                ++dropped;
+            }
+
+            wlog("Pending transaction pool is full, dropping ${n} oldest transactions", ("n", dropped));
+            std::vector<signed_transaction> kept(_pending_tx.begin() + dropped, _pending_tx.end());
+            detail::without_pending_transactions(*this, std::move(kept), []() {});
+        }
+
         void database::_push_transaction(const signed_transaction &trx) {
             // If this is the first transaction pushed after applying a block, start a new undo session.
             // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
@@ -789,8 +982,9 @@ namespace steemit {
             auto temp_session = start_undo_session(true);
             _apply_transaction(trx);
             _pending_tx.push_back(trx);
+            _pending_tx_size += fc::raw::pack_size(trx);
+            _pending_tx_skip_flags |= get_node_properties().skip_flags;
 
-            notify_changed_objects();
             // The transaction applied successfully. Merge its changes into the pending block session.
             temp_session.squash();
 
@@ -851,6 +1045,28 @@ namespace steemit {
                 // the value of the "when" variable is known, which means we need to
                 // re-apply pending transactions in this method.
                 //
+
+                // When every pending transaction fits into the block and none of them has expired,
+                // the pending session already is the result of applying exactly these transactions
+                // on top of the head block, so there is nothing to re-apply. The pending transactions
+                // must not have skipped any check which the block being generated is subject to.
+                bool can_reuse_pending_state = _pending_tx_session.valid() &&
+                                               !(_pending_tx_skip_flags & ~skip);
+                for (const signed_transaction &tx : _pending_tx) {
+                    if (!can_reuse_pending_state) {
+                        break;
+                    }
+                    total_block_size += fc::raw::pack_size(tx);
+                    can_reuse_pending_state = tx.expiration >= when &&
+                                              total_block_size < maximum_block_size;
+                }
+
+                if (can_reuse_pending_state) {
+                    pending_block.transactions = _pending_tx;
+                    return;
+                }
+
+                total_block_size = max_block_header_size;
                 _pending_tx_session.reset();
                 _pending_tx_session = start_undo_session(true);
 
@@ -968,6 +1184,11 @@ namespace steemit {
 
                 _popped_tx.insert(_popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end());
 
+                _pending_archived_votes.erase(_pending_archived_votes.lower_bound(head_block->block_num()),
+                        _pending_archived_votes.end());
+
+                notify_popped_block(*head_block);
+
             }
             FC_CAPTURE_AND_RETHROW()
         }
@@ -977,6 +1198,8 @@ namespace steemit {
                 assert((_pending_tx.size() == 0) ||
                        _pending_tx_session.valid());
                 _pending_tx.clear();
+                _pending_tx_size = 0;
+                _pending_tx_skip_flags = 0;
                 _pending_tx_session.reset();
             }
             FC_CAPTURE_AND_RETHROW()
@@ -988,6 +1211,17 @@ namespace steemit {
             note.trx_in_block = _current_trx_in_block;
             note.op_in_trx = _current_op_in_trx;
 
+            if (_block_operation_collectors && _applying_block) {
+                block_operation op;
+                op.trx_id = note.trx_id;
+                op.trx_in_block = note.trx_in_block;
+                op.op_in_trx = note.op_in_trx;
+                op.virtual_op = note.is_virtual();
+                op.op = note.op;
+                op.impacted = note.impacted_accounts();
+                _block_operations.push_back(std::move(op));
+            }
+
             STEEMIT_TRY_NOTIFY(pre_apply_operation, note)
         }
 
@@ -1004,12 +1238,37 @@ namespace steemit {
 
             FC_ASSERT(is_virtual_operation(op));
             operation_notification note(op);
+            if (!_operation_profiling) {
+                notify_pre_apply_operation(note);
+                notify_post_apply_operation(note);
+                return;
+            }
+
+            auto &profile = get_operation_profile(op);
+            auto start = fc::time_point::now();
             notify_pre_apply_operation(note);
+            auto pre_applied = fc::time_point::now();
             notify_post_apply_operation(note);
+            profile.pre_apply.add(pre_applied - start);
+            profile.post_apply.add(fc::time_point::now() - pre_applied);
         }
 
         void database::notify_applied_block(const signed_block &block) {
             STEEMIT_TRY_NOTIFY(applied_block, block)
+
+            if (_block_operation_collectors) {
+                block_notification note;
+                note.block = block;
+                note.props = get_dynamic_global_properties();
+                note.operations = std::move(_block_operations);
+                _block_operations.clear();
+
+                STEEMIT_TRY_NOTIFY(applied_block_operations, note)
+            }
+        }
+
+        void database::notify_popped_block(const signed_block &block) {
+            STEEMIT_TRY_NOTIFY(popped_block, block)
         }
 
         void database::notify_on_pending_transaction(const signed_transaction &tx) {
@@ -1770,7 +2029,7 @@ namespace steemit {
                 comment.children_rshares2 += new_rshares2;
             });
             if (c.depth) {
-                adjust_rshares2(get_comment(c.parent_author, c.parent_permlink), old_rshares2, new_rshares2);
+                adjust_rshares2(get_parent_comment(c), old_rshares2, new_rshares2);
             } else {
                 const auto &cprops = get_dynamic_global_properties();
                 modify(cprops, [&](dynamic_global_property_object &p) {
@@ -1964,11 +2223,17 @@ namespace steemit {
                         }
                     }
 
-                    auto itr = comment_by_parent.lower_bound(boost::make_tuple(cur.author, cur.permlink, comment_id_type()));
+                    // A comment without replies never had its permlink interned
+                    const auto *cur_permlink = find_interned_string(to_string(cur.permlink));
+                    if (cur_permlink == nullptr) {
+                        continue;
+                    }
+
+                    auto itr = comment_by_parent.lower_bound(boost::make_tuple(cur.author, cur_permlink->id, comment_id_type()));
 
                     while (itr != comment_by_parent.end() &&
                            itr->parent_author == cur.author &&
-                           itr->parent_permlink == cur.permlink) {
+                           itr->parent_permlink == cur_permlink->id) {
                         child_queue.push_back(itr->id);
                         ++itr;
                     }
@@ -2158,6 +2423,17 @@ namespace steemit {
                         });
                     } else {
 #ifdef CLEAR_VOTES
+                        if (_store_vote_archive) {
+                            archived_vote v;
+                            v.comment = cur_vote.comment._id;
+                            v.voter = cur_vote.voter._id;
+                            v.weight = cur_vote.weight;
+                            v.rshares = cur_vote.rshares;
+                            v.vote_percent = cur_vote.vote_percent;
+                            v.last_update = cur_vote.last_update;
+                            v.num_changes = cur_vote.num_changes;
+                            _pending_archived_votes[_current_block_num].push_back(v);
+                        }
                         remove(cur_vote);
 #endif
                     }
@@ -2596,7 +2872,7 @@ namespace steemit {
 
             while (change_req != change_req_idx.end() &&
                    change_req->effective_on <= head_block_time()) {
-                modify(get_account(change_req->account_to_recover), [&](account_object &a) {
+                modify(get_account_metadata(change_req->account_to_recover), [&](account_metadata_object &a) {
                     a.recovery_account = change_req->recovery_account;
                 });
 
@@ -2654,6 +2930,9 @@ namespace steemit {
         }
 
         time_point_sec database::head_block_time() const {
+            if (_replaying_operation_history) {
+                return _operation_history_time;
+            }
             return get_dynamic_global_properties().time;
         }
 
@@ -2733,6 +3012,7 @@ namespace steemit {
             add_core_index<dynamic_global_property_index>(*this);
             add_core_index<account_index>(*this);
             add_core_index<account_authority_index>(*this);
+            add_core_index<account_metadata_index>(*this);
             add_core_index<account_bandwidth_index>(*this);
             add_core_index<witness_index>(*this);
             add_core_index<transaction_index>(*this);
@@ -2748,6 +3028,7 @@ namespace steemit {
             add_core_index<operation_index>(*this);
             add_core_index<account_history_index>(*this);
             add_core_index<category_index>(*this);
+            add_core_index<interned_string_index>(*this);
             add_core_index<hardfork_property_index>(*this);
             add_core_index<withdraw_vesting_route_index>(*this);
             add_core_index<owner_authority_history_index>(*this);
@@ -2848,6 +3129,9 @@ namespace steemit {
                 create<account_object>([&](account_object &a) {
                     a.name = STEEMIT_MINER_ACCOUNT;
                 });
+                create<account_metadata_object>([&](account_metadata_object &m) {
+                    m.account = STEEMIT_MINER_ACCOUNT;
+                });
                 create<account_authority_object>([&](account_authority_object &auth) {
                     auth.account = STEEMIT_MINER_ACCOUNT;
                     auth.owner.weight_threshold = 1;
@@ -2857,6 +3141,9 @@ namespace steemit {
                 create<account_object>([&](account_object &a) {
                     a.name = STEEMIT_NULL_ACCOUNT;
                 });
+                create<account_metadata_object>([&](account_metadata_object &m) {
+                    m.account = STEEMIT_NULL_ACCOUNT;
+                });
                 create<account_authority_object>([&](account_authority_object &auth) {
                     auth.account = STEEMIT_NULL_ACCOUNT;
                     auth.owner.weight_threshold = 1;
@@ -2866,6 +3153,9 @@ namespace steemit {
                 create<account_object>([&](account_object &a) {
                     a.name = STEEMIT_TEMP_ACCOUNT;
                 });
+                create<account_metadata_object>([&](account_metadata_object &m) {
+                    m.account = STEEMIT_TEMP_ACCOUNT;
+                });
                 create<account_authority_object>([&](account_authority_object &auth) {
                     auth.account = STEEMIT_TEMP_ACCOUNT;
                     auth.owner.weight_threshold = 0;
@@ -2880,6 +3170,11 @@ namespace steemit {
                         a.balance = asset(i ? 0 : init_supply, STEEM_SYMBOL);
                     });
 
+                    create<account_metadata_object>([&](account_metadata_object &m) {
+                        m.account = STEEMIT_INIT_MINER_NAME +
+                                    (i ? fc::to_string(i) : std::string());
+                    });
+
                     create<account_authority_object>([&](account_authority_object &auth) {
                         auth.account = STEEMIT_INIT_MINER_NAME +
                                        (i ? fc::to_string(i) : std::string());
@@ -2931,8 +3226,12 @@ namespace steemit {
                     create<account_object>([&](account_object &a) {
                         a.name = account.name;
                         a.memo_key = account.keys.memo_key;
-                        a.json_metadata = "{created_at: 'GENESIS'}";
-                        a.recovery_account = STEEMIT_INIT_MINER_NAME;
+                    });
+
+                    create<account_metadata_object>([&](account_metadata_object &m) {
+                        m.account = account.name;
+                        m.json_metadata = "{created_at: 'GENESIS'}";
+                        m.recovery_account = STEEMIT_INIT_MINER_NAME;
                     });
 
                     create<account_authority_object>([&](account_authority_object &auth) {
@@ -2976,26 +3275,32 @@ namespace steemit {
 
         void database::notify_changed_objects() {
             try {
-                /*vector< graphene::chainbase::generic_id > ids;
-      get_changed_ids( ids );
-      STEEMIT_TRY_NOTIFY( changed_objects, ids )*/
-                /*
-      if( _undo_db.enabled() )
-      {
-         const auto& head_undo = _undo_db.head();
-         vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
-         for( const auto& item : head_undo.old_values ) changed_ids.push_back(item.first);
-         for( const auto& item : head_undo.new_ids ) changed_ids.push_back(item);
-         vector<const object*> removed;
-         removed.reserve( head_undo.removed.size() );
-         for( const auto& item : head_undo.removed )
-         {
-            changed_ids.push_back( item.first );
-            removed.emplace_back( item.second.get() );
-         }
-         STEEMIT_TRY_NOTIFY( changed_objects, changed_ids )
-      }
-      */
+                if (changed_objects.empty()) {
+                    return;
+                }
+
+                // The head undo state holds the changes of the block only while the block session is open,
+                // there is none e.g. while reindexing
+                if (revision() != head_block_num()) {
+                    return;
+                }
+
+                changed_objects_notification note;
+                note.block_num = head_block_num();
+
+                for (const auto *index : get_index_list()) {
+                    changed_object_ids ids;
+                    ids.type = index->type_id();
+                    if (!index->head_undo_state_ids(ids.created, ids.modified, ids.removed)) {
+                        continue;
+                    }
+                    if (ids.created.empty() && ids.modified.empty() && ids.removed.empty()) {
+                        continue;
+                    }
+                    note.objects.push_back(std::move(ids));
+                }
+
+                STEEMIT_TRY_NOTIFY(changed_objects, note)
             }
             FC_CAPTURE_AND_RETHROW()
 
@@ -3006,6 +3311,338 @@ namespace steemit {
             _next_flush_block = 0;
         }
 
+        void database::set_block_profiling(bool enabled, uint32_t slow_block_ms) {
+            _block_profiler.set_enabled(enabled);
+            _block_profiler.set_slow_block_threshold(fc::milliseconds(slow_block_ms));
+        }
+
+        const block_profiler &database::get_block_profiler() const {
+            return _block_profiler;
+        }
+
+        void database::set_operation_profiling(bool enabled, uint32_t log_interval_blocks) {
+            _operation_profiling = enabled;
+            _operation_profile_log_interval = log_interval_blocks;
+        }
+
+        void database::set_pending_transactions_limit(uint32_t max_count, uint64_t max_size) {
+            _max_pending_tx_count = max_count;
+            _max_pending_tx_size = max_size;
+        }
+
+        void database::set_store_transaction_index(bool store_trx_index) {
+            _store_trx_index = store_trx_index;
+        }
+
+        void database::set_store_account_history(bool store_account_history) {
+            _store_account_history = store_account_history;
+        }
+
+        void database::set_operation_history_filtered(bool filtered) {
+            _operation_history_filtered = filtered;
+        }
+
+        void database::set_store_vote_archive(bool store_vote_archive) {
+            _store_vote_archive = store_vote_archive;
+        }
+
+        std::vector<archived_vote> database::get_archived_comment_votes(const comment_id_type &comment) const {
+            auto result = _vote_archive.get_comment_votes(comment._id);
+            if (!result.empty()) {
+                return result;
+            }
+
+            for (const auto &block : _pending_archived_votes) {
+                for (const auto &v : block.second) {
+                    if (v.comment == comment._id) {
+                        result.push_back(v);
+                    }
+                }
+            }
+            return result;
+        }
+
+        std::vector<archived_vote> database::get_archived_account_votes(const account_id_type &voter) const {
+            std::vector<archived_vote> result;
+            for (auto block = _pending_archived_votes.rbegin(); block != _pending_archived_votes.rend(); ++block) {
+                for (auto v = block->second.rbegin(); v != block->second.rend(); ++v) {
+                    if (v->voter == voter._id) {
+                        result.push_back(*v);
+                    }
+                }
+            }
+
+            auto archived = _vote_archive.get_account_votes(voter._id);
+            result.insert(result.end(), archived.begin(), archived.end());
+            return result;
+        }
+
+        comment_content database::get_comment_content(const comment_object &comment) const {
+            return _content_store.read(comment.content);
+        }
+
+        std::string database::get_comment_json_metadata(const comment_object &comment) const {
+            return _content_store.read_json_metadata(comment.content);
+        }
+
+        uint64_t database::store_comment_content(const comment_content &content) {
+            return _content_store.append(content);
+        }
+
+        optional<transaction_location> database::find_transaction_location(const transaction_id_type &trx_id) const {
+            if (!_store_trx_index) {
+                return optional<transaction_location>();
+            }
+            return _trx_index_log.find(trx_id);
+        }
+
+        void database::update_transaction_index() {
+            try {
+                const auto &log_head = _block_log.head();
+                if (!log_head ||
+                    _trx_index_log.head_block_num() >= log_head->block_num()) {
+                    return;
+                }
+
+                uint32_t last_block_num = log_head->block_num();
+                ilog("Indexing transactions from block ${from} to ${to}",
+                        ("from", _trx_index_log.head_block_num() + 1)("to", last_block_num));
+
+                // Walk the block log sequentially instead of seeking through its index for every block
+                auto itr = _block_log.read_block(_block_log.get_block_pos(
+                        _trx_index_log.head_block_num() + 1));
+
+                while (true) {
+                    auto cur_block_num = itr.first.block_num();
+                    if (cur_block_num % 100000 == 0) {
+                        std::cerr << "   " << double(cur_block_num * 100) /
+                                              last_block_num << "%   "
+                                  << cur_block_num << " of "
+                                  << last_block_num << "\n";
+                    }
+
+                    _trx_index_log.append(itr.first);
+                    if (cur_block_num == last_block_num) {
+                        break;
+                    }
+                    itr = _block_log.read_block(itr.second);
+                }
+
+                _trx_index_log.flush();
+            }
+            FC_CAPTURE_AND_RETHROW()
+        }
+
+        void database::update_history_log() {
+            try {
+                uint32_t last_irreversible_block = get_dynamic_global_properties().last_irreversible_block_num;
+                if (last_irreversible_block <= _history_log.head_block_num()) {
+                    return;
+                }
+
+                const auto &op_idx = get_index<operation_index>().indices().get<by_location>();
+                const auto &hist_idx = get_index<account_history_index>().indices().get<by_operation>();
+
+                std::map<operation_id_type, std::vector<history_account_entry>> op_accounts;
+                std::vector<const account_history_object *> migrated_hist;
+                std::vector<const operation_object *> migrated_ops;
+                std::vector<const operation_object *> block_ops;
+
+                // Operations of a block are written in the order they were created in, which is
+                // the order their sequence numbers were assigned in
+                auto append_block_ops = [&]() {
+                    std::sort(block_ops.begin(), block_ops.end(),
+                            [](const operation_object *a, const operation_object *b) {
+                                return a->id < b->id;
+                            });
+
+                    std::vector<std::pair<history_operation, std::vector<history_account_entry>>> ops;
+                    ops.reserve(block_ops.size());
+                    for (const auto *op : block_ops) {
+                        history_operation h;
+                        h.trx_id = op->trx_id;
+                        h.block = op->block;
+                        h.trx_in_block = op->trx_in_block;
+                        h.op_in_trx = op->op_in_trx;
+                        h.virtual_op = op->virtual_op;
+                        h.timestamp = op->timestamp;
+                        h.serialized_op.assign(op->serialized_op.begin(), op->serialized_op.end());
+                        ops.emplace_back(std::move(h), std::move(op_accounts[op->id]));
+                    }
+
+                    _history_log.append_block(block_ops.front()->block, ops);
+                    block_ops.clear();
+                };
+
+                // Only operations of irreversible blocks are left to migrate, the older ones are gone already
+                for (auto itr = op_idx.begin();
+                     itr != op_idx.end() &&
+                     itr->block <= last_irreversible_block; ++itr) {
+                    migrated_ops.push_back(&*itr);
+
+                    for (auto hist = hist_idx.lower_bound(itr->id);
+                         hist != hist_idx.end() && hist->op == itr->id; ++hist) {
+                        migrated_hist.push_back(&*hist);
+
+                        const auto *account = find_account(hist->account);
+                        if (account != nullptr) {
+                            history_account_entry entry;
+                            entry.account = account->id._id;
+                            entry.sequence = hist->sequence;
+                            op_accounts[itr->id].push_back(entry);
+                        }
+                    }
+
+                    // Restored by undo after being written
+                    if (itr->block <= _history_log.head_block_num()) {
+                        continue;
+                    }
+
+                    if (!block_ops.empty() &&
+                        block_ops.front()->block != itr->block) {
+                        append_block_ops();
+                    }
+                    block_ops.push_back(&*itr);
+                }
+
+                if (!block_ops.empty()) {
+                    append_block_ops();
+                }
+
+                if (_history_log.head_block_num() < last_irreversible_block) {
+                    _history_log.append_block(last_irreversible_block, {});
+                }
+                _history_log.flush();
+
+                for (const auto *hist : migrated_hist) {
+                    remove(*hist);
+                }
+                for (const auto *op : migrated_ops) {
+                    remove(*op);
+                }
+            }
+            FC_CAPTURE_AND_RETHROW()
+        }
+
+        void database::update_vote_archive() {
+            try {
+                uint32_t last_irreversible_block = get_dynamic_global_properties().last_irreversible_block_num;
+
+                auto itr = _pending_archived_votes.begin();
+                for (; itr != _pending_archived_votes.end() && itr->first <= last_irreversible_block; ++itr) {
+                    // Archived before a restart rewound the state to the last irreversible block
+                    if (itr->first <= _vote_archive.head_block_num()) {
+                        continue;
+                    }
+                    _vote_archive.append_block(itr->first, itr->second);
+                }
+                _pending_archived_votes.erase(_pending_archived_votes.begin(), itr);
+
+                if (_vote_archive.head_block_num() < last_irreversible_block) {
+                    _vote_archive.append_block(last_irreversible_block, {});
+                }
+                _vote_archive.flush();
+            }
+            FC_CAPTURE_AND_RETHROW()
+        }
+
+        void database::replay_operation_history(const std::function<void(const operation_notification &)> &handler) {
+            try {
+                struct replayed_operation {
+                    history_operation hist;
+                    operation op;
+                };
+
+                const auto &op_idx = get_index<operation_index>().indices().get<by_id>();
+                uint32_t log_head = _history_log.is_open() ? _history_log.head_block_num() : 0;
+
+                FC_ASSERT(log_head > 0 || !op_idx.empty(),
+                        "No operation history is stored, it is kept by the account_history plugin");
+                FC_ASSERT(!_operation_history_filtered,
+                        "Operation history is filtered by filter-posting-ops or track-account-range, "
+                        "plugins can't be rebuilt from it");
+
+                _replaying_operation_history = true;
+                auto replaying_guard = fc::make_scoped_exit([this]() {
+                    _replaying_operation_history = false;
+                });
+
+                uint64_t count = 0;
+                auto apply = [&](const history_operation &hist, const operation &op) {
+                    operation_notification note(op);
+                    note.trx_id = hist.trx_id;
+                    note.block = hist.block;
+                    note.trx_in_block = hist.trx_in_block;
+                    note.op_in_trx = hist.op_in_trx;
+                    note.virtual_op = hist.virtual_op;
+                    _operation_history_time = hist.timestamp;
+                    handler(note);
+                    ++count;
+                };
+
+                const uint32_t batch_size = 10000;
+                auto read_batch = [this](uint32_t first, uint32_t last) {
+                    std::vector<replayed_operation> result;
+                    for (uint32_t block_num = first; block_num <= last; ++block_num) {
+                        for (auto &hist : _history_log.get_block_operations(block_num)) {
+                            replayed_operation r;
+                            r.op = fc::raw::unpack<operation>(hist.serialized_op);
+                            r.hist = std::move(hist);
+                            result.push_back(std::move(r));
+                        }
+                    }
+                    return result;
+                };
+
+                if (log_head > 0) {
+                    fc::thread reader("replay operation history");
+                    auto next = reader.async([&]() {
+                        return read_batch(1, std::min(batch_size, log_head));
+                    }, "read operation history");
+
+                    for (uint32_t first = 1; first <= log_head; first += batch_size) {
+                        auto batch = next.wait();
+
+                        // Read the next batch while this one is applied
+                        uint32_t next_first = first + batch_size;
+                        if (next_first <= log_head) {
+                            next = reader.async([&, next_first]() {
+                                return read_batch(next_first, std::min(next_first + batch_size - 1, log_head));
+                            }, "read operation history");
+                        }
+
+                        for (const auto &r : batch) {
+                            apply(r.hist, r.op);
+                        }
+
+                        if ((first / batch_size) % 100 == 0) {
+                            ilog("Replayed operation history up to block ${b} of ${h}", ("b", first)("h", log_head));
+                        }
+                    }
+                    reader.quit();
+                }
+
+                // Operations still in shared memory, in the order they were created in
+                for (auto itr = op_idx.begin(); itr != op_idx.end(); ++itr) {
+                    if (itr->block <= log_head) {
+                        continue;
+                    }
+
+                    history_operation hist;
+                    hist.trx_id = itr->trx_id;
+                    hist.block = itr->block;
+                    hist.trx_in_block = itr->trx_in_block;
+                    hist.op_in_trx = itr->op_in_trx;
+                    hist.virtual_op = itr->virtual_op;
+                    hist.timestamp = itr->timestamp;
+                    apply(hist, fc::raw::unpack<operation>(std::vector<char>(itr->serialized_op.begin(), itr->serialized_op.end())));
+                }
+
+                ilog("Replayed ${n} operations", ("n", count));
+            }
+            FC_CAPTURE_AND_RETHROW()
+        }
+
 //////////////////// private methods ////////////////////
 
         void database::apply_block(const signed_block &next_block, uint32_t skip) {
@@ -3040,6 +3677,11 @@ namespace steemit {
                     _apply_block(next_block);
                 });
 
+                if (_operation_profiling && _operation_profile_log_interval &&
+                    block_num % _operation_profile_log_interval == 0) {
+                    log_operation_profile();
+                }
+
                 /*try
    {
    /// check invariants
@@ -3069,6 +3711,7 @@ namespace steemit {
                     if (_next_flush_block == block_num) {
                         _next_flush_block = 0;
 //                        ilog("Flushing database shared memory at block ${b}", ("b", block_num));
+                        _content_store.flush();
                         chainbase::database::flush();
                     }
                 }
@@ -3084,6 +3727,20 @@ namespace steemit {
             } FC_CAPTURE_AND_RETHROW((next_block))
         }
 
+/**
+ * Runs the statement, recording how long it took as the given phase of the block being applied
+ */
+#define STEEMIT_PROFILE_BLOCK_PHASE(phase, statement) \
+            do { \
+                if (_block_profiler.enabled()) { \
+                    auto phase_start = fc::time_point::now(); \
+                    statement; \
+                    _block_profiler.record(block_phase::phase, fc::time_point::now() - phase_start); \
+                } else { \
+                    statement; \
+                } \
+            } while (0)
+
         void database::_apply_block(const signed_block &next_block) {
             try {
                 uint32_t next_block_num = next_block.block_num();
@@ -3091,7 +3748,21 @@ namespace steemit {
 
                 uint32_t skip = get_node_properties().skip_flags;
 
+                if (_block_profiler.enabled()) {
+                    _block_profiler.begin_block(next_block_num);
+                }
+
+                // Drop operations collected from a block which failed to apply
+                _block_operations.clear();
+                _pending_archived_votes.erase(_pending_archived_votes.lower_bound(next_block_num),
+                        _pending_archived_votes.end());
+                _applying_block = true;
+                auto applying_block_guard = fc::make_scoped_exit([this]() {
+                    _applying_block = false;
+                });
+
                 if (!(skip & skip_merkle_check)) {
+                    auto merkle_start = fc::time_point::now();
                     auto merkle_root = next_block.calculate_merkle_root();
 
                     try {
@@ -3107,13 +3778,21 @@ namespace steemit {
                             throw e;
                         }
                     }
+
+                    if (_block_profiler.enabled()) {
+                        _block_profiler.record(block_phase::merkle_check, fc::time_point::now() - merkle_start);
+                    }
                 }
 
-                const witness_object &signing_witness = validate_block_header(skip, next_block);
+                const witness_object *signing_witness = nullptr;
+                STEEMIT_PROFILE_BLOCK_PHASE(validate_block_header,
+                        signing_witness = &validate_block_header(skip, next_block));
 
                 _current_block_num = next_block_num;
                 _current_trx_in_block = 0;
 
+                auto header_start = fc::time_point::now();
+
                 const auto &gprops = get_dynamic_global_properties();
                 auto block_size = fc::raw::pack_size(next_block);
                 if (has_hardfork(STEEMIT_HARDFORK_0_12)) {
@@ -3141,49 +3820,67 @@ namespace steemit {
                     );
                 }
 
-                for (const auto &trx : next_block.transactions) {
-                    /* We do not need to push the undo state for each transaction
-       * because they either all apply and are valid or the
-       * entire block fails to apply.  We only need an "undo" state
-       * for transactions when validating broadcast transactions or
-       * when building a block.
-       */
-                    apply_transaction(trx, skip);
-                    ++_current_trx_in_block;
+                if (_block_profiler.enabled()) {
+                    auto trx_start = fc::time_point::now();
+                    _block_profiler.record(block_phase::process_header, trx_start - header_start);
+
+                    for (const auto &trx : next_block.transactions) {
+                        auto start = fc::time_point::now();
+                        apply_transaction(trx, skip);
+                        _block_profiler.record_transaction(fc::time_point::now() - start);
+                        ++_current_trx_in_block;
+                    }
+
+                    _block_profiler.record(block_phase::apply_transactions, fc::time_point::now() - trx_start);
+                } else {
+                    for (const auto &trx : next_block.transactions) {
+                        /* We do not need to push the undo state for each transaction
+           * because they either all apply and are valid or the
+           * entire block fails to apply.  We only need an "undo" state
+           * for transactions when validating broadcast transactions or
+           * when building a block.
+           */
+                        apply_transaction(trx, skip);
+                        ++_current_trx_in_block;
+                    }
                 }
 
-                update_global_dynamic_data(next_block);
-                update_signing_witness(signing_witness, next_block);
+                STEEMIT_PROFILE_BLOCK_PHASE(update_global_dynamic_data, update_global_dynamic_data(next_block));
+                STEEMIT_PROFILE_BLOCK_PHASE(update_signing_witness, update_signing_witness(*signing_witness, next_block));
 
-                update_last_irreversible_block();
+                STEEMIT_PROFILE_BLOCK_PHASE(update_last_irreversible_block, update_last_irreversible_block());
 
-                create_block_summary(next_block);
-                clear_expired_transactions();
-                clear_expired_orders();
-                update_witness_schedule();
+                STEEMIT_PROFILE_BLOCK_PHASE(create_block_summary, create_block_summary(next_block));
+                STEEMIT_PROFILE_BLOCK_PHASE(clear_expired_transactions, clear_expired_transactions());
+                STEEMIT_PROFILE_BLOCK_PHASE(clear_expired_orders, clear_expired_orders());
+                STEEMIT_PROFILE_BLOCK_PHASE(update_witness_schedule, update_witness_schedule());
 
-                update_median_feed();
-                update_virtual_supply();
+                STEEMIT_PROFILE_BLOCK_PHASE(update_median_feed, update_median_feed());
+                STEEMIT_PROFILE_BLOCK_PHASE(update_virtual_supply, update_virtual_supply());
 
-                clear_null_account_balance();
-                process_funds();
-                process_conversions();
-                process_comment_cashout();
-                process_vesting_withdrawals();
-                process_savings_withdraws();
-                pay_liquidity_reward();
-                update_virtual_supply();
+                STEEMIT_PROFILE_BLOCK_PHASE(clear_null_account_balance, clear_null_account_balance());
+                STEEMIT_PROFILE_BLOCK_PHASE(process_funds, process_funds());
+                STEEMIT_PROFILE_BLOCK_PHASE(process_conversions, process_conversions());
+                STEEMIT_PROFILE_BLOCK_PHASE(process_comment_cashout, process_comment_cashout());
+                STEEMIT_PROFILE_BLOCK_PHASE(process_vesting_withdrawals, process_vesting_withdrawals());
+                STEEMIT_PROFILE_BLOCK_PHASE(process_savings_withdraws, process_savings_withdraws());
+                STEEMIT_PROFILE_BLOCK_PHASE(pay_liquidity_reward, pay_liquidity_reward());
+                STEEMIT_PROFILE_BLOCK_PHASE(update_virtual_supply_after_payouts, update_virtual_supply());
 
-                account_recovery_processing();
-                expire_escrow_ratification();
-                process_decline_voting_rights();
+                STEEMIT_PROFILE_BLOCK_PHASE(account_recovery_processing, account_recovery_processing());
+                STEEMIT_PROFILE_BLOCK_PHASE(expire_escrow_ratification, expire_escrow_ratification());
+                STEEMIT_PROFILE_BLOCK_PHASE(process_decline_voting_rights, process_decline_voting_rights());
 
-                process_hardforks();
+                STEEMIT_PROFILE_BLOCK_PHASE(process_hardforks, process_hardforks());
 
                 // notify observers that the block has been applied
-                notify_applied_block(next_block);
+                STEEMIT_PROFILE_BLOCK_PHASE(notify_applied_block, notify_applied_block(next_block));
+
+                STEEMIT_PROFILE_BLOCK_PHASE(notify_changed_objects, notify_changed_objects());
 
-                notify_changed_objects();
+                if (_block_profiler.enabled()) {
+                    _block_profiler.end_block();
+                }
             } //FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
             FC_CAPTURE_LOG_AND_RETHROW((next_block.block_num()))
         }
@@ -3325,17 +4022,38 @@ namespace steemit {
 
                 if (!(skip &
                       (skip_transaction_signatures | skip_authority_check))) {
-                    auto get_active = [&](const string &name) { return authority(get<account_authority_object, by_account>(name).active); };
-                    auto get_owner = [&](const string &name) { return authority(get<account_authority_object, by_account>(name).owner); };
-                    auto get_posting = [&](const string &name) { return authority(get<account_authority_object, by_account>(name).posting); };
+                    auto authority_digest = get_required_authority_digest(trx);
+                    auto &verified_by_id = _verified_trx_cache.get<by_trx_id>();
+                    auto verified = verified_by_id.find(trx_id);
 
-                    try {
-                        trx.verify_authority(chain_id, get_active, get_owner, get_posting, STEEMIT_MAX_SIG_CHECK_DEPTH);
-                    }
-                    catch (protocol::tx_missing_active_auth &e) {
-                        if (get_shared_db_merkle().find(head_block_num() + 1) ==
-                            get_shared_db_merkle().end()) {
-                            throw e;
+                    if (!authority_digest.valid() ||
+                        verified == verified_by_id.end() ||
+                        verified->authority_digest != *authority_digest) {
+                        auto get_active = [&](const string &name) { return authority(get<account_authority_object, by_account>(name).active); };
+                        auto get_owner = [&](const string &name) { return authority(get<account_authority_object, by_account>(name).owner); };
+                        auto get_posting = [&](const string &name) { return authority(get<account_authority_object, by_account>(name).posting); };
+
+                        try {
+                            if (_current_trx_signature_keys != nullptr) {
+                                steemit::protocol::verify_authority(trx.operations, *_current_trx_signature_keys, get_active, get_owner, get_posting, STEEMIT_MAX_SIG_CHECK_DEPTH);
+                            } else {
+                                trx.verify_authority(chain_id, get_active, get_owner, get_posting, STEEMIT_MAX_SIG_CHECK_DEPTH);
+                            }
+
+                            if (authority_digest.valid()) {
+                                verified_transaction v{trx_id, *authority_digest, trx.expiration};
+                                if (verified == verified_by_id.end()) {
+                                    verified_by_id.insert(v);
+                                } else {
+                                    verified_by_id.replace(verified, v);
+                                }
+                            }
+                        }
+                        catch (protocol::tx_missing_active_auth &e) {
+                            if (get_shared_db_merkle().find(head_block_num() + 1) ==
+                                get_shared_db_merkle().end()) {
+                                throw e;
+                            }
                         }
                     }
                 }
@@ -3409,11 +4127,85 @@ namespace steemit {
             } FC_CAPTURE_AND_RETHROW((trx))
         }
 
+        optional<digest_type> database::get_required_authority_digest(const signed_transaction &trx) const {
+            flat_set<account_name_type> required;
+            vector<authority> other;
+            trx.get_required_authorities(required, required, required, other);
+
+            digest_type::encoder enc;
+            for (const auto &name : required) {
+                const auto *auth = find<account_authority_object, by_account>(name);
+                if (auth == nullptr) {
+                    return optional<digest_type>();
+                }
+
+                authority owner(auth->owner);
+                authority active(auth->active);
+                authority posting(auth->posting);
+
+                // Authorities delegated to other accounts depend on state which is not part of the digest
+                if (!owner.account_auths.empty() ||
+                    !active.account_auths.empty() ||
+                    !posting.account_auths.empty()) {
+                    return optional<digest_type>();
+                }
+
+                fc::raw::pack(enc, name);
+                fc::raw::pack(enc, owner);
+                fc::raw::pack(enc, active);
+                fc::raw::pack(enc, posting);
+            }
+            fc::raw::pack(enc, other);
+            fc::raw::pack(enc, trx.signatures);
+            return enc.result();
+        }
+
         void database::apply_operation(const operation &op) {
             operation_notification note(op);
+            if (!_operation_profiling) {
+                notify_pre_apply_operation(note);
+                _my->_evaluator_registry.get_evaluator(op).apply(op);
+                notify_post_apply_operation(note);
+                return;
+            }
+
+            auto &profile = get_operation_profile(op);
+            auto start = fc::time_point::now();
             notify_pre_apply_operation(note);
+            auto pre_applied = fc::time_point::now();
             _my->_evaluator_registry.get_evaluator(op).apply(op);
+            auto evaluated = fc::time_point::now();
             notify_post_apply_operation(note);
+            profile.pre_apply.add(pre_applied - start);
+            profile.evaluate.add(evaluated - pre_applied);
+            profile.post_apply.add(fc::time_point::now() - evaluated);
+        }
+
+        operation_profile &database::get_operation_profile(const operation &op) {
+            auto &profile = _my->_evaluator_registry.get_profile(op);
+            if (profile.name.empty()) {
+                op.visit(fc::get_operation_name(profile.name));
+            }
+            return profile;
+        }
+
+        vector<operation_profile_stats> database::get_operation_profile_stats() const {
+            return _my->_evaluator_registry.get_profile_stats();
+        }
+
+        void database::log_operation_profile() const {
+            auto stats = get_operation_profile_stats();
+            if (stats.size() > 10) {
+                stats.resize(10);
+            }
+
+            ilog("Operation profile at block ${b}:", ("b", head_block_num()));
+            for (const auto &s : stats) {
+                ilog("   ${name}: ${n} ops, ${t}ms total, evaluator avg ${e}us p99 ${e99}us, plugins avg ${p}us",
+                        ("name", s.name)("n", s.pre_apply.count)("t", s.total_us / 1000)
+                        ("e", s.evaluate.avg_us)("e99", s.evaluate.p99_us)
+                        ("p", s.pre_apply.avg_us + s.post_apply.avg_us));
+            }
         }
 
         const witness_object &database::validate_block_header(uint32_t skip, const signed_block &next_block) const {
@@ -3673,13 +4465,27 @@ namespace steemit {
                                     log_head_num + 1);
                             FC_ASSERT(block, "Current fork in the fork database does not contain the last_irreversible_block");
                             _block_log.append(block->data);
+                            if (_store_trx_index) {
+                                _trx_index_log.append(block->data);
+                            }
                             log_head_num++;
                         }
 
                         _block_log.flush();
+                        if (_store_trx_index) {
+                            _trx_index_log.flush();
+                        }
                     }
                 }
 
+                if (_store_account_history) {
+                    update_history_log();
+                }
+
+                if (_store_vote_archive) {
+                    update_vote_archive();
+                }
+
                 _fork_db.set_max_size(dpo.head_block_number -
                                       dpo.last_irreversible_block_num + 1);
             } FC_CAPTURE_AND_RETHROW()
@@ -3851,6 +4657,10 @@ namespace steemit {
                    (head_block_time() > dedupe_index.begin()->expiration)) {
                 remove(*dedupe_index.begin());
             }
+
+            auto &verified_by_expiration = _verified_trx_cache.get<by_expiration>();
+            verified_by_expiration.erase(verified_by_expiration.begin(),
+                    verified_by_expiration.lower_bound(head_block_time()));
         }
 
         void database::clear_expired_orders() {
@@ -4513,18 +5323,18 @@ namespace steemit {
                 if (itr->parent_author != STEEMIT_ROOT_POST_PARENT) {
 // Low memory nodes only need immediate child count, full nodes track total children
 #ifdef IS_LOW_MEM
-                    modify(get_comment(itr->parent_author, itr->parent_permlink), [&](comment_object &c) {
+                    modify(get_parent_comment(*itr), [&](comment_object &c) {
                         c.children++;
                     });
 #else
-                    const comment_object *parent = &get_comment(itr->parent_author, itr->parent_permlink);
+                    const comment_object *parent = &get_parent_comment(*itr);
                     while (parent) {
                         modify(*parent, [&](comment_object &c) {
                             c.children++;
                         });
 
                         if (parent->parent_author != STEEMIT_ROOT_POST_PARENT) {
-                            parent = &get_comment(parent->parent_author, parent->parent_permlink);
+                            parent = &get_parent_comment(*parent);
                         } else {
                             parent = nullptr;
                         }
@@ -0,0 +1,533 @@
+#include <steemit/chain/history_log.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <fstream>
+#include <mutex>
+
+#define HISTORY_RW (std::ios::in | std::ios::out | std::ios::binary)
+#define HISTORY_READ (std::ios::in | std::ios::binary)
+#define HISTORY_CREATE (std::ios::out | std::ios::binary | std::ios::trunc)
+
+namespace steemit {
+    namespace chain {
+
+        namespace detail {
+            struct history_log_header {
+                uint32_t head_block_num = 0;
+                uint64_t ops_size = 0;
+                uint64_t entries_size = 0;
+            };
+
+            struct history_log_slot {
+                uint64_t head = 0; ///< position + 1 of the last entry of the account
+                uint32_t count = 0;
+            };
+
+            struct history_log_entry {
+                uint32_t sequence = 0;
+                uint8_t op_type = 0;
+                uint64_t op_pos = 0;
+                uint64_t prev = 0;
+                uint64_t jump = 0;
+                uint32_t jump_sequence = 0;
+                uint64_t jump_types = 0; ///< types of the operations skipped by the jump
+            };
+
+            static const uint64_t header_size =
+                    sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t);
+            static const uint64_t slot_size = sizeof(uint64_t) + sizeof(uint32_t);
+            static const uint64_t entry_size =
+                    sizeof(uint32_t) + sizeof(uint8_t) + 3 * sizeof(uint64_t) +
+                    sizeof(uint32_t) + sizeof(uint64_t);
+
+            inline uint64_t type_bit(uint8_t op_type) {
+                return uint64_t(1) << op_type;
+            }
+
+            class history_log_impl {
+            public:
+                history_log_header header;
+                std::vector<history_log_slot> slots;
+                std::vector<uint32_t> dirty_slots;
+                uint32_t stored_slots = 0;
+
+                std::fstream main_stream;
+                mutable std::fstream ops_stream;
+                mutable std::fstream blocks_stream;
+                mutable std::fstream entries_stream;
+
+                fc::path main_file;
+                fc::path ops_file;
+                fc::path blocks_file;
+                fc::path entries_file;
+
+                bool read_only = false;
+
+                mutable std::mutex mutex;
+
+                template<typename T>
+                static void write_value(std::fstream &s, const T &v) {
+                    s.write((const char *)&v, sizeof(v));
+                }
+
+                template<typename T>
+                static void read_value(std::fstream &s, T &v) {
+                    s.read((char *)&v, sizeof(v));
+                }
+
+                void read_header() {
+                    main_stream.seekg(0);
+                    read_value(main_stream, header.head_block_num);
+                    read_value(main_stream, header.ops_size);
+                    read_value(main_stream, header.entries_size);
+                }
+
+                /**
+                 * A reader does not keep the slots in memory, the writer of another process keeps changing
+                 * them. It reads the header again before every lookup and each slot when it is needed.
+                 * Slots may be ahead of the header, but never point to data which was not flushed yet.
+                 */
+                void refresh() {
+                    if (read_only) {
+                        read_header();
+                    }
+                }
+
+                history_log_slot slot(uint32_t account) {
+                    if (!read_only) {
+                        return account < slots.size() ? slots[account] : history_log_slot();
+                    }
+
+                    history_log_slot result;
+                    uint64_t pos = header_size + uint64_t(account) * slot_size;
+                    if (pos + slot_size <= fc::file_size(main_file)) {
+                        main_stream.seekg(pos);
+                        read_value(main_stream, result.head);
+                        read_value(main_stream, result.count);
+                    }
+                    return result;
+                }
+
+                void write_header() {
+                    main_stream.seekp(0);
+                    write_value(main_stream, header.head_block_num);
+                    write_value(main_stream, header.ops_size);
+                    write_value(main_stream, header.entries_size);
+                }
+
+                void write_slot(uint32_t account) {
+                    main_stream.seekp(header_size + account * slot_size);
+                    write_value(main_stream, slots[account].head);
+                    write_value(main_stream, slots[account].count);
+                }
+
+                void write_entry(const history_log_entry &e) {
+                    entries_stream.seekp(header.entries_size);
+                    write_value(entries_stream, e.sequence);
+                    write_value(entries_stream, e.op_type);
+                    write_value(entries_stream, e.op_pos);
+                    write_value(entries_stream, e.prev);
+                    write_value(entries_stream, e.jump);
+                    write_value(entries_stream, e.jump_sequence);
+                    write_value(entries_stream, e.jump_types);
+                }
+
+                history_log_entry read_entry(uint64_t pos) const {
+                    history_log_entry e;
+                    entries_stream.seekg(pos);
+                    read_value(entries_stream, e.sequence);
+                    read_value(entries_stream, e.op_type);
+                    read_value(entries_stream, e.op_pos);
+                    read_value(entries_stream, e.prev);
+                    read_value(entries_stream, e.jump);
+                    read_value(entries_stream, e.jump_sequence);
+                    read_value(entries_stream, e.jump_types);
+                    return e;
+                }
+
+                uint64_t read_block_pos(uint32_t block_num) const {
+                    uint64_t pos;
+                    blocks_stream.seekg(uint64_t(block_num - 1) * sizeof(pos));
+                    read_value(blocks_stream, pos);
+                    return pos;
+                }
+
+                history_operation read_operation(uint64_t pos, uint64_t *next = nullptr) const {
+                    uint32_t size;
+                    ops_stream.seekg(pos);
+                    read_value(ops_stream, size);
+                    std::vector<char> data(size);
+                    ops_stream.read(data.data(), size);
+                    if (next) {
+                        *next = pos + sizeof(size) + size;
+                    }
+                    return fc::raw::unpack<history_operation>(data);
+                }
+
+                void create() {
+                    ilog("Creating account history log");
+                    header = history_log_header();
+                    slots.clear();
+                    dirty_slots.clear();
+                    stored_slots = 0;
+
+                    main_stream.open(main_file.generic_string().c_str(), HISTORY_CREATE);
+                    write_header();
+                    main_stream.close();
+
+                    for (const auto &f : {ops_file, blocks_file, entries_file}) {
+                        std::fstream s(f.generic_string().c_str(), HISTORY_CREATE);
+                    }
+                }
+
+                bool load() {
+                    if (!fc::exists(main_file) || !fc::exists(ops_file) ||
+                        !fc::exists(blocks_file) ||
+                        !fc::exists(entries_file)) {
+                        return false;
+                    }
+
+                    auto main_size = fc::file_size(main_file);
+                    if (main_size < header_size ||
+                        (main_size - header_size) % slot_size) {
+                        return false;
+                    }
+
+                    main_stream.open(main_file.generic_string().c_str(), HISTORY_RW);
+                    read_value(main_stream, header.head_block_num);
+                    read_value(main_stream, header.ops_size);
+                    read_value(main_stream, header.entries_size);
+
+                    stored_slots = (main_size - header_size) / slot_size;
+                    slots.resize(stored_slots);
+                    for (auto &slot : slots) {
+                        read_value(main_stream, slot.head);
+                        read_value(main_stream, slot.count);
+                    }
+                    main_stream.close();
+
+                    uint64_t blocks_size = uint64_t(header.head_block_num) * sizeof(uint64_t);
+                    auto entries_file_size = fc::file_size(entries_file);
+                    if (fc::file_size(ops_file) < header.ops_size ||
+                        fc::file_size(blocks_file) < blocks_size ||
+                        entries_file_size < header.entries_size) {
+                        wlog("Account history log files are truncated");
+                        return false;
+                    }
+
+                    entries_stream.open(entries_file.generic_string().c_str(), HISTORY_RW);
+
+                    // Slots can be flushed ahead of the header, so unwind every account which points
+                    // past the last entry covered by the header.
+                    for (uint32_t i = 0; i < slots.size(); ++i) {
+                        while (slots[i].head &&
+                               slots[i].head - 1 + entry_size >
+                               header.entries_size) {
+                            if (slots[i].head - 1 + entry_size >
+                                entries_file_size) {
+                                wlog("Account history slot points outside of entries file");
+                                entries_stream.close();
+                                return false;
+                            }
+                            auto e = read_entry(slots[i].head - 1);
+                            slots[i].head = e.sequence ? e.prev + 1 : 0;
+                            slots[i].count = e.sequence;
+                            dirty_slots.push_back(i);
+                        }
+                    }
+
+                    entries_stream.close();
+
+                    fc::resize_file(ops_file, header.ops_size);
+                    fc::resize_file(blocks_file, blocks_size);
+                    fc::resize_file(entries_file, header.entries_size);
+
+                    return true;
+                }
+            };
+        }
+
+        history_log::history_log()
+                : my(new detail::history_log_impl()) {
+        }
+
+        history_log::~history_log() {
+            if (is_open()) {
+                flush();
+            }
+        }
+
+        void history_log::open(const fc::path &file, bool read_only) {
+            try {
+                close();
+
+                my->main_file = file;
+                my->ops_file = fc::path(file.generic_string() + ".ops");
+                my->blocks_file = fc::path(file.generic_string() + ".blocks");
+                my->entries_file = fc::path(file.generic_string() + ".entries");
+                my->read_only = read_only;
+
+                if (read_only) {
+                    FC_ASSERT(fc::exists(my->main_file) && fc::exists(my->ops_file) &&
+                              fc::exists(my->blocks_file) && fc::exists(my->entries_file),
+                            "Account history log does not exist, it is created by the node writing the chain state");
+                } else if (!my->load()) {
+                    my->create();
+                }
+
+                for (auto *s : {&my->main_stream, &my->ops_stream, &my->blocks_stream, &my->entries_stream}) {
+                    s->exceptions(std::fstream::failbit | std::fstream::badbit);
+                }
+
+                auto mode = read_only ? HISTORY_READ : HISTORY_RW;
+                my->main_stream.open(my->main_file.generic_string().c_str(), mode);
+                my->ops_stream.open(my->ops_file.generic_string().c_str(), mode);
+                my->blocks_stream.open(my->blocks_file.generic_string().c_str(), mode);
+                my->entries_stream.open(my->entries_file.generic_string().c_str(), mode);
+
+                if (read_only) {
+                    my->read_header();
+                }
+
+                ilog("Account history log head block is ${n}", ("n", my->header.head_block_num));
+            }
+            FC_CAPTURE_AND_RETHROW((file)(read_only))
+        }
+
+        void history_log::close() {
+            if (is_open()) {
+                flush();
+            }
+            my.reset(new detail::history_log_impl());
+        }
+
+        bool history_log::is_open() const {
+            return my->entries_stream.is_open();
+        }
+
+        void history_log::append_block(uint32_t block_num,
+                const std::vector<std::pair<history_operation, std::vector<history_account_entry>>> &ops) {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                FC_ASSERT(!my->read_only, "Account history log is open read only");
+
+                FC_ASSERT(block_num > my->header.head_block_num, "Append to account history log occuring at wrong block.",
+                        ("block_num", block_num)("head", my->header.head_block_num));
+
+                my->blocks_stream.seekp(uint64_t(my->header.head_block_num) * sizeof(uint64_t));
+                for (uint32_t b = my->header.head_block_num + 1; b <= block_num; ++b) {
+                    detail::history_log_impl::write_value(my->blocks_stream, my->header.ops_size);
+                }
+
+                for (const auto &op : ops) {
+                    FC_ASSERT(op.first.block == block_num);
+
+                    auto packed = fc::raw::pack(op.first);
+                    uint32_t size = packed.size();
+                    uint64_t op_pos = my->header.ops_size;
+
+                    // The serialized operation starts with the tag of its type
+                    fc::unsigned_int op_type;
+                    fc::datastream<const char *> type_ds(op.first.serialized_op.data(), op.first.serialized_op.size());
+                    fc::raw::unpack(type_ds, op_type);
+                    FC_ASSERT(op_type.value < 64, "Operation type does not fit the type mask");
+
+                    my->ops_stream.seekp(op_pos);
+                    detail::history_log_impl::write_value(my->ops_stream, size);
+                    my->ops_stream.write(packed.data(), size);
+                    my->header.ops_size += sizeof(size) + size;
+
+                    for (const auto &entry : op.second) {
+                        if (entry.account >= my->slots.size()) {
+                            my->slots.resize(entry.account + 1);
+                        }
+                        auto &slot = my->slots[entry.account];
+
+                        if (entry.sequence < slot.count) {
+                            continue;
+                        }
+                        FC_ASSERT(entry.sequence == slot.count, "Account history sequence gap",
+                                ("account", entry.account)("sequence", entry.sequence)("expected", slot.count));
+
+                        detail::history_log_entry e;
+                        e.sequence = entry.sequence;
+                        e.op_type = op_type.value;
+                        e.op_pos = op_pos;
+
+                        if (slot.count == 0) {
+                            e.jump = my->header.entries_size;
+                        } else {
+                            auto prev = my->read_entry(slot.head - 1);
+                            auto prev_jump = my->read_entry(prev.jump);
+                            e.prev = slot.head - 1;
+                            if (prev.sequence - prev.jump_sequence ==
+                                prev.jump_sequence - prev_jump.jump_sequence) {
+                                e.jump = prev_jump.jump;
+                                e.jump_sequence = prev_jump.jump_sequence;
+                                e.jump_types = prev.jump_types |
+                                               detail::type_bit(prev.op_type) |
+                                               prev_jump.jump_types |
+                                               detail::type_bit(prev_jump.op_type);
+                            } else {
+                                e.jump = e.prev;
+                                e.jump_sequence = prev.sequence;
+                            }
+                        }
+
+                        my->write_entry(e);
+                        slot.head = my->header.entries_size + 1;
+                        slot.count++;
+                        my->header.entries_size += detail::entry_size;
+                        my->dirty_slots.push_back(entry.account);
+                    }
+                }
+
+                my->header.head_block_num = block_num;
+            }
+            FC_LOG_AND_RETHROW()
+        }
+
+        void history_log::flush() {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            if (my->read_only) {
+                return;
+            }
+
+            // Data must reach the disk before anything that points to it
+            my->ops_stream.flush();
+            my->blocks_stream.flush();
+            my->entries_stream.flush();
+
+            for (uint32_t i = my->stored_slots; i < my->slots.size(); ++i) {
+                my->write_slot(i);
+            }
+            my->stored_slots = my->slots.size();
+
+            for (auto account : my->dirty_slots) {
+                my->write_slot(account);
+            }
+            my->main_stream.flush();
+            my->dirty_slots.clear();
+
+            my->write_header();
+            my->main_stream.flush();
+        }
+
+        uint32_t history_log::head_block_num() const {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            if (is_open()) {
+                my->refresh();
+            }
+            return my->header.head_block_num;
+        }
+
+        std::vector<history_operation> history_log::get_block_operations(uint32_t block_num) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                std::vector<history_operation> result;
+
+                if (!is_open()) {
+                    return result;
+                }
+                my->refresh();
+                if (block_num == 0 || block_num > my->header.head_block_num) {
+                    return result;
+                }
+
+                uint64_t pos = my->read_block_pos(block_num);
+                uint64_t end = block_num == my->header.head_block_num
+                               ? my->header.ops_size
+                               : my->read_block_pos(block_num + 1);
+
+                while (pos < end) {
+                    result.push_back(my->read_operation(pos, &pos));
+                }
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((block_num))
+        }
+
+        uint32_t history_log::get_account_sequence(uint32_t account) const {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            if (!is_open()) {
+                return 0;
+            }
+            return my->slot(account).count;
+        }
+
+        std::map<uint32_t, history_operation> history_log::get_account_history(uint32_t account, uint32_t from, uint32_t limit) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                std::map<uint32_t, history_operation> result;
+
+                if (!is_open()) {
+                    return result;
+                }
+                const auto slot = my->slot(account);
+                if (slot.count == 0) {
+                    return result;
+                }
+
+                uint32_t start = std::min(from, slot.count - 1);
+                uint32_t stop = start > limit ? start - limit : 0;
+
+                auto e = my->read_entry(slot.head - 1);
+                while (e.sequence > start) {
+                    e = my->read_entry(e.jump_sequence >= start ? e.jump : e.prev);
+                }
+
+                while (true) {
+                    result[e.sequence] = my->read_operation(e.op_pos);
+                    if (e.sequence == stop) {
+                        break;
+                    }
+                    e = my->read_entry(e.prev);
+                }
+
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((account)(from)(limit))
+        }
+
+        std::map<uint32_t, history_operation> history_log::get_account_history_by_type(uint32_t account, uint64_t op_types, uint32_t from, uint32_t limit) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                std::map<uint32_t, history_operation> result;
+
+                if (!is_open() || limit == 0) {
+                    return result;
+                }
+                const auto slot = my->slot(account);
+                if (slot.count == 0) {
+                    return result;
+                }
+
+                uint32_t start = std::min(from, slot.count - 1);
+
+                auto e = my->read_entry(slot.head - 1);
+                while (e.sequence > start) {
+                    e = my->read_entry(e.jump_sequence >= start ? e.jump : e.prev);
+                }
+
+                while (true) {
+                    if (detail::type_bit(e.op_type) & op_types) {
+                        result[e.sequence] = my->read_operation(e.op_pos);
+                        if (result.size() == limit) {
+                            break;
+                        }
+                    }
+                    if (e.sequence == 0) {
+                        break;
+                    }
+                    // Only the operations between the entry and its jump target are skipped
+                    e = my->read_entry(e.jump_types & op_types ? e.prev : e.jump);
+                }
+
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((account)(op_types)(from)(limit))
+        }
+
+    }
+}
@@ -18,14 +18,18 @@ namespace steemit {
 
         using steemit::protocol::authority;
 
+        /**
+         * State of an account touched by consensus on every transaction. Rarely used state lives in the
+         * account_metadata_object, so this object has no dynamically allocated members and copying it into
+         * the undo state on every modify stays cheap.
+         */
         class account_object
                 : public object<account_object_type, account_object> {
         public:
             account_object() = delete;
 
             template<typename Constructor, typename Allocator>
-            account_object(Constructor &&c, allocator<Allocator> a)
-                    :json_metadata(a) {
+            account_object(Constructor &&c, allocator<Allocator> a) {
                 c(*this);
             };
 
@@ -33,20 +37,13 @@ namespace steemit {
 
             account_name_type name;
             public_key_type memo_key;
-            shared_string json_metadata;
             account_name_type proxy;
 
             time_point_sec last_account_update;
 
             time_point_sec created;
-            bool mined = true;
-            bool owner_challenged = false;
-            bool active_challenged = false;
-            time_point_sec last_owner_proved = time_point_sec::min();
-            time_point_sec last_active_proved = time_point_sec::min();
-            account_name_type recovery_account;
-            account_name_type reset_account = STEEMIT_NULL_ACCOUNT;
-            time_point_sec last_account_recovery;
+            bool owner_challenged = false; ///< checked by every posting operation
+            bool active_challenged = false; ///< checked by every transfer
             uint32_t comment_count = 0;
             uint32_t lifetime_vote_count = 0;
             uint32_t post_count = 0;
@@ -116,6 +113,33 @@ namespace steemit {
             }
         };
 
+        /**
+         * Rarely used state of an account: its metadata, how it was created and its recovery settings.
+         */
+        class account_metadata_object
+                : public object<account_metadata_object_type, account_metadata_object> {
+        public:
+            account_metadata_object() = delete;
+
+            template<typename Constructor, typename Allocator>
+            account_metadata_object(Constructor &&c, allocator<Allocator> a)
+                    : json_metadata(a) {
+                c(*this);
+            }
+
+            id_type id;
+
+            account_name_type account;
+            shared_string json_metadata;
+
+            bool mined = true;
+            time_point_sec last_owner_proved = time_point_sec::min();
+            time_point_sec last_active_proved = time_point_sec::min();
+            account_name_type recovery_account;
+            account_name_type reset_account = STEEMIT_NULL_ACCOUNT;
+            time_point_sec last_account_recovery;
+        };
+
         class account_authority_object
                 : public object<account_authority_object_type, account_authority_object> {
         public:
@@ -311,6 +335,18 @@ namespace steemit {
         >
         owner_authority_history_index;
 
+        typedef multi_index_container<
+                account_metadata_object,
+                indexed_by<
+                        ordered_unique<tag<by_id>,
+                                member<account_metadata_object, account_metadata_id_type, &account_metadata_object::id>>,
+                        ordered_unique<tag<by_account>,
+                                member<account_metadata_object, account_name_type, &account_metadata_object::account>>
+                >,
+                allocator<account_metadata_object>
+        >
+        account_metadata_index;
+
         struct by_last_owner_update;
 
         typedef multi_index_container<
@@ -415,9 +451,9 @@ namespace steemit {
 }
 
 FC_REFLECT(steemit::chain::account_object,
-        (id)(name)(memo_key)(json_metadata)(proxy)(last_account_update)
-                (created)(mined)
-                (owner_challenged)(active_challenged)(last_owner_proved)(last_active_proved)(recovery_account)(last_account_recovery)(reset_account)
+        (id)(name)(memo_key)(proxy)(last_account_update)
+                (created)
+                (owner_challenged)(active_challenged)
                 (comment_count)(lifetime_vote_count)(post_count)(can_vote)(voting_power)(last_vote_time)
                 (balance)
                 (savings_balance)
@@ -431,6 +467,11 @@ FC_REFLECT(steemit::chain::account_object,
 )
 CHAINBASE_SET_INDEX_TYPE(steemit::chain::account_object, steemit::chain::account_index)
 
+FC_REFLECT(steemit::chain::account_metadata_object,
+        (id)(account)(json_metadata)(mined)(last_owner_proved)(last_active_proved)(recovery_account)(reset_account)(last_account_recovery)
+)
+CHAINBASE_SET_INDEX_TYPE(steemit::chain::account_metadata_object, steemit::chain::account_metadata_index)
+
 FC_REFLECT(steemit::chain::account_authority_object,
         (id)(account)(owner)(active)(posting)(last_owner_update)
 )
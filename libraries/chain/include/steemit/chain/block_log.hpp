@@ -55,6 +55,12 @@ namespace steemit {
 
             optional <signed_block> read_block_by_num(uint32_t block_num) const;
 
+            /**
+             * Return the fc::raw encoding of up to count blocks starting at block_num as they are stored in the
+             * log, without deserializing them. Stops at the head of the log.
+             */
+            std::vector<std::vector<char>> read_raw_blocks(uint32_t block_num, uint32_t count) const;
+
             /**
              * Return offset of block in file, or block_log::npos if it does not exist.
              */
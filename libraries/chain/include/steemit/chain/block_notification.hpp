@@ -0,0 +1,54 @@
+#pragma once
+
+#include <steemit/protocol/block.hpp>
+
+#include <steemit/chain/global_property_object.hpp>
+
+namespace steemit {
+    namespace chain {
+
+        /**
+         * An operation applied as part of a block, including virtual operations.
+         */
+        struct block_operation {
+            transaction_id_type trx_id;
+            uint32_t trx_in_block = 0;
+            uint16_t op_in_trx = 0;
+            bool virtual_op = false;
+            operation op;
+            flat_set<account_name_type> impacted; ///< accounts impacted by the operation, not serialized
+        };
+
+        /**
+         * Everything a plugin needs to process a block without looking at the chain state, which may
+         * have moved on by the time the notification is processed: the block, all operations it applied
+         * in order and the global properties right after it was applied.
+         */
+        struct block_notification {
+            signed_block block;
+            dynamic_global_property_object props;
+            std::vector<block_operation> operations;
+        };
+
+        /**
+         * Ids of the objects of one type which a block created, modified and removed, taken from the
+         * undo state of the block.
+         */
+        struct changed_object_ids {
+            uint16_t type = 0; ///< object_type of the objects
+            std::vector<int64_t> created;
+            std::vector<int64_t> modified;
+            std::vector<int64_t> removed;
+        };
+
+        struct changed_objects_notification {
+            uint32_t block_num = 0;
+            std::vector<changed_object_ids> objects; ///< only types with changes
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::chain::block_operation, (trx_id)(trx_in_block)(op_in_trx)(virtual_op)(op))
+FC_REFLECT(steemit::chain::changed_object_ids, (type)(created)(modified)(removed))
+FC_REFLECT(steemit::chain::changed_objects_notification, (block_num)(objects))
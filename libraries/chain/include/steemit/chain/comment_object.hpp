@@ -5,6 +5,7 @@
 
 #include <steemit/chain//steem_object_types.hpp>
 #include <steemit/chain/witness_objects.hpp>
+#include <steemit/chain/interned_string_object.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
 
@@ -12,25 +13,6 @@
 namespace steemit {
     namespace chain {
 
-        struct strcmp_less {
-            bool operator()(const shared_string &a, const shared_string &b) const {
-                return less(a.c_str(), b.c_str());
-            }
-
-            bool operator()(const shared_string &a, const string &b) const {
-                return less(a.c_str(), b.c_str());
-            }
-
-            bool operator()(const string &a, const shared_string &b) const {
-                return less(a.c_str(), b.c_str());
-            }
-
-        private:
-            inline bool less(const char *a, const char *b) const {
-                return std::strcmp(a, b) < 0;
-            }
-        };
-
         /**
          *  Used to track the trending categories
          */
@@ -40,14 +22,13 @@ namespace steemit {
             category_object() = delete;
 
             template<typename Constructor, typename Allocator>
-            category_object(Constructor &&c, allocator <Allocator> a)
-                    :name(a) {
+            category_object(Constructor &&c, allocator <Allocator> a) {
                 c(*this);
             }
 
             id_type id;
 
-            shared_string name;
+            interned_string_id_type name;
             share_type abs_rshares;
             asset total_payouts = asset(0, SBD_SYMBOL);
             uint32_t discussions = 0;
@@ -63,7 +44,7 @@ namespace steemit {
         indexed_by<
                 ordered_unique < tag <
                 by_id>, member<category_object, category_id_type, &category_object::id>>,
-        ordered_unique <tag<by_name>, member<category_object, shared_string, &category_object::name>, strcmp_less>,
+        ordered_unique <tag<by_name>, member<category_object, interned_string_id_type, &category_object::name>>,
         ordered_unique <tag<by_rshares>,
         composite_key<category_object,
                 member <
@@ -106,22 +87,20 @@ namespace steemit {
 
             template<typename Constructor, typename Allocator>
             comment_object(Constructor &&c, allocator <Allocator> a)
-                    :category(a), parent_permlink(a), permlink(a), title(a),
-                     body(a), json_metadata(a) {
+                    :permlink(a) {
                 c(*this);
             }
 
             id_type id;
 
-            shared_string category;
+            interned_string_id_type category;
             account_name_type parent_author;
-            shared_string parent_permlink;
+            interned_string_id_type parent_permlink; ///< the permlink of the parent, or the category of a root post
+            id_type parent_comment; ///< the comment a reply was made to, unset for root posts
             account_name_type author;
             shared_string permlink;
 
-            shared_string title;
-            shared_string body;
-            shared_string json_metadata;
+            uint64_t content = 0; ///< handle of title, body and json_metadata in the content_store, 0 if empty
             time_point_sec last_update;
             time_point_sec created;
             time_point_sec active; ///< the last time this post was "touched" by voting or reply
@@ -290,10 +269,10 @@ namespace steemit {
         composite_key<comment_object,
                 member <
                 comment_object, account_name_type, &comment_object::parent_author>,
-        member<comment_object, shared_string, &comment_object::parent_permlink>,
+        member<comment_object, interned_string_id_type, &comment_object::parent_permlink>,
         member<comment_object, comment_id_type, &comment_object::id>
         >,
-        composite_key_compare <std::less<account_name_type>, strcmp_less, std::less<comment_id_type>>
+        composite_key_compare <std::less<account_name_type>, std::less<interned_string_id_type>, std::less<comment_id_type>>
         >
         /// NON_CONSENSUS INDICIES - used by APIs
 #ifndef IS_LOW_MEM
@@ -329,8 +308,8 @@ FC_REFLECT_ENUM(steemit::chain::comment_mode, (first_payout)(second_payout)(arch
 
 FC_REFLECT(steemit::chain::comment_object,
         (id)(author)(permlink)
-                (category)(parent_author)(parent_permlink)
-                (title)(body)(json_metadata)(last_update)(created)(active)(last_payout)
+                (category)(parent_author)(parent_permlink)(parent_comment)
+                (content)(last_update)(created)(active)(last_payout)
                 (depth)(children)(children_rshares2)
                 (net_rshares)(abs_rshares)(vote_rshares)
                 (children_abs_rshares)(cashout_time)(max_cashout_time)
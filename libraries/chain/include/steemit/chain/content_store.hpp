@@ -0,0 +1,84 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <memory>
+#include <string>
+
+namespace steemit {
+    namespace chain {
+
+        namespace detail { class content_store_impl; }
+
+        /**
+         * Text of a comment which consensus never looks at after the comment operation has been
+         * evaluated.
+         */
+        struct comment_content {
+            std::string title;
+            std::string body;
+            std::string json_metadata;
+        };
+
+        /* The content store keeps the text of comments out of the shared memory file. It is a single
+         * append only, memory mapped file:
+         *
+         * +------------+--------+-------------------+--------+-------------------+-----+
+         * | End Offset | Size 1 | Packed Content 1  | Size 2 | Packed Content 2  | ... |
+         * +------------+--------+-------------------+--------+-------------------+-----+
+         *
+         * Every edit of a comment appends a new record and the comment_object stores the offset of
+         * its latest record, so the undo history of the chain state rolls content back together with
+         * everything else. Records orphaned by edits or popped blocks are never reclaimed, the file is
+         * recreated on replay instead.
+         *
+         * The file is grown in large steps and remapped, the end offset in the header marks how far
+         * it has been written.
+         */
+        class content_store {
+        public:
+            content_store();
+
+            ~content_store();
+
+            /**
+             * @param read_only the file is neither created nor grown, and content written by another process
+             * after it was opened is still read
+             */
+            void open(const fc::path &file, bool read_only = false);
+
+            void close();
+
+            bool is_open() const;
+
+            /**
+             * Drop all content, used when the chain state is initialized from genesis.
+             */
+            void reset();
+
+            /**
+             * Store the content and return the handle to read it back with, which is never 0.
+             */
+            uint64_t append(const comment_content &content);
+
+            /**
+             * Read content by handle, 0 reads as empty content.
+             */
+            comment_content read(uint64_t handle) const;
+
+            /**
+             * Read only the json_metadata of the content, without copying its title and body.
+             */
+            std::string read_json_metadata(uint64_t handle) const;
+
+            void flush();
+
+        private:
+            std::unique_ptr<detail::content_store_impl> my;
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::chain::comment_content, (title)(body)(json_metadata))
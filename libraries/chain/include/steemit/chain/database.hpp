@@ -8,6 +8,12 @@
 #include <steemit/chain/node_property_object.hpp>
 #include <steemit/chain/fork_database.hpp>
 #include <steemit/chain/block_log.hpp>
+#include <steemit/chain/transaction_index_log.hpp>
+#include <steemit/chain/profiler.hpp>
+#include <steemit/chain/content_store.hpp>
+#include <steemit/chain/history_log.hpp>
+#include <steemit/chain/vote_archive.hpp>
+#include <steemit/chain/block_notification.hpp>
 
 #include <steemit/protocol/protocol.hpp>
 
@@ -15,6 +21,7 @@
 
 #include <fc/log/logger.hpp>
 
+#include <atomic>
 #include <map>
 
 namespace steemit {
@@ -33,6 +40,18 @@ namespace steemit {
 
         struct operation_notification;
 
+        struct by_trx_id;
+        struct by_expiration;
+
+        /**
+         * A transaction which passed database::precheck_transaction(), together with the keys recovered from its
+         * signatures, so they do not have to be recovered again under the write lock.
+         */
+        struct prechecked_transaction {
+            signed_transaction trx;
+            flat_set<public_key_type> signature_keys;
+        };
+
         /**
          *   @class database
          *   @brief tracks the blockchain state in an extensible manner
@@ -133,10 +152,36 @@ namespace steemit {
 
             optional<signed_block> fetch_block_by_number(uint32_t num) const;
 
+            /**
+             * The log of irreversible blocks, which may be read without holding the database lock.
+             */
+            const block_log &get_block_log() const;
+
             const signed_transaction get_recent_transaction(const transaction_id_type &trx_id) const;
 
+            /**
+             * Look up the location of an irreversible transaction in the on-disk transaction index.
+             * Returns an empty optional if the index is disabled or the transaction is unknown.
+             */
+            optional<transaction_location> find_transaction_location(const transaction_id_type &trx_id) const;
+
             std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
 
+            /**
+             * Title, body and json_metadata of a comment are kept in the content store rather than in
+             * the comment_object, which only holds a handle to them.
+             */
+            comment_content get_comment_content(const comment_object &comment) const;
+
+            std::string get_comment_json_metadata(const comment_object &comment) const;
+
+            /**
+             * Append the content to the content store, the returned handle should be assigned to
+             * comment_object::content. Content which is no longer referenced after an undo stays in
+             * the store.
+             */
+            uint64_t store_comment_content(const comment_content &content);
+
             chain_id_type get_chain_id() const;
 
 
@@ -148,6 +193,8 @@ namespace steemit {
 
             const account_object *find_account(const account_name_type &name) const;
 
+            const account_metadata_object &get_account_metadata(const account_name_type &name) const;
+
             const comment_object &get_comment(const account_name_type &author, const shared_string &permlink) const;
 
             const comment_object *find_comment(const account_name_type &author, const shared_string &permlink) const;
@@ -156,9 +203,26 @@ namespace steemit {
 
             const comment_object *find_comment(const account_name_type &author, const string &permlink) const;
 
-            const category_object &get_category(const shared_string &name) const;
+            /**
+             * Categories are looked up by the interned string comment_object::category refers to.
+             */
+            const category_object &get_category(const interned_string_id_type &name) const;
+
+            const category_object *find_category(const interned_string_id_type &name) const;
+
+            /**
+             * Return the id of the interned string with this value, interning it first if it is new.
+             */
+            interned_string_id_type intern_string(const string &value);
 
-            const category_object *find_category(const shared_string &name) const;
+            const interned_string_object *find_interned_string(const string &value) const;
+
+            const shared_string &get_interned_string(const interned_string_id_type &id) const;
+
+            /**
+             * Return the comment a reply was made to.
+             */
+            const comment_object &get_parent_comment(const comment_object &comment) const;
 
             const escrow_object &get_escrow(const account_name_type &name, uint32_t escrow_id) const;
 
@@ -217,6 +281,22 @@ namespace steemit {
 
             void push_transaction(const signed_transaction &trx, uint32_t skip = skip_nothing);
 
+            /**
+             * Run the checks which do not modify chain state: validation, size limit, expiration, TaPoS
+             * and signature recovery. Takes only the read lock and may be called from any thread.
+             *
+             * @param skip the flags the transaction is going to be pushed with, checks they skip are skipped here
+             * @return keys recovered from the transaction signatures, empty if signatures are skipped
+             */
+            flat_set<public_key_type> precheck_transaction(const signed_transaction &trx, uint32_t skip = skip_nothing);
+
+            /**
+             * Push a batch of prechecked transactions under a single write lock acquisition.
+             *
+             * @return for every transaction, the exception it was rejected with, if any
+             */
+            vector<fc::exception_ptr> push_transactions(const vector<prechecked_transaction> &trxs, uint32_t skip = skip_nothing);
+
             void _maybe_warn_multiple_production(uint32_t height) const;
 
             bool _push_block(const signed_block &b);
@@ -253,6 +333,8 @@ namespace steemit {
             inline const void push_virtual_operation(const operation &op, bool force = false); // vops are not needed for low mem. Force will push them on low mem.
             void notify_applied_block(const signed_block &block);
 
+            void notify_popped_block(const signed_block &block);
+
             void notify_on_pending_transaction(const signed_transaction &tx);
 
             void notify_on_applied_transaction(const signed_transaction &tx);
@@ -273,6 +355,37 @@ namespace steemit {
              */
             fc::signal<void(const signed_block &)> applied_block;
 
+            /**
+             *  Emitted right after applied_block with the operations of the block, only when block
+             *  operations are collected (see set_collect_block_operations()). The notification is
+             *  self-contained, so it may be handed over to another thread.
+             */
+            fc::signal<void(const block_notification &)> applied_block_operations;
+
+            /**
+             *  Emitted when a block is popped from the head of the chain, e.g. when switching forks.
+             *  Blocks are always popped in the reverse order they were applied in.
+             */
+            fc::signal<void(const signed_block &)> popped_block;
+
+            /**
+             *  Emitted once per applied block, after applied_block, with the ids of all objects the block
+             *  created, modified and removed. Nothing is collected while there are no listeners.
+             */
+            fc::signal<void(const changed_objects_notification &)> changed_objects;
+
+            /**
+             * Collect the operations of every applied block for the applied_block_operations signal. Every
+             * listener asks for collection separately, each call with true must be followed by one with false.
+             */
+            void set_collect_block_operations(bool collect) {
+                if (collect) {
+                    ++_block_operation_collectors;
+                } else {
+                    --_block_operation_collectors;
+                }
+            }
+
             /**
              * This signal is emitted any time a new transaction is added to the pending
              * block state.
@@ -509,6 +622,83 @@ namespace steemit {
 
             void set_flush_interval(uint32_t flush_blocks);
 
+            /**
+             * Enable the on-disk transaction id index. Must be called before open().
+             */
+            void set_store_transaction_index(bool store_trx_index);
+
+            /**
+             * Move operation_objects and account_history_objects of irreversible blocks out of shared
+             * memory into the on-disk history log. Must be called before open().
+             */
+            void set_store_account_history(bool store_account_history);
+
+            bool store_account_history() const {
+                return _store_account_history;
+            }
+
+            const history_log &get_history_log() const {
+                return _history_log;
+            }
+
+            /**
+             * Record that operations are left out of the stored history, which then can't be replayed.
+             */
+            void set_operation_history_filtered(bool filtered);
+
+            /**
+             * Move the votes of comments which can no longer be paid out, which consensus removes from shared
+             * memory, to the on-disk vote archive instead of dropping them. Must be called before open().
+             */
+            void set_store_vote_archive(bool store_vote_archive);
+
+            bool store_vote_archive() const {
+                return _store_vote_archive;
+            }
+
+            /**
+             * Return the archived votes of a comment, including those archived by reversible blocks.
+             */
+            std::vector<archived_vote> get_archived_comment_votes(const comment_id_type &comment) const;
+
+            /**
+             * Return the archived votes of an account, including those archived by reversible blocks.
+             */
+            std::vector<archived_vote> get_archived_account_votes(const account_id_type &voter) const;
+
+            /**
+             * Feed the stored operation history, oldest first, to a plugin rebuilding its indexes. Operations of
+             * blocks in the history log are read and unpacked ahead on a separate thread, the remaining ones come
+             * from operation_objects. While the handler runs, head_block_time() returns the time the operation was
+             * applied at.
+             *
+             * Must be called with the write lock held and outside of any undo session. Throws if the history is
+             * filtered, see set_operation_history_filtered().
+             */
+            void replay_operation_history(const std::function<void(const operation_notification &)> &handler);
+
+            /**
+             * Time every phase of block application. Blocks taking longer than slow_block_ms are logged
+             * with their breakdown, zero disables the log.
+             */
+            void set_block_profiling(bool enabled, uint32_t slow_block_ms);
+
+            const block_profiler &get_block_profiler() const;
+
+            /**
+             * Time evaluators and plugin operation handlers per operation type. The profile of the most
+             * expensive operation types is logged every log_interval_blocks blocks, zero disables the log.
+             */
+            void set_operation_profiling(bool enabled, uint32_t log_interval_blocks);
+
+            vector<operation_profile_stats> get_operation_profile_stats() const;
+
+            /**
+             * Limit the number and total packed size of pending transactions. When the pool is full, the oldest
+             * pending transactions are dropped to make room for a new one. Zero means no limit.
+             */
+            void set_pending_transactions_limit(uint32_t max_count, uint64_t max_size);
+
 #ifdef STEEMIT_BUILD_TESTNET
             bool liquidity_rewards_enabled = true;
             bool skip_price_feed_limit_check = true;
@@ -572,12 +762,84 @@ namespace steemit {
             std::unique_ptr<database_impl> _my;
 
             vector<signed_transaction> _pending_tx;
+            uint64_t _pending_tx_size = 0;
+            uint32_t _pending_tx_skip_flags = 0; ///< union of skip flags pending transactions were applied with
+            uint32_t _max_pending_tx_count = 0;
+            uint64_t _max_pending_tx_size = 0;
+
+            /**
+             * Transactions whose signatures were checked against the authorities of the accounts they require.
+             * While those authorities stay the same, the transaction does not need to be verified again when
+             * it is re-applied to the pending state or included into a block.
+             */
+            struct verified_transaction {
+                transaction_id_type trx_id;
+                digest_type authority_digest;
+                fc::time_point_sec expiration;
+            };
+
+            typedef boost::multi_index_container<
+                    verified_transaction,
+                    boost::multi_index::indexed_by<
+                            boost::multi_index::ordered_unique<boost::multi_index::tag<by_trx_id>,
+                                    boost::multi_index::member<verified_transaction, transaction_id_type, &verified_transaction::trx_id>>,
+                            boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_expiration>,
+                                    boost::multi_index::member<verified_transaction, fc::time_point_sec, &verified_transaction::expiration>>
+                    >
+            > verified_transaction_cache;
+
+            verified_transaction_cache _verified_trx_cache;
+
+            /// signature keys of the transaction being pushed by push_transactions(), if already recovered
+            const flat_set<public_key_type> *_current_trx_signature_keys = nullptr;
+
+            optional<digest_type> get_required_authority_digest(const signed_transaction &trx) const;
+
+            /**
+             * Drop the oldest pending transactions if trx would not fit into the pending transaction pool.
+             * The state of the remaining pending transactions is rebuilt.
+             */
+            void make_room_for_pending_transaction(const signed_transaction &trx);
+
             fork_database _fork_db;
             fc::time_point_sec _hardfork_times[STEEMIT_NUM_HARDFORKS + 1];
             protocol::hardfork_version _hardfork_versions[
                     STEEMIT_NUM_HARDFORKS + 1];
 
             block_log _block_log;
+            transaction_index_log _trx_index_log;
+            content_store _content_store;
+            history_log _history_log;
+            block_profiler _block_profiler;
+            bool _operation_profiling = false;
+            uint32_t _operation_profile_log_interval = 0;
+
+            operation_profile &get_operation_profile(const operation &op);
+
+            void log_operation_profile() const;
+            bool _store_trx_index = false;
+
+            void update_transaction_index();
+
+            bool _store_account_history = false;
+
+            std::atomic<uint32_t> _block_operation_collectors{0};
+            bool _applying_block = false;
+            std::vector<block_operation> _block_operations;
+
+            void update_history_log();
+
+            bool _store_vote_archive = false;
+            vote_archive _vote_archive;
+
+            /// Votes removed by reversible blocks, by block number
+            std::map<uint32_t, std::vector<archived_vote>> _pending_archived_votes;
+
+            void update_vote_archive();
+
+            bool _operation_history_filtered = false;
+            bool _replaying_operation_history = false;
+            time_point_sec _operation_history_time;
 
             // this function needs access to _plugin_index_signal
             template<typename MultiIndexType>
@@ -62,7 +62,12 @@ namespace steemit {
                         }
                     }
                     _db._popped_tx.clear();
+                    auto now = _db.head_block_time();
                     for (const signed_transaction &tx : _pending_transactions) {
+                        // Drop expired transactions without paying for a failed re-application
+                        if (tx.expiration < now) {
+                            continue;
+                        }
                         try {
                             if (!_db.is_known_transaction(tx.id())) {
                                 // since push_transaction() takes a signed_transaction,
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <steemit/chain/evaluator.hpp>
+#include <steemit/chain/profiler.hpp>
+
+#include <algorithm>
 
 namespace steemit {
     namespace chain {
@@ -13,6 +16,7 @@ namespace steemit {
                 for (int i = 0; i < OperationType::count(); i++) {
                     _op_evaluators.emplace_back();
                 }
+                _op_profiles.resize(OperationType::count());
             }
 
             template<typename EvaluatorType, typename... Args>
@@ -35,7 +39,29 @@ namespace steemit {
                 return *eval;
             }
 
+            operation_profile &get_profile(const OperationType &op) {
+                return _op_profiles[op.which()];
+            }
+
+            /**
+             * @return profiles of all operation types seen so far, most expensive first
+             */
+            std::vector<operation_profile_stats> get_profile_stats() const {
+                std::vector<operation_profile_stats> result;
+                for (const auto &profile : _op_profiles) {
+                    if (profile.pre_apply.count() || profile.evaluate.count()) {
+                        result.push_back(profile.get_stats());
+                    }
+                }
+                std::sort(result.begin(), result.end(),
+                        [](const operation_profile_stats &a, const operation_profile_stats &b) {
+                            return a.total_us > b.total_us;
+                        });
+                return result;
+            }
+
             std::vector<std::unique_ptr<evaluator<OperationType>>> _op_evaluators;
+            std::vector<operation_profile> _op_profiles;
             database &_db;
         };
 
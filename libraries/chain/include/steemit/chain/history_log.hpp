@@ -0,0 +1,122 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <steemit/protocol/operations.hpp>
+
+#include <map>
+
+namespace steemit {
+    namespace chain {
+
+        using namespace steemit::protocol;
+
+        namespace detail { class history_log_impl; }
+
+        /**
+         * An operation as it is stored in the history log, mirrors operation_object.
+         */
+        struct history_operation {
+            transaction_id_type trx_id;
+            uint32_t block = 0;
+            uint32_t trx_in_block = 0;
+            uint16_t op_in_trx = 0;
+            uint64_t virtual_op = 0;
+            time_point_sec timestamp;
+            std::vector<char> serialized_op;
+        };
+
+        /**
+         * Position of an operation in the history of an account.
+         */
+        struct history_account_entry {
+            uint32_t account = 0; ///< instance of the account_id_type
+            uint32_t sequence = 0;
+        };
+
+        /* The history log holds the account history of irreversible blocks on disk, so only the
+         * operations of reversible blocks have to be kept as operation_objects in shared memory.
+         * It consists of four files:
+         *
+         * The operations file is append only and holds the packed operations, each prefixed with
+         * its size. Operations of a block are contiguous.
+         *
+         * The blocks file holds one 8 byte position into the operations file per block, where the
+         * operations of that block start.
+         *
+         * The entries file is append only and holds one fixed size record per operation and impacted
+         * account:
+         *
+         * +----------+---------+--------+-------------+-------------+------------------+---------------+
+         * | Sequence | Op Type | Op Pos | Prev Record | Jump Record | Sequence of Jump | Skipped Types | ...
+         * +----------+---------+--------+-------------+-------------+------------------+---------------+
+         *
+         * Records of an account form a list going backwards through the file. Jump pointers form a
+         * skew binary skip list over it, so any sequence number of an account can be found in a
+         * logarithmic number of reads. Each jump also carries the mask of operation types it jumps
+         * over, so a search for some operation types skips whole ranges without matches.
+         *
+         * The main file holds a header (last block, sizes of the other files) followed by one slot
+         * per account id with the position + 1 of the last record of the account and the number of
+         * records. Slots are kept in memory while the log is open and written back on flush().
+         * Anything written after the last flush is discarded on open. A log opened read only reads
+         * the header and slots from the main file on every lookup instead.
+         */
+        class history_log {
+        public:
+            history_log();
+
+            ~history_log();
+
+            /**
+             * @param read_only the log is only read, while the node writing the chain state of another
+             * process keeps appending to it
+             */
+            void open(const fc::path &file, bool read_only = false);
+
+            void close();
+
+            bool is_open() const;
+
+            /**
+             * Append all operations of a block. Blocks must be appended in order, blocks which are
+             * skipped are recorded as having no operations.
+             */
+            void append_block(uint32_t block_num,
+                    const std::vector<std::pair<history_operation, std::vector<history_account_entry>>> &ops);
+
+            void flush();
+
+            /**
+             * Return number of the last block in the log, or 0 if the log is empty.
+             */
+            uint32_t head_block_num() const;
+
+            std::vector<history_operation> get_block_operations(uint32_t block_num) const;
+
+            /**
+             * Return number of operations of the account in the log, which is also the sequence
+             * the next operation of the account gets.
+             */
+            uint32_t get_account_sequence(uint32_t account) const;
+
+            /**
+             * Return up to limit + 1 operations of the account, starting with the sequence from and
+             * going backwards.
+             */
+            std::map<uint32_t, history_operation> get_account_history(uint32_t account, uint32_t from, uint32_t limit) const;
+
+            /**
+             * Return up to limit operations of the account with a type in the op_types mask (bit n set
+             * for operation::tag n), starting with the sequence from and going backwards.
+             */
+            std::map<uint32_t, history_operation> get_account_history_by_type(uint32_t account, uint64_t op_types, uint32_t from, uint32_t limit) const;
+
+        private:
+            std::unique_ptr<detail::history_log_impl> my;
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::chain::history_operation, (trx_id)(block)(trx_in_block)(op_in_trx)(virtual_op)(timestamp)(serialized_op))
+FC_REFLECT(steemit::chain::history_account_entry, (account)(sequence))
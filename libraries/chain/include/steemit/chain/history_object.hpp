@@ -76,9 +76,12 @@ namespace steemit {
             account_name_type account;
             uint32_t sequence = 0;
             operation_id_type op;
+            uint8_t op_type = 0; ///< operation::tag of the operation
         };
 
         struct by_account;
+        struct by_account_op_type;
+        struct by_operation;
         typedef multi_index_container <
         account_history_object,
         indexed_by<
@@ -91,6 +94,22 @@ namespace steemit {
         member<account_history_object, uint32_t, &account_history_object::sequence>
         >,
         composite_key_compare <std::less<account_name_type>, std::greater<uint32_t>>
+        >,
+        ordered_unique <tag<by_account_op_type>,
+        composite_key<account_history_object,
+                member <
+                account_history_object, account_name_type, &account_history_object::account>,
+        member<account_history_object, uint8_t, &account_history_object::op_type>,
+        member<account_history_object, uint32_t, &account_history_object::sequence>
+        >,
+        composite_key_compare <std::less<account_name_type>, std::less<uint8_t>, std::greater<uint32_t>>
+        >,
+        ordered_unique <tag<by_operation>,
+        composite_key<account_history_object,
+                member <
+                account_history_object, operation_id_type, &account_history_object::op>,
+        member<account_history_object, account_history_id_type, &account_history_object::id>
+        >
         >
         >,
         allocator <account_history_object>
@@ -102,5 +121,5 @@ namespace steemit {
 FC_REFLECT(steemit::chain::operation_object, (id)(trx_id)(block)(trx_in_block)(op_in_trx)(virtual_op)(timestamp)(serialized_op))
 CHAINBASE_SET_INDEX_TYPE(steemit::chain::operation_object, steemit::chain::operation_index)
 
-FC_REFLECT(steemit::chain::account_history_object, (id)(account)(sequence)(op))
+FC_REFLECT(steemit::chain::account_history_object, (id)(account)(sequence)(op)(op_type))
 CHAINBASE_SET_INDEX_TYPE(steemit::chain::account_history_object, steemit::chain::account_history_index)
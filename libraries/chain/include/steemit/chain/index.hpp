@@ -20,5 +20,17 @@ namespace steemit {
             db._plugin_index_signal.connect([&db]() { _add_index_impl<MultiIndexType>(db); });
         }
 
+        /**
+         * Remove all objects of a plugin index, before the plugin rebuilds it from the operation history.
+         * Must be called outside of any undo session.
+         */
+        template<typename MultiIndexType>
+        void wipe_plugin_index(database &db) {
+            const auto &idx = db.get_index<MultiIndexType>().indices();
+            while (!idx.empty()) {
+                db.remove(*idx.begin());
+            }
+        }
+
     }
 }
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <steemit/chain/steem_object_types.hpp>
+
+#include <fc/crypto/city.hpp>
+
+#include <boost/multi_index/composite_key.hpp>
+
+#include <cstring>
+
+namespace steemit {
+    namespace chain {
+
+        struct strcmp_less {
+            bool operator()(const shared_string &a, const shared_string &b) const {
+                return less(a.c_str(), b.c_str());
+            }
+
+            bool operator()(const shared_string &a, const string &b) const {
+                return less(a.c_str(), b.c_str());
+            }
+
+            bool operator()(const string &a, const shared_string &b) const {
+                return less(a.c_str(), b.c_str());
+            }
+
+        private:
+            inline bool less(const char *a, const char *b) const {
+                return std::strcmp(a, b) < 0;
+            }
+        };
+
+        /**
+         * A string stored once in shared memory and referred to by its id, used for strings which repeat across
+         * many objects such as categories and parent permlinks. Objects holding the id compare strings for
+         * equality with an integer compare.
+         *
+         * Interned strings are never removed, so the undo state only ever holds their creation and an id stays
+         * valid for as long as any object referring to it exists.
+         */
+        class interned_string_object
+                : public object<interned_string_object_type, interned_string_object> {
+        public:
+            interned_string_object() = delete;
+
+            template<typename Constructor, typename Allocator>
+            interned_string_object(Constructor &&c, allocator <Allocator> a)
+                    : value(a) {
+                c(*this);
+            }
+
+            id_type id;
+
+            uint64_t hash = 0; ///< city hash of the value, compared before the value itself
+            shared_string value;
+
+            static uint64_t hash_of(const string &s) {
+                return fc::city_hash64(s.data(), s.size());
+            }
+
+            static uint64_t hash_of(const shared_string &s) {
+                return fc::city_hash64(s.data(), s.size());
+            }
+        };
+
+        struct by_value;
+
+        typedef multi_index_container <
+        interned_string_object,
+        indexed_by<
+                ordered_unique < tag <
+                by_id>, member<interned_string_object, interned_string_id_type, &interned_string_object::id>>,
+        ordered_unique <tag<by_value>,
+        composite_key<interned_string_object,
+                member <
+                interned_string_object, uint64_t, &interned_string_object::hash>,
+        member<interned_string_object, shared_string, &interned_string_object::value>
+        >,
+        composite_key_compare <std::less<uint64_t>, strcmp_less>
+        >
+        >,
+        allocator <interned_string_object>
+        >
+        interned_string_index;
+
+    }
+}
+
+FC_REFLECT(steemit::chain::interned_string_object, (id)(hash)(value))
+CHAINBASE_SET_INDEX_TYPE(steemit::chain::interned_string_object, steemit::chain::interned_string_index)
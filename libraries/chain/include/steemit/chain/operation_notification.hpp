@@ -1,6 +1,7 @@
 #pragma once
 
 #include <steemit/protocol/operations.hpp>
+#include <steemit/protocol/impacted.hpp>
 
 #include <steemit/chain/steem_object_types.hpp>
 
@@ -8,6 +9,12 @@ namespace steemit {
     namespace chain {
 
         struct operation_notification {
+            enum operation_class {
+                virtual_operation = 1,
+                market_operation = 2,
+                posting_operation = 4
+            };
+
             operation_notification(const operation &o) : op(o) {
             }
 
@@ -17,6 +24,49 @@ namespace steemit {
             uint16_t op_in_trx = 0;
             uint64_t virtual_op = 0;
             const operation &op;
+
+            /**
+             * Accounts impacted by the operation, computed on first use and shared by every handler of the
+             * pre and post apply signals.
+             */
+            const flat_set<account_name_type> &impacted_accounts() const {
+                if (!_impacted_computed) {
+                    protocol::operation_get_impacted_accounts(op, _impacted);
+                    _impacted_computed = true;
+                }
+                return _impacted;
+            }
+
+            bool is_virtual() const {
+                return classification() & virtual_operation;
+            }
+
+            bool is_market() const {
+                return classification() & market_operation;
+            }
+
+            bool is_posting() const {
+                return classification() & posting_operation;
+            }
+
+            /**
+             * Bitmask of operation_class, computed on first use.
+             */
+            uint8_t classification() const {
+                if (!_classified) {
+                    _classification = (is_virtual_operation(op) ? virtual_operation : 0) |
+                                      (is_market_operation(op) ? market_operation : 0) |
+                                      (is_posting_operation(op) ? posting_operation : 0);
+                    _classified = true;
+                }
+                return _classification;
+            }
+
+        private:
+            mutable flat_set<account_name_type> _impacted;
+            mutable bool _impacted_computed = false;
+            mutable uint8_t _classification = 0;
+            mutable bool _classified = false;
         };
 
     }
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <fc/time.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace steemit {
+    namespace chain {
+
+        /**
+         * Summary of the samples collected by a timing_histogram. Percentiles are computed over the
+         * most recent samples only, count and total cover the whole lifetime of the histogram.
+         */
+        struct timing_stats {
+            std::string name;
+            uint64_t count = 0;
+            int64_t total_us = 0;
+            int64_t avg_us = 0;
+            int64_t p50_us = 0;
+            int64_t p90_us = 0;
+            int64_t p99_us = 0;
+            int64_t max_us = 0;
+        };
+
+        /**
+         * Keeps a rolling window of durations, cheap enough to be updated on every block or operation.
+         */
+        class timing_histogram {
+        public:
+            static const uint32_t window_size = 1024;
+
+            void add(const fc::microseconds &duration);
+
+            timing_stats get_stats(const std::string &name) const;
+
+            uint64_t count() const {
+                return _count;
+            }
+
+        private:
+            std::vector<int64_t> _window;
+            uint32_t _next = 0;
+            uint64_t _count = 0;
+            int64_t _total_us = 0;
+        };
+
+        struct operation_profile_stats {
+            std::string name;
+            int64_t total_us = 0;
+            timing_stats evaluate;
+            timing_stats pre_apply;
+            timing_stats post_apply;
+        };
+
+        /**
+         * Time spent applying one operation type, split into the evaluator itself and the plugin handlers
+         * connected to the pre_apply_operation and post_apply_operation signals. Virtual operations only
+         * have signal time.
+         */
+        struct operation_profile {
+            std::string name;
+            timing_histogram evaluate;
+            timing_histogram pre_apply;
+            timing_histogram post_apply;
+
+            operation_profile_stats get_stats() const;
+        };
+
+        /**
+         * Phases of block application, in the order they run
+         */
+        enum class block_phase {
+            merkle_check,
+            validate_block_header,
+            process_header,
+            apply_transactions,
+            update_global_dynamic_data,
+            update_signing_witness,
+            update_last_irreversible_block,
+            create_block_summary,
+            clear_expired_transactions,
+            clear_expired_orders,
+            update_witness_schedule,
+            update_median_feed,
+            update_virtual_supply,
+            clear_null_account_balance,
+            process_funds,
+            process_conversions,
+            process_comment_cashout,
+            process_vesting_withdrawals,
+            process_savings_withdraws,
+            pay_liquidity_reward,
+            update_virtual_supply_after_payouts,
+            account_recovery_processing,
+            expire_escrow_ratification,
+            process_decline_voting_rights,
+            process_hardforks,
+            notify_applied_block,
+            notify_changed_objects,
+            count
+        };
+
+        const char *block_phase_name(block_phase phase);
+
+        /**
+         * Measures the phases of block application. Every phase of the block being applied is recorded
+         * both into a per-phase histogram and into the breakdown of the current block, which is logged
+         * when the whole block takes longer than the slow block threshold.
+         */
+        class block_profiler {
+        public:
+            void set_enabled(bool enabled) {
+                _enabled = enabled;
+            }
+
+            bool enabled() const {
+                return _enabled;
+            }
+
+            /**
+             * Blocks taking longer than this are logged with their breakdown, zero disables the log.
+             */
+            void set_slow_block_threshold(const fc::microseconds &threshold) {
+                _slow_block_threshold = threshold;
+            }
+
+            void begin_block(uint32_t block_num);
+
+            void record(block_phase phase, const fc::microseconds &duration);
+
+            /**
+             * Record a single transaction, which is accounted separately from the phase the transaction
+             * loop itself is recorded as.
+             */
+            void record_transaction(const fc::microseconds &duration);
+
+            void end_block();
+
+            uint32_t last_block_num() const {
+                return _block_num;
+            }
+
+            std::vector<timing_stats> get_stats() const;
+
+        private:
+            bool _enabled = false;
+            fc::microseconds _slow_block_threshold;
+
+            uint32_t _block_num = 0;
+            fc::time_point _block_start;
+            std::vector<std::pair<block_phase, fc::microseconds>> _block_breakdown;
+            uint32_t _block_trx_count = 0;
+            fc::microseconds _block_slowest_trx;
+
+            std::array<timing_histogram, static_cast<size_t>(block_phase::count)> _phases;
+            timing_histogram _transactions;
+            timing_histogram _blocks;
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::chain::timing_stats, (name)(count)(total_us)(avg_us)(p50_us)(p90_us)(p99_us)(max_us))
+FC_REFLECT(steemit::chain::operation_profile_stats, (name)(total_us)(evaluate)(pre_apply)(post_apply))
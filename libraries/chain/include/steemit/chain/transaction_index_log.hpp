@@ -0,0 +1,75 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <steemit/protocol/block.hpp>
+
+namespace steemit {
+    namespace chain {
+
+        using namespace steemit::protocol;
+
+        namespace detail { class transaction_index_log_impl; }
+
+        /**
+         * Location of a transaction inside the irreversible part of the chain.
+         */
+        struct transaction_location {
+            uint32_t block_num = 0;
+            uint16_t trx_in_block = 0;
+        };
+
+        /* The transaction index log is an optional external index that maps a transaction id to the
+         * block which contains it. It is fed from the same place as the block log, so only irreversible
+         * transactions are indexed, and it can be rebuilt at any time from a linear scan of the block log.
+         *
+         * The index consists of two files. The data file is append only and contains fixed size records:
+         *
+         * +----------+-----------+--------------+---------------------------+-----+
+         * | Trx Id 1 | Block Num | Trx In Block | Pos of Prev Rec in Bucket | ... |
+         * +----------+-----------+--------------+---------------------------+-----+
+         *
+         * The bucket file contains a small header (number of the last indexed block, size of the data
+         * file at that moment and the bucket count) followed by one 8 byte slot per bucket, holding
+         * the position + 1 of the most recent record which hashes into the bucket (0 means empty).
+         * Records of the same bucket form a singly linked list going backwards through the data file.
+         *
+         * The bucket table is kept in memory while the log is open and is written back on flush(),
+         * so a lookup costs one walk of a short chain of records in the data file. Records appended
+         * after the last flush are discarded on open and re-indexed from the block log.
+         */
+        class transaction_index_log {
+        public:
+            transaction_index_log();
+
+            ~transaction_index_log();
+
+            void open(const fc::path &file);
+
+            void close();
+
+            bool is_open() const;
+
+            /**
+             * Index all transactions of the block. Blocks must be appended in order.
+             */
+            void append(const signed_block &b);
+
+            void flush();
+
+            optional <transaction_location> find(const transaction_id_type &trx_id) const;
+
+            /**
+             * Return number of the last indexed block, or 0 if the index is empty.
+             */
+            uint32_t head_block_num() const;
+
+            static const uint32_t bucket_count = 1 << 20;
+
+        private:
+            std::unique_ptr<detail::transaction_index_log_impl> my;
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::chain::transaction_location, (block_num)(trx_in_block))
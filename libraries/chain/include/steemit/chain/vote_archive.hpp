@@ -0,0 +1,91 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <steemit/protocol/types.hpp>
+
+namespace steemit {
+    namespace chain {
+
+        using namespace steemit::protocol;
+
+        namespace detail { class vote_archive_impl; }
+
+        /**
+         * A vote as it is stored in the vote archive, mirrors comment_vote_object.
+         */
+        struct archived_vote {
+            uint32_t comment = 0; ///< instance of the comment_id_type
+            uint32_t voter = 0; ///< instance of the account_id_type
+            uint64_t weight = 0;
+            int64_t rshares = 0;
+            int16_t vote_percent = 0;
+            time_point_sec last_update;
+            int8_t num_changes = 0;
+        };
+
+        /* The vote archive holds the votes of comments which can no longer be paid out, so they do not have
+         * to be kept as comment_vote_objects in shared memory. It consists of three files:
+         *
+         * The votes file is append only and holds one fixed size record per vote:
+         *
+         * +---------+-------+--------+---------+---------+-------------+-------------+----------------+
+         * | Comment | Voter | Weight | Rshares | Percent | Last Update | Num Changes | Prev of Voter  | ...
+         * +---------+-------+--------+---------+---------+-------------+-------------+----------------+
+         *
+         * All votes of a comment are archived at once and are contiguous. Records of a voter form a list going
+         * backwards through the file.
+         *
+         * The comments file holds one slot per comment id with the position + 1 of the first vote of the
+         * comment and the number of votes. Slots are read and written directly, a slot pointing past the last
+         * record covered by the header is treated as empty.
+         *
+         * The main file holds a header (last block, size of the votes file) followed by one slot per voter id
+         * with the position + 1 of the last record of the voter and the number of records. Voter slots are kept
+         * in memory while the archive is open and written back on flush(). Anything written after the last
+         * flush is discarded on open. An archive opened read only reads the header and voter slots from the
+         * main file on every lookup instead.
+         */
+        class vote_archive {
+        public:
+            vote_archive();
+
+            ~vote_archive();
+
+            /**
+             * @param read_only the archive is only read, while the node writing the chain state of another
+             * process keeps appending to it
+             */
+            void open(const fc::path &file, bool read_only = false);
+
+            void close();
+
+            bool is_open() const;
+
+            /**
+             * Append the votes archived in a block. Blocks must be appended in order, the votes of a comment
+             * must all be appended at once.
+             */
+            void append_block(uint32_t block_num, const std::vector<archived_vote> &votes);
+
+            void flush();
+
+            /**
+             * Return number of the last block in the archive, or 0 if the archive is empty.
+             */
+            uint32_t head_block_num() const;
+
+            std::vector<archived_vote> get_comment_votes(uint32_t comment) const;
+
+            /**
+             * Return the archived votes of the voter, latest archived first.
+             */
+            std::vector<archived_vote> get_account_votes(uint32_t voter) const;
+
+        private:
+            std::unique_ptr<detail::vote_archive_impl> my;
+        };
+
+    }
+}
+
+FC_REFLECT(steemit::chain::archived_vote, (comment)(voter)(weight)(rshares)(vote_percent)(last_update)(num_changes))
@@ -0,0 +1,165 @@
+#include <steemit/chain/profiler.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace steemit {
+    namespace chain {
+
+        void timing_histogram::add(const fc::microseconds &duration) {
+            if (_window.size() < window_size) {
+                _window.push_back(duration.count());
+            } else {
+                _window[_next] = duration.count();
+            }
+            _next = (_next + 1) % window_size;
+            ++_count;
+            _total_us += duration.count();
+        }
+
+        timing_stats timing_histogram::get_stats(const std::string &name) const {
+            timing_stats result;
+            result.name = name;
+            result.count = _count;
+            result.total_us = _total_us;
+
+            if (_count == 0) {
+                return result;
+            }
+
+            result.avg_us = _total_us / int64_t(_count);
+
+            std::vector<int64_t> sorted(_window);
+            std::sort(sorted.begin(), sorted.end());
+
+            auto percentile = [&](uint32_t p) {
+                return sorted[std::min<size_t>(sorted.size() - 1,
+                        sorted.size() * p / 100)];
+            };
+
+            result.p50_us = percentile(50);
+            result.p90_us = percentile(90);
+            result.p99_us = percentile(99);
+            result.max_us = sorted.back();
+            return result;
+        }
+
+        operation_profile_stats operation_profile::get_stats() const {
+            operation_profile_stats result;
+            result.name = name;
+            result.evaluate = evaluate.get_stats("evaluate");
+            result.pre_apply = pre_apply.get_stats("pre_apply");
+            result.post_apply = post_apply.get_stats("post_apply");
+            result.total_us = result.evaluate.total_us +
+                              result.pre_apply.total_us +
+                              result.post_apply.total_us;
+            return result;
+        }
+
+        const char *block_phase_name(block_phase phase) {
+            static const char *const names[] = {
+                    "merkle_check",
+                    "validate_block_header",
+                    "process_header",
+                    "apply_transactions",
+                    "update_global_dynamic_data",
+                    "update_signing_witness",
+                    "update_last_irreversible_block",
+                    "create_block_summary",
+                    "clear_expired_transactions",
+                    "clear_expired_orders",
+                    "update_witness_schedule",
+                    "update_median_feed",
+                    "update_virtual_supply",
+                    "clear_null_account_balance",
+                    "process_funds",
+                    "process_conversions",
+                    "process_comment_cashout",
+                    "process_vesting_withdrawals",
+                    "process_savings_withdraws",
+                    "pay_liquidity_reward",
+                    "update_virtual_supply_after_payouts",
+                    "account_recovery_processing",
+                    "expire_escrow_ratification",
+                    "process_decline_voting_rights",
+                    "process_hardforks",
+                    "notify_applied_block",
+                    "notify_changed_objects"
+            };
+            static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(block_phase::count),
+                    "every block phase must be named");
+            return names[static_cast<size_t>(phase)];
+        }
+
+        void block_profiler::begin_block(uint32_t block_num) {
+            _block_num = block_num;
+            _block_start = fc::time_point::now();
+            _block_breakdown.clear();
+            _block_trx_count = 0;
+            _block_slowest_trx = fc::microseconds();
+        }
+
+        void block_profiler::record(block_phase phase, const fc::microseconds &duration) {
+            _block_breakdown.emplace_back(phase, duration);
+            _phases[static_cast<size_t>(phase)].add(duration);
+        }
+
+        void block_profiler::record_transaction(const fc::microseconds &duration) {
+            ++_block_trx_count;
+            _block_slowest_trx = std::max(_block_slowest_trx, duration);
+            _transactions.add(duration);
+        }
+
+        void block_profiler::end_block() {
+            auto duration = fc::time_point::now() - _block_start;
+            _blocks.add(duration);
+
+            if (_slow_block_threshold.count() == 0 ||
+                duration < _slow_block_threshold) {
+                return;
+            }
+
+            std::sort(_block_breakdown.begin(), _block_breakdown.end(),
+                    [](const std::pair<block_phase, fc::microseconds> &a,
+                            const std::pair<block_phase, fc::microseconds> &b) {
+                        return a.second > b.second;
+                    });
+
+            std::stringstream breakdown;
+            for (const auto &phase : _block_breakdown) {
+                if (phase.second.count() < 1000) {
+                    break;
+                }
+                breakdown << " " << block_phase_name(phase.first) << "="
+                          << phase.second.count() / 1000 << "ms";
+            }
+
+            wlog("Slow block ${n} took ${t}ms, ${c} transactions, slowest ${s}ms:${b}",
+                    ("n", _block_num)("t", duration.count() / 1000)
+                    ("c", _block_trx_count)("s", _block_slowest_trx.count() / 1000)
+                    ("b", breakdown.str()));
+        }
+
+        std::vector<timing_stats> block_profiler::get_stats() const {
+            std::vector<timing_stats> result;
+            result.reserve(_phases.size() + 2);
+
+            result.push_back(_blocks.get_stats("block"));
+            result.push_back(_transactions.get_stats("transaction"));
+            for (size_t i = 0; i < _phases.size(); ++i) {
+                if (_phases[i].count() > 0) {
+                    result.push_back(_phases[i].get_stats(block_phase_name(static_cast<block_phase>(i))));
+                }
+            }
+
+            std::sort(result.begin() + 2, result.end(),
+                    [](const timing_stats &a, const timing_stats &b) {
+                        return a.total_us > b.total_us;
+                    });
+            return result;
+        }
+
+    }
+}
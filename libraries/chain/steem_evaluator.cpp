@@ -165,17 +165,20 @@ namespace steemit {
                 acc.memo_key = o.memo_key;
                 acc.created = props.time;
                 acc.last_vote_time = props.time;
-                acc.mined = false;
+            });
+
+            _db.create<account_metadata_object>([&](account_metadata_object &meta) {
+                meta.account = o.new_account_name;
+                meta.mined = false;
 
                 if (!_db.has_hardfork(STEEMIT_HARDFORK_0_11__169)) {
-                    acc.recovery_account = STEEMIT_INIT_MINER_NAME;
+                    meta.recovery_account = STEEMIT_INIT_MINER_NAME;
                 } else {
-                    acc.recovery_account = o.creator;
+                    meta.recovery_account = o.creator;
                 }
 
-
 #ifndef IS_LOW_MEM
-                from_string(acc.json_metadata, o.json_metadata);
+                from_string(meta.json_metadata, o.json_metadata);
 #endif
             });
 
@@ -243,24 +246,35 @@ namespace steemit {
                 }
             }
 
+            bool prove_active = (o.active || o.owner) && account.active_challenged;
+
             _db.modify(account, [&](account_object &acc) {
                 if (o.memo_key != public_key_type()) {
                     acc.memo_key = o.memo_key;
                 }
 
-                if ((o.active || o.owner) && acc.active_challenged) {
+                if (prove_active) {
                     acc.active_challenged = false;
-                    acc.last_active_proved = _db.head_block_time();
                 }
 
                 acc.last_account_update = _db.head_block_time();
+            });
 
 #ifndef IS_LOW_MEM
-                if (o.json_metadata.size() > 0) {
-                    from_string(acc.json_metadata, o.json_metadata);
-                }
+            bool update_metadata = o.json_metadata.size() > 0;
+#else
+            bool update_metadata = false;
 #endif
-            });
+            if (prove_active || update_metadata) {
+                _db.modify(_db.get_account_metadata(o.account), [&](account_metadata_object &meta) {
+                    if (prove_active) {
+                        meta.last_active_proved = _db.head_block_time();
+                    }
+                    if (update_metadata) {
+                        from_string(meta.json_metadata, o.json_metadata);
+                    }
+                });
+            }
 
             if (o.active || o.posting) {
                 _db.modify(account_auth, [&](account_authority_object &auth) {
@@ -312,7 +326,7 @@ namespace steemit {
             /// this loop can be skiped for validate-only nodes as it is merely gathering stats for indicies
             if (_db.has_hardfork(STEEMIT_HARDFORK_0_6__80) &&
                 comment.parent_author != STEEMIT_ROOT_POST_PARENT) {
-                auto parent = &_db.get_comment(comment.parent_author, comment.parent_permlink);
+                auto parent = &_db.get_parent_comment(comment);
                 auto now = _db.head_block_time();
                 while (parent) {
                     _db.modify(*parent, [&](comment_object &p) {
@@ -321,7 +335,7 @@ namespace steemit {
                     });
 #ifndef IS_LOW_MEM
                     if (parent->parent_author != STEEMIT_ROOT_POST_PARENT) {
-                        parent = &_db.get_comment(parent->parent_author, parent->parent_permlink);
+                        parent = &_db.get_parent_comment(*parent);
                     } else
 #endif
                     {
@@ -471,11 +485,15 @@ namespace steemit {
                         a.post_count++;
                     });
 
+                    if (_db.has_hardfork(STEEMIT_HARDFORK_0_1)) {
+                        validate_permlink_0_1(o.parent_permlink);
+                        validate_permlink_0_1(o.permlink);
+                    }
+
+                    // The category of a root post is its parent permlink
+                    auto parent_permlink = _db.intern_string(o.parent_permlink);
+
                     const auto &new_comment = _db.create<comment_object>([&](comment_object &com) {
-                        if (_db.has_hardfork(STEEMIT_HARDFORK_0_1)) {
-                            validate_permlink_0_1(o.parent_permlink);
-                            validate_permlink_0_1(o.permlink);
-                        }
 
                         com.author = o.author;
                         from_string(com.permlink, o.permlink);
@@ -488,8 +506,8 @@ namespace steemit {
 
                         if (o.parent_author == STEEMIT_ROOT_POST_PARENT) {
                             com.parent_author = "";
-                            from_string(com.parent_permlink, o.parent_permlink);
-                            from_string(com.category, o.parent_permlink);
+                            com.parent_permlink = parent_permlink;
+                            com.category = parent_permlink;
                             com.root_comment = com.id;
                             com.cashout_time = _db.has_hardfork(STEEMIT_HARDFORK_0_12__177)
                                                ?
@@ -498,7 +516,8 @@ namespace steemit {
                                                fc::time_point_sec::maximum();
                         } else {
                             com.parent_author = parent->author;
-                            com.parent_permlink = parent->permlink;
+                            com.parent_permlink = parent_permlink;
+                            com.parent_comment = parent->id;
                             com.depth = parent->depth + 1;
                             com.category = parent->category;
                             com.root_comment = parent->root_comment;
@@ -506,11 +525,13 @@ namespace steemit {
                         }
 
 #ifndef IS_LOW_MEM
-                        from_string(com.title, o.title);
+                        comment_content content;
+                        content.title = o.title;
                         if (o.body.size() < 1024 * 1024 * 128) {
-                            from_string(com.body, o.body);
+                            content.body = o.body;
                         }
-                        from_string(com.json_metadata, o.json_metadata);
+                        content.json_metadata = o.json_metadata;
+                        com.content = _db.store_comment_content(content);
 #endif
                     });
 
@@ -540,7 +561,7 @@ namespace steemit {
                         });
 #ifndef IS_LOW_MEM
                         if (parent->parent_author != STEEMIT_ROOT_POST_PARENT) {
-                            parent = &_db.get_comment(parent->parent_author, parent->parent_permlink);
+                            parent = &_db.get_parent_comment(*parent);
                         } else
 #endif
                         {
@@ -567,40 +588,47 @@ namespace steemit {
                         if (!parent) {
                             FC_ASSERT(com.parent_author ==
                                       account_name_type(), "The parent of a comment cannot change.");
-                            FC_ASSERT(equal(com.parent_permlink, o.parent_permlink), "The permlink of a comment cannot change.");
+                            FC_ASSERT(equal(_db.get_interned_string(com.parent_permlink), o.parent_permlink), "The permlink of a comment cannot change.");
                         } else {
                             FC_ASSERT(com.parent_author ==
                                       o.parent_author, "The parent of a comment cannot change.");
-                            FC_ASSERT(equal(com.parent_permlink, o.parent_permlink), "The permlink of a comment cannot change.");
+                            FC_ASSERT(equal(_db.get_interned_string(com.parent_permlink), o.parent_permlink), "The permlink of a comment cannot change.");
                         }
 
 #ifndef IS_LOW_MEM
-                        if (o.title.size()) {
-                            from_string(com.title, o.title);
-                        }
-                        if (o.json_metadata.size()) {
-                            from_string(com.json_metadata, o.json_metadata);
-                        }
+                        if (o.title.size() || o.json_metadata.size() ||
+                            o.body.size()) {
+                            auto content = _db.get_comment_content(com);
+
+                            if (o.title.size()) {
+                                content.title = o.title;
+                            }
+                            if (o.json_metadata.size()) {
+                                content.json_metadata = o.json_metadata;
+                            }
 
-                        if (o.body.size()) {
-                            try {
-                                diff_match_patch<std::wstring> dmp;
-                                auto patch = dmp.patch_fromText(utf8_to_wstring(o.body));
-                                if (patch.size()) {
-                                    auto result = dmp.patch_apply(patch, utf8_to_wstring(to_string(com.body)));
-                                    auto patched_body = wstring_to_utf8(result.first);
-                                    if (!fc::is_utf8(patched_body)) {
-                                        idump(("invalid utf8")(patched_body));
-                                        from_string(com.body, fc::prune_invalid_utf8(patched_body));
-                                    } else {
-                                        from_string(com.body, patched_body);
+                            if (o.body.size()) {
+                                try {
+                                    diff_match_patch<std::wstring> dmp;
+                                    auto patch = dmp.patch_fromText(utf8_to_wstring(o.body));
+                                    if (patch.size()) {
+                                        auto result = dmp.patch_apply(patch, utf8_to_wstring(content.body));
+                                        auto patched_body = wstring_to_utf8(result.first);
+                                        if (!fc::is_utf8(patched_body)) {
+                                            idump(("invalid utf8")(patched_body));
+                                            content.body = fc::prune_invalid_utf8(patched_body);
+                                        } else {
+                                            content.body = patched_body;
+                                        }
+                                    } else { // replace
+                                        content.body = o.body;
                                     }
-                                } else { // replace
-                                    from_string(com.body, o.body);
+                                } catch (...) {
+                                    content.body = o.body;
                                 }
-                            } catch (...) {
-                                from_string(com.body, o.body);
                             }
+
+                            com.content = _db.store_comment_content(content);
                         }
 #endif
 
@@ -794,7 +822,9 @@ namespace steemit {
             if (from_account.active_challenged) {
                 _db.modify(from_account, [&](account_object &a) {
                     a.active_challenged = false;
-                    a.last_active_proved = _db.head_block_time();
+                });
+                _db.modify(_db.get_account_metadata(o.from), [&](account_metadata_object &meta) {
+                    meta.last_active_proved = _db.head_block_time();
                 });
             }
 
@@ -827,7 +857,7 @@ namespace steemit {
             FC_ASSERT(account.vesting_shares >=
                       o.vesting_shares, "Account does not have sufficient Golos Power for withdraw.");
 
-            if (!account.mined && _db.has_hardfork(STEEMIT_HARDFORK_0_1)) {
+            if (_db.has_hardfork(STEEMIT_HARDFORK_0_1) && !_db.get_account_metadata(o.account).mined) {
                 const auto &props = _db.get_dynamic_global_properties();
                 const witness_schedule_object &wso = _db.get_witness_schedule_object();
 
@@ -1545,11 +1575,15 @@ namespace steemit {
                     acc.memo_key = o.work.worker;
                     acc.created = dgp.time;
                     acc.last_vote_time = dgp.time;
+                });
+
+                db.create<account_metadata_object>([&](account_metadata_object &meta) {
+                    meta.account = o.get_worker_account();
 
                     if (!db.has_hardfork(STEEMIT_HARDFORK_0_11__169)) {
-                        acc.recovery_account = STEEMIT_INIT_MINER_NAME;
+                        meta.recovery_account = STEEMIT_INIT_MINER_NAME;
                     } else {
-                        acc.recovery_account = "";
+                        meta.recovery_account = "";
                     } /// highest voted witness at time of recovery
                 });
 
@@ -1669,7 +1703,11 @@ namespace steemit {
                     acc.memo_key = *o.new_owner_key;
                     acc.created = dgp.time;
                     acc.last_vote_time = dgp.time;
-                    acc.recovery_account = ""; /// highest voted witness at time of recovery
+                });
+
+                db.create<account_metadata_object>([&](account_metadata_object &meta) {
+                    meta.account = worker_account;
+                    meta.recovery_account = ""; /// highest voted witness at time of recovery
                 });
 
                 db.create<account_authority_object>([&](account_authority_object &auth) {
@@ -1811,14 +1849,15 @@ namespace steemit {
             if (_db.has_hardfork(STEEMIT_HARDFORK_0_14__307))
                 FC_ASSERT(false, "Challenge authority operation is currently disabled.");
             const auto &challenged = _db.get_account(o.challenged);
+            const auto &challenged_meta = _db.get_account_metadata(o.challenged);
             const auto &challenger = _db.get_account(o.challenger);
 
             if (o.require_owner) {
-                FC_ASSERT(challenged.reset_account ==
+                FC_ASSERT(challenged_meta.reset_account ==
                           o.challenger, "Owner authority can only be challenged by its reset account.");
                 FC_ASSERT(challenger.balance >= STEEMIT_OWNER_CHALLENGE_FEE);
                 FC_ASSERT(!challenged.owner_challenged);
-                FC_ASSERT(_db.head_block_time() - challenged.last_owner_proved >
+                FC_ASSERT(_db.head_block_time() - challenged_meta.last_owner_proved >
                           STEEMIT_OWNER_CHALLENGE_COOLDOWN);
 
                 _db.adjust_balance(challenger, -STEEMIT_OWNER_CHALLENGE_FEE);
@@ -1833,7 +1872,7 @@ namespace steemit {
                 FC_ASSERT(!(challenged.owner_challenged ||
                             challenged.active_challenged), "Account is already challenged.");
                 FC_ASSERT(
-                        _db.head_block_time() - challenged.last_active_proved >
+                        _db.head_block_time() - challenged_meta.last_active_proved >
                         STEEMIT_ACTIVE_CHALLENGE_COOLDOWN, "Account cannot be challenged because it was recently challenged.");
 
                 _db.adjust_balance(challenger, -STEEMIT_ACTIVE_CHALLENGE_FEE);
@@ -1853,17 +1892,21 @@ namespace steemit {
 
             _db.modify(challenged, [&](account_object &a) {
                 a.active_challenged = false;
-                a.last_active_proved = _db.head_block_time();
                 if (o.require_owner) {
                     a.owner_challenged = false;
-                    a.last_owner_proved = _db.head_block_time();
+                }
+            });
+            _db.modify(_db.get_account_metadata(o.challenged), [&](account_metadata_object &meta) {
+                meta.last_active_proved = _db.head_block_time();
+                if (o.require_owner) {
+                    meta.last_owner_proved = _db.head_block_time();
                 }
             });
         }
 
         void request_account_recovery_evaluator::do_apply(const request_account_recovery_operation &o) {
             database &_db = db();
-            const auto &account_to_recover = _db.get_account(o.account_to_recover);
+            const auto &account_to_recover = _db.get_account_metadata(o.account_to_recover);
 
             if (account_to_recover.recovery_account.length())   // Make sure recovery matches expected recovery account
                 FC_ASSERT(account_to_recover.recovery_account ==
@@ -1922,10 +1965,11 @@ namespace steemit {
         void recover_account_evaluator::do_apply(const recover_account_operation &o) {
             database &_db = db();
             const auto &account = _db.get_account(o.account_to_recover);
+            const auto &account_meta = _db.get_account_metadata(o.account_to_recover);
 
             if (_db.has_hardfork(STEEMIT_HARDFORK_0_12))
                 FC_ASSERT(
-                        _db.head_block_time() - account.last_account_recovery >
+                        _db.head_block_time() - account_meta.last_account_recovery >
                         STEEMIT_OWNER_UPDATE_LIMIT, "Owner authority can only be updated once an hour.");
 
             const auto &recovery_request_idx = _db.get_index<account_recovery_request_index>().indices().get<by_account>();
@@ -1954,15 +1998,15 @@ namespace steemit {
 
             _db.remove(*request); // Remove first, update_owner_authority may invalidate iterator
             _db.update_owner_authority(account, o.new_owner_authority);
-            _db.modify(account, [&](account_object &a) {
-                a.last_account_recovery = _db.head_block_time();
+            _db.modify(account_meta, [&](account_metadata_object &meta) {
+                meta.last_account_recovery = _db.head_block_time();
             });
         }
 
         void change_recovery_account_evaluator::do_apply(const change_recovery_account_operation &o) {
             database &_db = db();
             _db.get_account(o.new_recovery_account); // Simply validate account exists
-            const auto &account_to_recover = _db.get_account(o.account_to_recover);
+            const auto &account_to_recover = _db.get_account_metadata(o.account_to_recover);
 
             const auto &change_recovery_idx = _db.get_index<change_recovery_account_request_index>().indices().get<by_account>();
             auto request = change_recovery_idx.find(o.account_to_recover);
@@ -2074,7 +2118,7 @@ namespace steemit {
                 FC_ASSERT(
                         (_db.head_block_time() - band->last_bandwidth_update) >
                         fc::days(60), "Account must be inactive for 60 days to be eligible for reset");
-            FC_ASSERT(acnt.reset_account ==
+            FC_ASSERT(_db.get_account_metadata(op.account_to_reset).reset_account ==
                       op.reset_account, "Reset account does not match reset account on account.");
 
             _db.update_owner_authority(acnt, op.new_owner_authority);
@@ -2084,7 +2128,7 @@ namespace steemit {
             database &_db = db();
             FC_ASSERT(false, "Set Reset Account Operation is currently disabled.");
 
-            const auto &acnt = _db.get_account(op.account);
+            const auto &acnt = _db.get_account_metadata(op.account);
             _db.get_account(op.reset_account);
 
             FC_ASSERT(acnt.reset_account ==
@@ -2092,7 +2136,7 @@ namespace steemit {
             FC_ASSERT(acnt.reset_account !=
                       op.reset_account, "Reset account must change");
 
-            _db.modify(acnt, [&](account_object &a) {
+            _db.modify(acnt, [&](account_metadata_object &a) {
                 a.reset_account = op.reset_account;
             });
         }
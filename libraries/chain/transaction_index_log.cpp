@@ -0,0 +1,268 @@
+#include <steemit/chain/transaction_index_log.hpp>
+#include <fstream>
+#include <mutex>
+
+#define INDEX_RW (std::ios::in | std::ios::out | std::ios::binary)
+#define INDEX_CREATE (std::ios::out | std::ios::binary | std::ios::trunc)
+
+namespace steemit {
+    namespace chain {
+
+        namespace detail {
+            struct transaction_index_header {
+                uint32_t head_block_num = 0;
+                uint32_t bucket_count = transaction_index_log::bucket_count;
+                uint64_t data_size = 0;
+            };
+
+            struct transaction_index_record {
+                transaction_id_type trx_id;
+                transaction_location location;
+                uint64_t prev = 0;
+            };
+
+            static const uint64_t record_size =
+                    sizeof(transaction_id_type) + sizeof(uint32_t) +
+                    sizeof(uint16_t) + sizeof(uint64_t);
+
+            class transaction_index_log_impl {
+            public:
+                transaction_index_header header;
+                std::vector<uint64_t> buckets;
+                std::vector<uint32_t> dirty_buckets;
+                std::fstream bucket_stream;
+                mutable std::fstream data_stream;
+                fc::path bucket_file;
+                fc::path data_file;
+                mutable std::mutex stream_mutex;
+
+                inline uint32_t bucket_of(const transaction_id_type &id) const {
+                    return id._hash[0] & (transaction_index_log::bucket_count - 1);
+                }
+
+                void write_record(const transaction_index_record &r) {
+                    data_stream.seekp(header.data_size);
+                    data_stream.write((const char *)r.trx_id._hash, sizeof(r.trx_id._hash));
+                    data_stream.write((const char *)&r.location.block_num, sizeof(r.location.block_num));
+                    data_stream.write((const char *)&r.location.trx_in_block, sizeof(r.location.trx_in_block));
+                    data_stream.write((const char *)&r.prev, sizeof(r.prev));
+                }
+
+                transaction_index_record read_record(uint64_t pos) const {
+                    transaction_index_record r;
+                    data_stream.seekg(pos);
+                    data_stream.read((char *)r.trx_id._hash, sizeof(r.trx_id._hash));
+                    data_stream.read((char *)&r.location.block_num, sizeof(r.location.block_num));
+                    data_stream.read((char *)&r.location.trx_in_block, sizeof(r.location.trx_in_block));
+                    data_stream.read((char *)&r.prev, sizeof(r.prev));
+                    return r;
+                }
+
+                void write_header() {
+                    bucket_stream.seekp(0);
+                    bucket_stream.write((const char *)&header.head_block_num, sizeof(header.head_block_num));
+                    bucket_stream.write((const char *)&header.bucket_count, sizeof(header.bucket_count));
+                    bucket_stream.write((const char *)&header.data_size, sizeof(header.data_size));
+                }
+
+                uint64_t header_size() const {
+                    return sizeof(header.head_block_num) +
+                           sizeof(header.bucket_count) +
+                           sizeof(header.data_size);
+                }
+
+                void create() {
+                    ilog("Creating transaction index");
+                    header = transaction_index_header();
+                    buckets.assign(transaction_index_log::bucket_count, 0);
+                    dirty_buckets.clear();
+
+                    bucket_stream.open(bucket_file.generic_string().c_str(), INDEX_CREATE);
+                    write_header();
+                    bucket_stream.write((const char *)buckets.data(), buckets.size() * sizeof(uint64_t));
+                    bucket_stream.close();
+
+                    data_stream.open(data_file.generic_string().c_str(), INDEX_CREATE);
+                    data_stream.close();
+                }
+
+                bool load() {
+                    if (!fc::exists(bucket_file) || !fc::exists(data_file) ||
+                        fc::file_size(bucket_file) != header_size() +
+                                                      transaction_index_log::bucket_count *
+                                                      sizeof(uint64_t)) {
+                        return false;
+                    }
+
+                    bucket_stream.open(bucket_file.generic_string().c_str(), INDEX_RW);
+                    bucket_stream.read((char *)&header.head_block_num, sizeof(header.head_block_num));
+                    bucket_stream.read((char *)&header.bucket_count, sizeof(header.bucket_count));
+                    bucket_stream.read((char *)&header.data_size, sizeof(header.data_size));
+
+                    if (header.bucket_count != transaction_index_log::bucket_count) {
+                        bucket_stream.close();
+                        return false;
+                    }
+
+                    buckets.resize(transaction_index_log::bucket_count);
+                    bucket_stream.read((char *)buckets.data(), buckets.size() * sizeof(uint64_t));
+                    bucket_stream.close();
+
+                    auto data_size = fc::file_size(data_file);
+                    if (data_size < header.data_size) {
+                        wlog("Transaction index data file is truncated");
+                        return false;
+                    }
+
+                    data_stream.open(data_file.generic_string().c_str(), INDEX_RW);
+
+                    // Bucket slots can be flushed ahead of the header, so unwind every chain
+                    // which points past the last record covered by the header.
+                    for (uint32_t i = 0; i < buckets.size(); ++i) {
+                        while (buckets[i] > header.data_size) {
+                            if (buckets[i] - 1 + record_size > data_size) {
+                                wlog("Transaction index bucket points outside of data file");
+                                data_stream.close();
+                                return false;
+                            }
+                            buckets[i] = read_record(buckets[i] - 1).prev;
+                            dirty_buckets.push_back(i);
+                        }
+                    }
+
+                    data_stream.close();
+
+                    if (data_size > header.data_size) {
+                        ilog("Dropping ${n} bytes of unflushed transaction index records",
+                                ("n", data_size - header.data_size));
+                        fc::resize_file(data_file, header.data_size);
+                    }
+
+                    return true;
+                }
+            };
+        }
+
+        transaction_index_log::transaction_index_log()
+                : my(new detail::transaction_index_log_impl()) {
+            my->bucket_stream.exceptions(
+                    std::fstream::failbit | std::fstream::badbit);
+            my->data_stream.exceptions(
+                    std::fstream::failbit | std::fstream::badbit);
+        }
+
+        transaction_index_log::~transaction_index_log() {
+            if (is_open()) {
+                flush();
+            }
+        }
+
+        void transaction_index_log::open(const fc::path &file) {
+            try {
+                close();
+
+                my->bucket_file = file;
+                my->data_file = fc::path(file.generic_string() + ".data");
+
+                if (!my->load()) {
+                    my->create();
+                }
+
+                my->bucket_stream.open(my->bucket_file.generic_string().c_str(), INDEX_RW);
+                my->data_stream.open(my->data_file.generic_string().c_str(), INDEX_RW);
+
+                ilog("Transaction index head block is ${n}", ("n", my->header.head_block_num));
+            }
+            FC_CAPTURE_AND_RETHROW((file))
+        }
+
+        void transaction_index_log::close() {
+            if (is_open()) {
+                flush();
+            }
+            my.reset(new detail::transaction_index_log_impl());
+            my->bucket_stream.exceptions(
+                    std::fstream::failbit | std::fstream::badbit);
+            my->data_stream.exceptions(
+                    std::fstream::failbit | std::fstream::badbit);
+        }
+
+        bool transaction_index_log::is_open() const {
+            return my->data_stream.is_open();
+        }
+
+        void transaction_index_log::append(const signed_block &b) {
+            try {
+                std::lock_guard<std::mutex> lock(my->stream_mutex);
+
+                FC_ASSERT(b.block_num() ==
+                          my->header.head_block_num + 1, "Append to transaction index occuring at wrong block.",
+                        ("block_num", b.block_num())("expected", my->header.head_block_num + 1));
+
+                detail::transaction_index_record r;
+                r.location.block_num = b.block_num();
+
+                for (const auto &trx : b.transactions) {
+                    r.trx_id = trx.id();
+                    auto bucket = my->bucket_of(r.trx_id);
+                    r.prev = my->buckets[bucket];
+
+                    my->write_record(r);
+                    my->header.data_size += detail::record_size;
+                    my->buckets[bucket] = my->header.data_size - detail::record_size + 1;
+                    my->dirty_buckets.push_back(bucket);
+
+                    ++r.location.trx_in_block;
+                }
+
+                my->header.head_block_num = b.block_num();
+            }
+            FC_LOG_AND_RETHROW()
+        }
+
+        void transaction_index_log::flush() {
+            std::lock_guard<std::mutex> lock(my->stream_mutex);
+
+            // Data must reach the disk before anything that points to it
+            my->data_stream.flush();
+
+            for (auto bucket : my->dirty_buckets) {
+                my->bucket_stream.seekp(my->header_size() + bucket * sizeof(uint64_t));
+                my->bucket_stream.write((const char *)&my->buckets[bucket], sizeof(uint64_t));
+            }
+            my->bucket_stream.flush();
+            my->dirty_buckets.clear();
+
+            my->write_header();
+            my->bucket_stream.flush();
+        }
+
+        optional<transaction_location> transaction_index_log::find(const transaction_id_type &trx_id) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->stream_mutex);
+                optional<transaction_location> result;
+
+                if (!is_open()) {
+                    return result;
+                }
+
+                uint64_t pos = my->buckets[my->bucket_of(trx_id)];
+                while (pos) {
+                    auto r = my->read_record(pos - 1);
+                    if (r.trx_id == trx_id) {
+                        result = r.location;
+                        break;
+                    }
+                    pos = r.prev;
+                }
+
+                return result;
+            }
+            FC_LOG_AND_RETHROW()
+        }
+
+        uint32_t transaction_index_log::head_block_num() const {
+            return my->header.head_block_num;
+        }
+    }
+}
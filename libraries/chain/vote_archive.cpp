@@ -0,0 +1,419 @@
+#include <steemit/chain/vote_archive.hpp>
+
+#include <fstream>
+#include <mutex>
+
+#define ARCHIVE_RW (std::ios::in | std::ios::out | std::ios::binary)
+#define ARCHIVE_READ (std::ios::in | std::ios::binary)
+#define ARCHIVE_CREATE (std::ios::out | std::ios::binary | std::ios::trunc)
+
+namespace steemit {
+    namespace chain {
+
+        namespace detail {
+            struct vote_archive_header {
+                uint32_t head_block_num = 0;
+                uint64_t votes_size = 0;
+            };
+
+            struct vote_archive_slot {
+                uint64_t head = 0; ///< position + 1 of the first vote of a comment, or of the last vote of a voter
+                uint32_t count = 0;
+            };
+
+            struct vote_archive_record {
+                archived_vote vote;
+                uint64_t prev_by_voter = 0; ///< position + 1 of the previous record of the voter
+            };
+
+            static const uint64_t header_size = sizeof(uint32_t) + sizeof(uint64_t);
+            static const uint64_t slot_size = sizeof(uint64_t) + sizeof(uint32_t);
+            static const uint64_t record_size =
+                    2 * sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t) +
+                    sizeof(int16_t) + sizeof(uint32_t) + sizeof(int8_t) + sizeof(uint64_t);
+
+            class vote_archive_impl {
+            public:
+                vote_archive_header header;
+                std::vector<vote_archive_slot> voter_slots;
+                std::vector<uint32_t> dirty_slots;
+                uint32_t stored_slots = 0;
+                uint64_t comments_size = 0;
+
+                std::fstream main_stream;
+                mutable std::fstream comments_stream;
+                mutable std::fstream votes_stream;
+
+                fc::path main_file;
+                fc::path comments_file;
+                fc::path votes_file;
+
+                bool read_only = false;
+
+                mutable std::mutex mutex;
+
+                template<typename T>
+                static void write_value(std::fstream &s, const T &v) {
+                    s.write((const char *)&v, sizeof(v));
+                }
+
+                template<typename T>
+                static void read_value(std::fstream &s, T &v) {
+                    s.read((char *)&v, sizeof(v));
+                }
+
+                void read_header() {
+                    main_stream.seekg(0);
+                    read_value(main_stream, header.head_block_num);
+                    read_value(main_stream, header.votes_size);
+                }
+
+                /**
+                 * A reader does not keep the voter slots in memory, the writer of another process keeps changing
+                 * them. It reads the header and the size of the comments file again before every lookup and each
+                 * voter slot when it is needed.
+                 */
+                void refresh() {
+                    if (read_only) {
+                        read_header();
+                        comments_size = fc::file_size(comments_file);
+                    }
+                }
+
+                vote_archive_slot voter_slot(uint32_t voter) {
+                    if (!read_only) {
+                        return voter < voter_slots.size() ? voter_slots[voter] : vote_archive_slot();
+                    }
+
+                    vote_archive_slot slot;
+                    uint64_t pos = header_size + uint64_t(voter) * slot_size;
+                    if (pos + slot_size <= fc::file_size(main_file)) {
+                        main_stream.seekg(pos);
+                        read_value(main_stream, slot.head);
+                        read_value(main_stream, slot.count);
+                    }
+                    return slot;
+                }
+
+                void write_header() {
+                    main_stream.seekp(0);
+                    write_value(main_stream, header.head_block_num);
+                    write_value(main_stream, header.votes_size);
+                }
+
+                void write_voter_slot(uint32_t voter) {
+                    main_stream.seekp(header_size + voter * slot_size);
+                    write_value(main_stream, voter_slots[voter].head);
+                    write_value(main_stream, voter_slots[voter].count);
+                }
+
+                void write_comment_slot(uint32_t comment, const vote_archive_slot &slot) {
+                    comments_stream.seekp(uint64_t(comment) * slot_size);
+                    write_value(comments_stream, slot.head);
+                    write_value(comments_stream, slot.count);
+                    comments_size = std::max(comments_size, (uint64_t(comment) + 1) * slot_size);
+                }
+
+                vote_archive_slot read_comment_slot(uint32_t comment) const {
+                    vote_archive_slot slot;
+                    if ((uint64_t(comment) + 1) * slot_size > comments_size) {
+                        return slot;
+                    }
+                    comments_stream.seekg(uint64_t(comment) * slot_size);
+                    read_value(comments_stream, slot.head);
+                    read_value(comments_stream, slot.count);
+
+                    // Written after the last flush of the header and possibly overwritten since
+                    if (slot.head && (slot.head - 1 + slot.count * record_size > header.votes_size ||
+                                      read_record(slot.head - 1).vote.comment != comment)) {
+                        return vote_archive_slot();
+                    }
+                    return slot;
+                }
+
+                void write_record(const vote_archive_record &r) {
+                    votes_stream.seekp(header.votes_size);
+                    write_value(votes_stream, r.vote.comment);
+                    write_value(votes_stream, r.vote.voter);
+                    write_value(votes_stream, r.vote.weight);
+                    write_value(votes_stream, r.vote.rshares);
+                    write_value(votes_stream, r.vote.vote_percent);
+                    write_value(votes_stream, r.vote.last_update.sec_since_epoch());
+                    write_value(votes_stream, r.vote.num_changes);
+                    write_value(votes_stream, r.prev_by_voter);
+                }
+
+                vote_archive_record read_record(uint64_t pos) const {
+                    vote_archive_record r;
+                    uint32_t last_update;
+                    votes_stream.seekg(pos);
+                    read_value(votes_stream, r.vote.comment);
+                    read_value(votes_stream, r.vote.voter);
+                    read_value(votes_stream, r.vote.weight);
+                    read_value(votes_stream, r.vote.rshares);
+                    read_value(votes_stream, r.vote.vote_percent);
+                    read_value(votes_stream, last_update);
+                    read_value(votes_stream, r.vote.num_changes);
+                    read_value(votes_stream, r.prev_by_voter);
+                    r.vote.last_update = time_point_sec(last_update);
+                    return r;
+                }
+
+                void create() {
+                    ilog("Creating vote archive");
+                    header = vote_archive_header();
+                    voter_slots.clear();
+                    dirty_slots.clear();
+                    stored_slots = 0;
+                    comments_size = 0;
+
+                    main_stream.open(main_file.generic_string().c_str(), ARCHIVE_CREATE);
+                    write_header();
+                    main_stream.close();
+
+                    for (const auto &f : {comments_file, votes_file}) {
+                        std::fstream s(f.generic_string().c_str(), ARCHIVE_CREATE);
+                    }
+                }
+
+                bool load() {
+                    if (!fc::exists(main_file) || !fc::exists(comments_file) ||
+                        !fc::exists(votes_file)) {
+                        return false;
+                    }
+
+                    auto main_size = fc::file_size(main_file);
+                    if (main_size < header_size ||
+                        (main_size - header_size) % slot_size) {
+                        return false;
+                    }
+
+                    main_stream.open(main_file.generic_string().c_str(), ARCHIVE_RW);
+                    read_value(main_stream, header.head_block_num);
+                    read_value(main_stream, header.votes_size);
+
+                    stored_slots = (main_size - header_size) / slot_size;
+                    voter_slots.resize(stored_slots);
+                    for (auto &slot : voter_slots) {
+                        read_value(main_stream, slot.head);
+                        read_value(main_stream, slot.count);
+                    }
+                    main_stream.close();
+
+                    auto votes_file_size = fc::file_size(votes_file);
+                    if (votes_file_size < header.votes_size) {
+                        wlog("Vote archive files are truncated");
+                        return false;
+                    }
+                    comments_size = fc::file_size(comments_file);
+
+                    votes_stream.open(votes_file.generic_string().c_str(), ARCHIVE_RW);
+
+                    // Voter slots can be flushed ahead of the header, so unwind every voter which points
+                    // past the last record covered by the header.
+                    for (uint32_t i = 0; i < voter_slots.size(); ++i) {
+                        while (voter_slots[i].head &&
+                               voter_slots[i].head - 1 + record_size > header.votes_size) {
+                            if (voter_slots[i].head - 1 + record_size > votes_file_size) {
+                                wlog("Vote archive slot points outside of votes file");
+                                votes_stream.close();
+                                return false;
+                            }
+                            auto r = read_record(voter_slots[i].head - 1);
+                            voter_slots[i].head = r.prev_by_voter;
+                            voter_slots[i].count--;
+                            dirty_slots.push_back(i);
+                        }
+                    }
+
+                    votes_stream.close();
+
+                    fc::resize_file(votes_file, header.votes_size);
+
+                    return true;
+                }
+            };
+        }
+
+        vote_archive::vote_archive()
+                : my(new detail::vote_archive_impl()) {
+        }
+
+        vote_archive::~vote_archive() {
+            if (is_open()) {
+                flush();
+            }
+        }
+
+        void vote_archive::open(const fc::path &file, bool read_only) {
+            try {
+                close();
+
+                my->main_file = file;
+                my->comments_file = fc::path(file.generic_string() + ".comments");
+                my->votes_file = fc::path(file.generic_string() + ".votes");
+                my->read_only = read_only;
+
+                if (read_only) {
+                    FC_ASSERT(fc::exists(my->main_file) && fc::exists(my->comments_file) && fc::exists(my->votes_file),
+                            "Vote archive does not exist, it is created by the node writing the chain state");
+                } else if (!my->load()) {
+                    my->create();
+                }
+
+                for (auto *s : {&my->main_stream, &my->comments_stream, &my->votes_stream}) {
+                    s->exceptions(std::fstream::failbit | std::fstream::badbit);
+                }
+
+                auto mode = read_only ? ARCHIVE_READ : ARCHIVE_RW;
+                my->main_stream.open(my->main_file.generic_string().c_str(), mode);
+                my->comments_stream.open(my->comments_file.generic_string().c_str(), mode);
+                my->votes_stream.open(my->votes_file.generic_string().c_str(), mode);
+
+                if (read_only) {
+                    my->refresh();
+                }
+
+                ilog("Vote archive head block is ${n}", ("n", my->header.head_block_num));
+            }
+            FC_CAPTURE_AND_RETHROW((file)(read_only))
+        }
+
+        void vote_archive::close() {
+            if (is_open()) {
+                flush();
+            }
+            my.reset(new detail::vote_archive_impl());
+        }
+
+        bool vote_archive::is_open() const {
+            return my->votes_stream.is_open();
+        }
+
+        void vote_archive::append_block(uint32_t block_num, const std::vector<archived_vote> &votes) {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                FC_ASSERT(!my->read_only, "Vote archive is open read only");
+
+                FC_ASSERT(block_num > my->header.head_block_num, "Append to vote archive occuring at wrong block.",
+                        ("block_num", block_num)("head", my->header.head_block_num));
+
+                detail::vote_archive_slot comment_slot;
+                uint32_t comment = 0;
+
+                for (const auto &vote : votes) {
+                    if (comment_slot.count && vote.comment != comment) {
+                        my->write_comment_slot(comment, comment_slot);
+                        comment_slot = detail::vote_archive_slot();
+                    }
+                    if (comment_slot.count == 0) {
+                        FC_ASSERT(my->read_comment_slot(vote.comment).count == 0,
+                                "Votes of comment are already archived", ("comment", vote.comment));
+                        comment = vote.comment;
+                        comment_slot.head = my->header.votes_size + 1;
+                    }
+
+                    if (vote.voter >= my->voter_slots.size()) {
+                        my->voter_slots.resize(vote.voter + 1);
+                    }
+                    auto &voter_slot = my->voter_slots[vote.voter];
+
+                    detail::vote_archive_record r;
+                    r.vote = vote;
+                    r.prev_by_voter = voter_slot.head;
+                    my->write_record(r);
+
+                    voter_slot.head = my->header.votes_size + 1;
+                    voter_slot.count++;
+                    my->dirty_slots.push_back(vote.voter);
+
+                    comment_slot.count++;
+                    my->header.votes_size += detail::record_size;
+                }
+
+                if (comment_slot.count) {
+                    my->write_comment_slot(comment, comment_slot);
+                }
+
+                my->header.head_block_num = block_num;
+            }
+            FC_LOG_AND_RETHROW()
+        }
+
+        void vote_archive::flush() {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            if (my->read_only) {
+                return;
+            }
+
+            // Data must reach the disk before anything that points to it
+            my->votes_stream.flush();
+            my->comments_stream.flush();
+
+            for (uint32_t i = my->stored_slots; i < my->voter_slots.size(); ++i) {
+                my->write_voter_slot(i);
+            }
+            my->stored_slots = my->voter_slots.size();
+
+            for (auto voter : my->dirty_slots) {
+                my->write_voter_slot(voter);
+            }
+            my->main_stream.flush();
+            my->dirty_slots.clear();
+
+            my->write_header();
+            my->main_stream.flush();
+        }
+
+        uint32_t vote_archive::head_block_num() const {
+            std::lock_guard<std::mutex> lock(my->mutex);
+            if (is_open()) {
+                my->refresh();
+            }
+            return my->header.head_block_num;
+        }
+
+        std::vector<archived_vote> vote_archive::get_comment_votes(uint32_t comment) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                std::vector<archived_vote> result;
+
+                if (!is_open()) {
+                    return result;
+                }
+                my->refresh();
+
+                auto slot = my->read_comment_slot(comment);
+                result.reserve(slot.count);
+                for (uint32_t i = 0; i < slot.count; ++i) {
+                    result.push_back(my->read_record(slot.head - 1 + i * detail::record_size).vote);
+                }
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((comment))
+        }
+
+        std::vector<archived_vote> vote_archive::get_account_votes(uint32_t voter) const {
+            try {
+                std::lock_guard<std::mutex> lock(my->mutex);
+                std::vector<archived_vote> result;
+
+                if (!is_open()) {
+                    return result;
+                }
+
+                const auto slot = my->voter_slot(voter);
+                result.reserve(slot.count);
+                uint64_t pos = slot.head;
+                while (pos) {
+                    auto r = my->read_record(pos - 1);
+                    result.push_back(r.vote);
+                    pos = r.prev_by_voter;
+                }
+                return result;
+            }
+            FC_CAPTURE_AND_RETHROW((voter))
+        }
+
+    }
+}
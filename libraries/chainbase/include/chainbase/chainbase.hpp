@@ -521,6 +521,28 @@ namespace chainbase {
             _revision = revision;
         }
 
+        /**
+         *  Collects the ids of the objects created, modified and removed in the most recent undo state,
+         *  returns false if there is no undo state.
+         */
+        bool head_undo_state_ids(std::vector<int64_t> &created, std::vector<int64_t> &modified, std::vector<int64_t> &removed) const {
+            if (!enabled()) {
+                return false;
+            }
+
+            const auto &head = _stack.back();
+            for (const auto &id : head.new_ids) {
+                created.push_back(id._id);
+            }
+            for (const auto &item : head.old_values) {
+                modified.push_back(item.first._id);
+            }
+            for (const auto &item : head.removed_values) {
+                removed.push_back(item.first._id);
+            }
+            return true;
+        }
+
         void remove_object(int64_t id) {
             const value_type *val = find(typename value_type::id_type(id));
             if (!val)
@@ -667,6 +689,8 @@ namespace chainbase {
 
         virtual void remove_object(int64_t id) = 0;
 
+        virtual bool head_undo_state_ids(std::vector<int64_t> &created, std::vector<int64_t> &modified, std::vector<int64_t> &removed) const = 0;
+
         void *get() const {
             return _idx_ptr;
         }
@@ -717,6 +741,10 @@ namespace chainbase {
             return _base.remove_object(id);
         }
 
+        virtual bool head_undo_state_ids(std::vector<int64_t> &created, std::vector<int64_t> &modified, std::vector<int64_t> &removed) const override {
+            return _base.head_undo_state_ids(created, modified, removed);
+        }
+
     private:
         BaseIndex &_base;
     };
@@ -873,6 +901,10 @@ namespace chainbase {
         }
 
 
+        const vector<abstract_index *> &get_index_list() const {
+            return _index_list;
+        }
+
         template<typename MultiIndexType>
         void add_index() {
             const uint16_t type_id = generic_index<MultiIndexType>::value_type::type_id;
@@ -1018,19 +1050,33 @@ namespace chainbase {
             int_incrementer ii( _read_lock_count );
 #endif
 
-            if (!wait_micro) {
-                lock.lock();
-            } else {
+            if (!lock.try_lock()) {
+                auto wait_start = boost::chrono::steady_clock::now();
+                if (!wait_micro) {
+                    lock.lock();
+                } else {
 
-                if (!lock.timed_lock(
-                        boost::posix_time::microsec_clock::local_time() +
-                        boost::posix_time::microseconds(wait_micro)))
-                    BOOST_THROW_EXCEPTION(std::runtime_error("unable to acquire lock"));
+                    if (!lock.timed_lock(
+                            boost::posix_time::microsec_clock::local_time() +
+                            boost::posix_time::microseconds(wait_micro)))
+                        BOOST_THROW_EXCEPTION(std::runtime_error("unable to acquire lock"));
+                }
+                read_lock_wait_micro() += boost::chrono::duration_cast<boost::chrono::microseconds>(
+                        boost::chrono::steady_clock::now() - wait_start).count();
             }
 
             return callback();
         }
 
+        /**
+         * Total time the calling thread has spent waiting for read locks, so callers can tell lock contention
+         * apart from their own work by comparing it before and after.
+         */
+        static uint64_t &read_lock_wait_micro() {
+            static thread_local uint64_t wait = 0;
+            return wait;
+        }
+
         template<typename Lambda>
         auto with_write_lock(Lambda &&callback, uint64_t wait_micro = 1000000) -> decltype((*(Lambda *)nullptr)()) {
             if (_read_only)
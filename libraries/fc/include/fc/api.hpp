@@ -2,6 +2,8 @@
 #include <fc/thread/future.hpp>
 #include <fc/any.hpp>
 #include <functional>
+#include <cstring>
+#include <type_traits>
 #include <boost/config.hpp>
 
 // ms visual c++ (as of 2013) doesn't accept the standard syntax for calling a 
@@ -41,6 +43,15 @@ namespace fc {
   template<typename Interface, typename Transform >
   class api;
 
+  /**
+   * Tells whether a method of Interface only reads state, so it may be executed on another thread
+   * concurrently with other calls.  Specialized by FC_API_READ_ONLY, no method is read only by default.
+   */
+  template<typename Interface>
+  struct api_read_only_methods {
+      static bool contains( const char* name ) { return false; }
+  };
+
   class api_connection;
 
   typedef uint32_t api_id_type;
@@ -67,6 +78,7 @@ namespace fc {
   class api : public api_base {
     public:
       typedef vtable<Interface,Transform> vtable_type;
+      typedef Interface interface_type;
 
       api():_vtable( std::make_shared<vtable_type>() ) {}
 
@@ -132,3 +144,21 @@ namespace fc { \
   }; \
 }  
 
+#define FC_API_READ_ONLY_COMPARE( r, data, elem ) \
+        static_assert( std::is_member_function_pointer<decltype(&data::elem)>::value, \
+                       BOOST_PP_STRINGIZE(elem) " is not a method" ); \
+        if( std::strcmp( name, BOOST_PP_STRINGIZE(elem) ) == 0 ) return true;
+
+/**
+ * Marks METHODS of an api declared with FC_API as read only, see fc::api_read_only_methods.
+ */
+#define FC_API_READ_ONLY( CLASS, METHODS ) \
+namespace fc { \
+  template<> \
+  struct api_read_only_methods<CLASS> { \
+      static bool contains( const char* name ) { \
+        BOOST_PP_SEQ_FOR_EACH( FC_API_READ_ONLY_COMPARE, CLASS, METHODS ) \
+        return false; \
+      } \
+  }; \
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <fc/any.hpp>
 #include <fc/network/ip.hpp>
+#include <fc/optional.hpp>
 #include <fc/signals.hpp>
 
 namespace fc { namespace http {
@@ -39,6 +40,9 @@ namespace fc { namespace http {
 
    typedef std::function<void(const websocket_connection_ptr&)> on_connection_handler;
 
+   /** returns the body to serve for a GET of the resource, or nothing to answer with 404 */
+   typedef std::function<fc::optional<std::string>(const std::string& resource)> http_get_handler;
+
    class websocket_server
    {
       public:
@@ -46,6 +50,7 @@ namespace fc { namespace http {
          ~websocket_server();
 
          void on_connection( const on_connection_handler& handler);
+         void on_http_get( const http_get_handler& handler );
          void listen( uint16_t port );
          void listen( const fc::ip::endpoint& ep );
          void start_accept();
@@ -64,6 +69,7 @@ namespace fc { namespace http {
          ~websocket_tls_server();
 
          void on_connection( const on_connection_handler& handler);
+         void on_http_get( const http_get_handler& handler );
          void listen( uint16_t port );
          void listen( const fc::ip::endpoint& ep );
          void start_accept();
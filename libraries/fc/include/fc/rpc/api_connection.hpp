@@ -116,6 +116,18 @@ namespace fc {
             return _methods[method_id](args);
          }
 
+         bool has_method( const string& name )const
+         {
+            return _by_name.find(name) != _by_name.end();
+         }
+
+         /** true if the method is marked with FC_API_READ_ONLY */
+         bool is_read_only( const string& name )const
+         {
+            auto itr = _by_name.find(name);
+            return itr != _by_name.end() && _read_only[itr->second];
+         }
+
          std::weak_ptr< fc::api_connection > get_connection()
          {
             return _api_connection;
@@ -200,6 +212,7 @@ namespace fc {
          fc::any                                                 _api;
          std::map< std::string, uint32_t >                       _by_name;
          std::vector< std::function<variant(const variants&)> >  _methods;
+         std::vector< bool >                                     _read_only;
    }; // class generic_api
 
 
@@ -226,9 +239,33 @@ namespace fc {
 
          variant receive_call( api_id_type api_id, const string& method_name, const variants& args = variants() )const
          {
-            FC_ASSERT( _local_apis.size() > api_id );
-            return _local_apis[api_id]->call( method_name, args );
+            std::shared_ptr<generic_api> api = local_api_ptr( api_id );
+            if( _call_executor && api->has_method( method_name ) )
+            {
+               // The executor may run the call on another thread past the end of this one, so it owns what it uses
+               return _call_executor( call_info{ api_id, method_name, args, api->is_read_only( method_name ) },
+                                      [api, method_name, args]() { return api->call( method_name, args ); } );
+            }
+            return api->call( method_name, args );
          }
+
+         /** A call received from the remote side, as passed to the call executor */
+         struct call_info
+         {
+            api_id_type      api_id;
+            const string&    method_name;
+            const variants&  args;
+            bool             read_only; ///< the method is marked with FC_API_READ_ONLY
+         };
+
+         typedef std::function<variant(const call_info&, const std::function<variant()>&)> call_executor;
+
+         /**
+          * Runs every received call of an existing method through the executor, which must return its result.
+          * The executor may run calls to read only methods on another thread, other calls have to run on the
+          * calling thread.
+          */
+         void set_call_executor( call_executor executor ) { _call_executor = std::move(executor); }
          variant receive_callback( uint64_t callback_id,  const variants& args = variants() )const
          {
             FC_ASSERT( _local_callbacks.size() > callback_id );
@@ -247,7 +284,11 @@ namespace fc {
             auto itr = _handle_to_id.find(handle);
             if( itr != _handle_to_id.end() ) return itr->second;
 
-            _local_apis.push_back( std::unique_ptr<generic_api>( new generic_api(a, shared_from_this() ) ) );
+            // Binding every method of the api is deferred until it is called, most connections only use a few apis
+            _local_apis.emplace_back();
+            _local_api_factories.push_back( [this, a]() {
+               return std::make_shared<generic_api>( a, shared_from_this() );
+            } );
             _handle_to_id[handle] = _local_apis.size() - 1;
             return _local_apis.size() - 1;
          }
@@ -259,13 +300,28 @@ namespace fc {
             return _local_callbacks.size() - 1;
          }
 
-         std::vector<std::string> get_method_names( api_id_type local_api_id = 0 )const { return _local_apis[local_api_id]->get_method_names(); }
+         std::vector<std::string> get_method_names( api_id_type local_api_id = 0 )const { return local_api( local_api_id ).get_method_names(); }
 
          fc::signal<void()> closed;
       private:
-         std::vector< std::unique_ptr<generic_api> >             _local_apis;
+         generic_api& local_api( api_id_type api_id )const
+         {
+            return *local_api_ptr( api_id );
+         }
+
+         const std::shared_ptr<generic_api>& local_api_ptr( api_id_type api_id )const
+         {
+            FC_ASSERT( _local_apis.size() > api_id );
+            if( !_local_apis[api_id] )
+               _local_apis[api_id] = _local_api_factories[api_id]();
+            return _local_apis[api_id];
+         }
+
+         mutable std::vector< std::shared_ptr<generic_api> >     _local_apis;
+         std::vector< std::function<std::shared_ptr<generic_api>()> > _local_api_factories;
          std::map< uint64_t, api_id_type >                       _handle_to_id;
          std::vector< std::function<variant(const variants&)>  > _local_callbacks;
+         call_executor                                           _call_executor;
 
 
          struct api_visitor
@@ -377,6 +433,10 @@ namespace fc {
    :_api_connection(c),_api(a)
    {
       boost::any_cast<const Api&>(a)->visit( api_visitor( *this, c ) );
+
+      _read_only.resize( _methods.size() );
+      for( const auto& m : _by_name )
+         _read_only[m.second] = api_read_only_methods<typename Api::interface_type>::contains( m.first.c_str() );
    }
 
    template<typename Interface, typename Adaptor, typename ... Args>
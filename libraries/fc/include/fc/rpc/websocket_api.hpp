@@ -24,13 +24,34 @@ namespace fc { namespace rpc {
             uint64_t callback_id,
             variants args = variants() ) override;
 
+         /** called with every request or batch received and the sizes of the message and of its reply */
+         typedef std::function<void(const variant& request, size_t bytes_in, size_t bytes_out)> message_observer;
+
+         void set_message_observer( message_observer observer ) { _message_observer = std::move(observer); }
+
+         /** larger batches are rejected as a whole, before any of their calls runs */
+         void set_max_batch_size( uint32_t max_batch_size ) { _max_batch_size = max_batch_size; }
+
       protected:
          std::string on_message(
             const std::string& message,
             bool send_message = true );
 
+         /** returns the response to a request object, nothing for a notification */
+         optional<variant> on_request( const variant& var );
+
+         /** executes a JSON-RPC batch, returns the array of responses or nothing if all calls were notifications */
+         optional<variant> on_batch( const variants& batch );
+
+         /** the response to a request whose id could not be read, its id is null */
+         static variant null_id_error( const fc::exception& e );
+
+         std::string send_reply( const optional<variant>& reply, bool send_message );
+
          fc::http::websocket_connection&  _connection;
          fc::rpc::state                   _rpc_state;
+         message_observer                 _message_observer;
+         uint32_t                         _max_batch_size = 100;
    };
 
 } } // namespace fc::rpc
@@ -158,8 +158,6 @@ namespace fc { namespace http {
 
             virtual void send_message( const std::string& message )override
             {
-               idump((message));
-               //std::cerr<<"send: "<<message<<"\n";
                auto ec = _ws_connection->send( message );
                FC_ASSERT( !ec, "websocket send failed: ${msg}", ("msg",ec.message() ) );
             }
@@ -173,6 +171,36 @@ namespace fc { namespace http {
 
       typedef websocketpp::lib::shared_ptr<boost::asio::ssl::context> context_ptr;
 
+      /** answers a GET request through the handler, returns false for any other request */
+      template<typename ConnectionPtr>
+      bool serve_http_get( const ConnectionPtr& con, const http_get_handler& handler )
+      {
+         if( con->get_request().get_method() != "GET" )
+            return false;
+
+         optional<std::string> body;
+         if( handler )
+            body = handler( con->get_resource() );
+         if( body )
+         {
+            con->set_body( *body );
+            con->replace_header( "Content-Type", "text/plain" );
+            con->set_status( websocketpp::http::status_code::ok );
+         }
+         else
+            con->set_status( websocketpp::http::status_code::not_found );
+         return true;
+      }
+
+      /** terminates a plain HTTP connection on its io thread, its termination handler ends the API session */
+      template<typename ConnectionPtr>
+      void end_http_connection( const ConnectionPtr& con )
+      {
+         fc::asio::default_io_service().post( [con](){
+            con->terminate( websocketpp::error::make_error_code( websocketpp::error::http_connection_ended ) );
+         });
+      }
+
       class websocket_server_impl
       {
          public:
@@ -193,8 +221,6 @@ namespace fc { namespace http {
                     _server_thread.async( [&](){
                        auto current_con = _connections.find(hdl);
                        assert( current_con != _connections.end() );
-                       wdump(("server")(msg->get_payload()));
-                       //std::cerr<<"recv: "<<msg->get_payload()<<"\n";
                        auto payload = msg->get_payload();
                        std::shared_ptr<websocket_connection> con = current_con->second;
                        ++_pending_messages;
@@ -211,20 +237,33 @@ namespace fc { namespace http {
 
                _server.set_http_handler( [&]( connection_hdl hdl ){
                     _server_thread.async( [&](){
-                       auto current_con = std::make_shared<websocket_connection_impl<websocket_server_type::connection_ptr>>( _server.get_con_from_hdl(hdl) );
-                       _on_connection( current_con );
-
                        auto con = _server.get_con_from_hdl(hdl);
+                       if( serve_http_get( con, _on_http_get ) )
+                          return;
+
+                       // A kept alive connection keeps the API session of its first request
+                       auto session = _http_connections.find(hdl);
+                       if( session == _http_connections.end() )
+                       {
+                          auto new_con = std::make_shared<websocket_connection_impl<websocket_server_type::connection_ptr>>( con );
+                          _on_connection( new_con );
+                          con->set_termination_handler( [this]( websocket_server_type::connection_ptr ended ){
+                             connection_hdl ended_hdl = ended->get_handle();
+                             _server_thread.async( [&](){ http_connection_closed( ended_hdl ); } ).wait();
+                          });
+                          session = _http_connections.emplace( hdl, new_con ).first;
+                       }
+                       std::shared_ptr<websocket_connection> current_con = session->second;
+
                        con->defer_http_response();
                        std::string request_body = con->get_request_body();
-                       wdump(("server")(request_body));
 
                        fc::async([current_con, request_body, con] {
                           std::string response = current_con->on_http(request_body);
                           con->set_body( response );
+                          con->replace_header( "Content-Type", "application/json" );
                           con->set_status( websocketpp::http::status_code::ok );
                           con->send_http_response();
-                          current_con->closed();
                        }, "call on_http");
                     }).wait();
                });
@@ -240,7 +279,7 @@ namespace fc { namespace http {
                        {
                             wlog( "unknown connection closed" );
                        }
-                       if( _connections.empty() && _closed )
+                       if( _connections.empty() && _http_connections.empty() && _closed )
                           _closed->set_value();
                     }).wait();
                });
@@ -258,7 +297,7 @@ namespace fc { namespace http {
                           {
                             wlog( "unknown connection failed" );
                           }
-                          if( _connections.empty() && _closed )
+                          if( _connections.empty() && _http_connections.empty() && _closed )
                              _closed->set_value();
                        }).wait();
                     }
@@ -269,22 +308,41 @@ namespace fc { namespace http {
                if( _server.is_listening() )
                   _server.stop_listening();
 
-               if( _connections.size() )
+               if( _connections.size() || _http_connections.size() )
                   _closed = new fc::promise<void>();
 
                auto cpy_con = _connections;
                for( auto item : cpy_con )
                   _server.close( item.first, 0, "server exit" );
 
+               // Kept alive HTTP connections waiting for their next request
+               auto cpy_http_con = _http_connections;
+               for( auto item : cpy_http_con )
+                  end_http_connection( _server.get_con_from_hdl( item.first ) );
+
                if( _closed ) _closed->wait();
             }
 
+            /** ends the API session of a plain HTTP connection once the connection is gone */
+            void http_connection_closed( connection_hdl hdl )
+            {
+               auto itr = _http_connections.find( hdl );
+               if( itr == _http_connections.end() )
+                  return;
+               itr->second->closed();
+               _http_connections.erase( itr );
+               if( _connections.empty() && _http_connections.empty() && _closed )
+                  _closed->set_value();
+            }
+
             typedef std::map<connection_hdl, websocket_connection_ptr,std::owner_less<connection_hdl> > con_map;
 
             con_map                  _connections;
+            con_map                  _http_connections;
             fc::thread&              _server_thread;
             websocket_server_type    _server;
             on_connection_handler    _on_connection;
+            http_get_handler         _on_http_get;
             fc::promise<void>::ptr   _closed;
             uint32_t                 _pending_messages = 0;
       };
@@ -335,13 +393,25 @@ namespace fc { namespace http {
 
                _server.set_http_handler( [&]( connection_hdl hdl ){
                     _server_thread.async( [&](){
+                       auto con = _server.get_con_from_hdl(hdl);
+                       if( serve_http_get( con, _on_http_get ) )
+                          return;
 
-                       auto current_con = std::make_shared<websocket_connection_impl<websocket_tls_server_type::connection_ptr>>( _server.get_con_from_hdl(hdl) );
+                       // A kept alive connection keeps the API session of its first request
                        try{
-                          _on_connection( current_con );
+                          auto session = _http_connections.find(hdl);
+                          if( session == _http_connections.end() )
+                          {
+                             auto new_con = std::make_shared<websocket_connection_impl<websocket_tls_server_type::connection_ptr>>( con );
+                             _on_connection( new_con );
+                             con->set_termination_handler( [this]( websocket_tls_server_type::connection_ptr ended ){
+                                connection_hdl ended_hdl = ended->get_handle();
+                                _server_thread.async( [&](){ http_connection_closed( ended_hdl ); } ).wait();
+                             });
+                             session = _http_connections.emplace( hdl, new_con ).first;
+                          }
+                          std::shared_ptr<websocket_connection> current_con = session->second;
 
-                          auto con = _server.get_con_from_hdl(hdl);
-                          wdump(("server")(con->get_request_body()));
                           auto response = current_con->on_http( con->get_request_body() );
 
                           con->set_body( response );
@@ -350,7 +420,6 @@ namespace fc { namespace http {
                        {
                          edump((e.to_detail_string()));
                        }
-                       current_con->closed();
 
                     }).wait();
                });
@@ -382,14 +451,38 @@ namespace fc { namespace http {
                auto cpy_con = _connections;
                for( auto item : cpy_con )
                   _server.close( item.first, 0, "server exit" );
+
+               if( _http_connections.size() )
+                  _closed = new fc::promise<void>();
+
+               // Kept alive HTTP connections waiting for their next request
+               auto cpy_http_con = _http_connections;
+               for( auto item : cpy_http_con )
+                  end_http_connection( _server.get_con_from_hdl( item.first ) );
+
+               if( _closed ) _closed->wait();
+            }
+
+            /** ends the API session of a plain HTTP connection once the connection is gone */
+            void http_connection_closed( connection_hdl hdl )
+            {
+               auto itr = _http_connections.find( hdl );
+               if( itr == _http_connections.end() )
+                  return;
+               itr->second->closed();
+               _http_connections.erase( itr );
+               if( _http_connections.empty() && _closed )
+                  _closed->set_value();
             }
 
             typedef std::map<connection_hdl, websocket_connection_ptr,std::owner_less<connection_hdl> > con_map;
 
             con_map                     _connections;
+            con_map                     _http_connections;
             fc::thread&                 _server_thread;
             websocket_tls_server_type   _server;
             on_connection_handler       _on_connection;
+            http_get_handler            _on_http_get;
             fc::promise<void>::ptr      _closed;
       };
 
@@ -598,6 +691,11 @@ namespace fc { namespace http {
       my->_on_connection = handler;
    }
 
+   void websocket_server::on_http_get( const http_get_handler& handler )
+   {
+      my->_on_http_get = handler;
+   }
+
    void websocket_server::listen( uint16_t port )
    {
       my->_server.listen(port);
@@ -622,6 +720,11 @@ namespace fc { namespace http {
       my->_on_connection = handler;
    }
 
+   void websocket_tls_server::on_http_get( const http_get_handler& handler )
+   {
+      my->_on_http_get = handler;
+   }
+
    void websocket_tls_server::listen( uint16_t port )
    {
       my->_server.listen(port);
@@ -1,5 +1,7 @@
 
 #include <fc/rpc/websocket_api.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/variant_object.hpp>
 
 namespace fc { namespace rpc {
 
@@ -85,72 +87,130 @@ std::string websocket_api_connection::on_message(
    const std::string& message,
    bool send_message /* = true */ )
 {
-   wdump((message));
    try
    {
       auto var = fc::json::from_string(message);
-      const auto& var_obj = var.get_object();
-      if( var_obj.contains( "method" ) )
+      std::string reply;
+      if( var.is_array() )
+         reply = send_reply( on_batch( var.get_array() ), send_message );
+      else if( var.get_object().contains( "method" ) )
+         reply = send_reply( on_request( var ), send_message );
+      else
+      {
+         auto response = var.as<fc::rpc::response>();
+         _rpc_state.handle_reply( response );
+         return string();
+      }
+
+      if( _message_observer )
+         _message_observer( var, message.size(), reply.size() );
+      return reply;
+   }
+   catch ( const fc::exception& e )
+   {
+      wdump((e.to_detail_string()));
+      return e.to_detail_string();
+   }
+   return string();
+}
+
+optional<variant> websocket_api_connection::on_request( const variant& var )
+{
+   auto call = var.as<fc::rpc::request>();
+   exception_ptr optexcept;
+   try
+   {
+      try
       {
-         auto call = var.as<fc::rpc::request>();
-         exception_ptr optexcept;
-         try
-         {
-            try
-            {
 #ifdef LOG_LONG_API
-               auto start = time_point::now();
+         auto start = time_point::now();
 #endif
 
-               auto result = _rpc_state.local_call( call.method, call.params );
+         auto result = _rpc_state.local_call( call.method, call.params );
 
 #ifdef LOG_LONG_API
-               auto end = time_point::now();
+         auto end = time_point::now();
 
-               if( end - start > fc::milliseconds( LOG_LONG_API_MAX_MS ) )
-                  elog( "API call execution time limit exceeded. method: ${m} params: ${p} time: ${t}", ("m",call.method)("p",call.params)("t", end - start) );
-               else if( end - start > fc::milliseconds( LOG_LONG_API_WARN_MS ) )
-                  wlog( "API call execution time nearing limit. method: ${m} params: ${p} time: ${t}", ("m",call.method)("p",call.params)("t", end - start) );
+         if( end - start > fc::milliseconds( LOG_LONG_API_MAX_MS ) )
+            elog( "API call execution time limit exceeded. method: ${m} params: ${p} time: ${t}", ("m",call.method)("p",call.params)("t", end - start) );
+         else if( end - start > fc::milliseconds( LOG_LONG_API_WARN_MS ) )
+            wlog( "API call execution time nearing limit. method: ${m} params: ${p} time: ${t}", ("m",call.method)("p",call.params)("t", end - start) );
 #endif
 
-               if( call.id )
-               {
-                  auto reply = fc::json::to_string( response( *call.id, result ) );
-                  if( send_message )
-                     _connection.send_message( reply );
-                  return reply;
-               }
-            }
-            FC_CAPTURE_AND_RETHROW( (call.method)(call.params) )
-         }
-         catch ( const fc::exception& e )
-         {
-            if( call.id )
-            {
-               optexcept = e.dynamic_copy_exception();
-            }
-         }
-         if( optexcept ) {
-
-               auto reply = fc::json::to_string( response( *call.id,  error_object{ 1, optexcept->to_detail_string(), fc::variant(*optexcept)}  ) );
-               if( send_message )
-                  _connection.send_message( reply );
-
-               return reply;
-         }
+         if( call.id )
+            return variant( response( *call.id, result ) );
       }
-      else
+      FC_CAPTURE_AND_RETHROW( (call.method)(call.params) )
+   }
+   catch ( const fc::exception& e )
+   {
+      if( call.id )
       {
-         auto reply = var.as<fc::rpc::response>();
-         _rpc_state.handle_reply( reply );
+         optexcept = e.dynamic_copy_exception();
       }
    }
-   catch ( const fc::exception& e )
+   if( optexcept )
+      return variant( response( *call.id, error_object{ 1, optexcept->to_detail_string(), fc::variant(*optexcept)} ) );
+
+   return optional<variant>();
+}
+
+optional<variant> websocket_api_connection::on_batch( const variants& batch )
+{
+   FC_ASSERT( batch.size(), "Empty batch request" );
+   if( batch.size() > _max_batch_size )
    {
-      wdump((e.to_detail_string()));
-      return e.to_detail_string();
+      // Rejected as a whole with a single error, as an invalid request
+      fc::assert_exception e( FC_LOG_MESSAGE( error, "Batch of ${n} requests is too large, at most ${max} are allowed",
+                                              ("n",batch.size())("max",_max_batch_size) ) );
+      return null_id_error( e );
    }
-   return string();
+
+   // Calls of a batch run concurrently, read only ones on the threads of the read only executor
+   std::vector< fc::future< optional<variant> > > calls;
+   calls.reserve( batch.size() );
+   for( const auto& item : batch )
+      calls.push_back( fc::async( [this,&item]() { return on_request( item ); }, "batch rpc call" ) );
+
+   variants responses;
+   responses.reserve( batch.size() );
+   for( auto& call : calls )
+   {
+      optional<variant> reply;
+      try
+      {
+         reply = call.wait();
+      }
+      catch ( const fc::exception& e )
+      {
+         // Not a valid request object, its id is unknown
+         reply = null_id_error( e );
+      }
+      if( reply )
+         responses.push_back( std::move(*reply) );
+   }
+
+   // A batch of notifications gets no reply
+   if( responses.empty() )
+      return optional<variant>();
+   return variant( std::move(responses) );
+}
+
+variant websocket_api_connection::null_id_error( const fc::exception& e )
+{
+   return mutable_variant_object( "id", variant() )
+                                ( "error", error_object{ 1, e.to_detail_string(), fc::variant(e)} );
+}
+
+std::string websocket_api_connection::send_reply( const optional<variant>& reply, bool send_message )
+{
+   if( !reply )
+      return string();
+
+   auto message = fc::json::to_string( *reply );
+   if( send_message )
+      _connection.send_message( message );
+   return message;
 }
 
 } } // namespace fc::rpc
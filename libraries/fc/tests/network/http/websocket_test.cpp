@@ -1,9 +1,24 @@
 #include <boost/test/unit_test.hpp>
 
+#include <fc/api.hpp>
+#include <fc/network/http/connection.hpp>
 #include <fc/network/http/websocket.hpp>
+#include <fc/network/ip.hpp>
+#include <fc/rpc/websocket_api.hpp>
 
 #include <iostream>
 
+namespace {
+   class batch_calculator
+   {
+      public:
+         int32_t add( int32_t a, int32_t b ) { return a + b; }
+         int32_t sub( int32_t a, int32_t b ) { return a - b; }
+   };
+}
+
+FC_API( batch_calculator, (add)(sub) )
+
 BOOST_AUTO_TEST_SUITE(fc_network)
 
 BOOST_AUTO_TEST_CASE(websocket_test)
@@ -67,4 +82,102 @@ BOOST_AUTO_TEST_CASE(websocket_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(http_batch_and_keep_alive_test)
+{
+    fc::api<batch_calculator> calc( std::make_shared<batch_calculator>() );
+    uint32_t sessions = 0;
+    uint32_t closed_sessions = 0;
+    fc::http::websocket_server server;
+    server.on_connection([&]( const fc::http::websocket_connection_ptr& c ){
+            ++sessions;
+            c->closed.connect( [&](){ ++closed_sessions; } );
+            auto wsc = std::make_shared<fc::rpc::websocket_api_connection>( *c );
+            wsc->register_api( calc );
+            wsc->set_max_batch_size( 3 );
+            c->set_session_data( wsc );
+        });
+    server.listen( 8091 );
+    server.start_accept();
+
+    fc::http::connection client;
+    client.connect_to( fc::ip::endpoint::from_string( "127.0.0.1:8091" ) );
+    auto post = [&]( const std::string& body ) {
+        auto reply = client.request( "POST", "http://127.0.0.1:8091/", body );
+        BOOST_REQUIRE_EQUAL( reply.status, fc::http::reply::OK );
+        return fc::json::from_string( std::string( reply.body.begin(), reply.body.end() ) );
+    };
+
+    // Responses come in the order of the requests, notifications get none, an invalid item is answered with a null id
+    auto replies = post( R"([{"id":1,"method":"add","params":[1,2]},{"method":"add","params":[1,1]},5])" ).get_array();
+    auto local = client.get_socket().local_endpoint();
+    BOOST_REQUIRE_EQUAL( replies.size(), 2u );
+    BOOST_CHECK_EQUAL( replies[0]["id"].as_int64(), 1 );
+    BOOST_CHECK_EQUAL( replies[0]["result"].as_int64(), 3 );
+    BOOST_CHECK( replies[1]["id"].is_null() );
+    BOOST_CHECK( replies[1].get_object().contains( "error" ) );
+
+    // A batch larger than the limit is rejected as a whole
+    auto rejected = post( R"([{"id":1,"method":"add","params":[1,2]},{"id":2,"method":"add","params":[1,2]},)"
+                          R"({"id":3,"method":"add","params":[1,2]},{"id":4,"method":"sub","params":[1,2]}])" );
+    BOOST_REQUIRE( rejected.is_object() );
+    BOOST_CHECK( rejected["id"].is_null() );
+    BOOST_CHECK( rejected.get_object().contains( "error" ) );
+
+    // Every request was served on the same connection
+    auto single = post( R"({"id":7,"method":"sub","params":[5,3]})" );
+    BOOST_CHECK_EQUAL( single["id"].as_int64(), 7 );
+    BOOST_CHECK_EQUAL( single["result"].as_int64(), 2 );
+    BOOST_CHECK( client.get_socket().local_endpoint() == local );
+
+    // and by the API session of the first request, which ends with the connection
+    BOOST_CHECK_EQUAL( sessions, 1u );
+    BOOST_CHECK_EQUAL( closed_sessions, 0u );
+    client.get_socket().close();
+    fc::usleep( fc::milliseconds(500) );
+    BOOST_CHECK_EQUAL( closed_sessions, 1u );
+}
+
+BOOST_AUTO_TEST_CASE(lazy_api_binding_test)
+{
+    fc::api<batch_calculator> calc( std::make_shared<batch_calculator>() );
+    fc::api<batch_calculator> other( std::make_shared<batch_calculator>() );
+    std::shared_ptr<fc::rpc::websocket_api_connection> wsc;
+    fc::api_id_type calc_id = 0, other_id = 0, again_id = 0;
+    fc::http::websocket_server server;
+    server.on_connection([&]( const fc::http::websocket_connection_ptr& c ){
+            wsc = std::make_shared<fc::rpc::websocket_api_connection>( *c );
+            calc_id = wsc->register_api( calc );
+            other_id = wsc->register_api( other );
+            again_id = wsc->register_api( calc );
+            c->set_session_data( wsc );
+        });
+    server.listen( 8092 );
+    server.start_accept();
+
+    fc::http::connection client;
+    client.connect_to( fc::ip::endpoint::from_string( "127.0.0.1:8092" ) );
+    auto post = [&]( const std::string& body ) {
+        auto reply = client.request( "POST", "http://127.0.0.1:8092/", body );
+        BOOST_REQUIRE_EQUAL( reply.status, fc::http::reply::OK );
+        return fc::json::from_string( std::string( reply.body.begin(), reply.body.end() ) );
+    };
+
+    // An api registered twice keeps its id, every api gets its own id before any of them is bound
+    auto first = post( R"({"id":1,"method":"call","params":[1,"sub",[5,3]]})" );
+    BOOST_CHECK_EQUAL( calc_id, 0u );
+    BOOST_CHECK_EQUAL( other_id, 1u );
+    BOOST_CHECK_EQUAL( again_id, calc_id );
+
+    // Each api is bound on its first call, whatever the order of registration
+    BOOST_CHECK_EQUAL( first["result"].as_int64(), 2 );
+    auto second = post( R"({"id":2,"method":"call","params":[0,"add",[1,2]]})" );
+    BOOST_CHECK_EQUAL( second["result"].as_int64(), 3 );
+    BOOST_REQUIRE( wsc );
+    BOOST_CHECK_EQUAL( wsc->get_method_names( other_id ).size(), 2u );
+
+    // Calling an api which was never registered fails
+    auto unknown = post( R"({"id":3,"method":"call","params":[2,"add",[1,2]]})" );
+    BOOST_CHECK( unknown.get_object().contains( "error" ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
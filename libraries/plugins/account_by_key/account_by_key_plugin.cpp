@@ -251,7 +251,7 @@ namespace steemit {
         }
 
         void account_by_key_plugin::plugin_startup() {
-            app().register_api_factory<account_by_key_api>("account_by_key_api");
+            app().register_shared_api_factory<account_by_key_api>("account_by_key_api");
         }
 
     }
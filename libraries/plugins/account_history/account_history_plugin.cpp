@@ -1,7 +1,5 @@
 #include <steemit/account_history/account_history_plugin.hpp>
 
-#include <steemit/app/impacted.hpp>
-
 #include <steemit/chain/operation_notification.hpp>
 #include <steemit/chain/history_object.hpp>
 
@@ -77,12 +75,19 @@ namespace steemit {
                     if (hist_itr != hist_idx.end() &&
                         hist_itr->account == item) {
                             sequence = hist_itr->sequence + 1;
+                    } else if (_db.store_account_history()) {
+                        // Older operations of the account have been moved to the history log
+                        const auto *account = _db.find_account(item);
+                        if (account != nullptr) {
+                            sequence = _db.get_history_log().get_account_sequence(account->id._id);
+                        }
                     }
 
                     _db.create<account_history_object>([&](account_history_object &ahist) {
                         ahist.account = item;
                         ahist.sequence = sequence;
                         ahist.op = new_obj->id;
+                        ahist.op_type = _note.op.which();
                     });
                 }
             };
@@ -173,13 +178,11 @@ namespace steemit {
             };
 
             void account_history_plugin_impl::on_operation(const operation_notification &note) {
-                flat_set<account_name_type> impacted;
                 steemit::chain::database &db = database();
 
                 const operation_object *new_obj = nullptr;
-                app::operation_get_impacted_accounts(note.op, impacted);
 
-                for (const auto &item : impacted) {
+                for (const auto &item : note.impacted_accounts()) {
                     auto itr = _tracked_accounts.lower_bound(item);
                     if (!_tracked_accounts.size() ||
                         (itr != _tracked_accounts.end() && itr->first <= item &&
@@ -214,7 +217,8 @@ namespace steemit {
         ) {
             cli.add_options()
                     ("track-account-range", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(), "Defines a range of accounts to track as a json pair [\"from\",\"to\"] [from,to]")
-                    ("filter-posting-ops", "Ignore posting operations, only track transfers and account updates");
+                    ("filter-posting-ops", "Ignore posting operations, only track transfers and account updates")
+                    ("store-account-history", boost::program_options::value<bool>()->default_value(true), "Keep history of irreversible blocks in an on-disk log instead of shared memory");
             cfg.add(cli);
         }
 
@@ -227,6 +231,10 @@ namespace steemit {
             if (options.count("filter-posting-ops")) {
                 my->_filter_content = true;
             }
+            database().set_operation_history_filtered(my->_filter_content || !my->_tracked_accounts.empty());
+            if (options.count("store-account-history")) {
+                database().set_store_account_history(options["store-account-history"].as<bool>());
+            }
         }
 
         void account_history_plugin::plugin_startup() {
@@ -86,7 +86,7 @@ namespace steemit {
         void account_statistics_plugin::plugin_startup() {
             ilog("account_stats plugin: plugin_startup() begin");
 
-            app().register_api_factory<account_statistics_api>("account_stats_api");
+            app().register_shared_api_factory<account_statistics_api>("account_stats_api");
 
             ilog("account_stats plugin: plugin_startup() end");
         }
@@ -21,7 +21,7 @@ namespace steemit {
             }
 
             void auth_util_plugin::plugin_startup() {
-                app().register_api_factory<auth_util_api>("auth_util_api");
+                app().register_shared_api_factory<auth_util_api>("auth_util_api");
             }
 
             void auth_util_plugin::plugin_shutdown() {
@@ -33,40 +33,34 @@ namespace steemit {
                 }
 
                 void block_info_api_impl::get_block_info(const get_block_info_args &args, std::vector<block_info> &result) {
-                    const std::vector<block_info> &_block_info = get_plugin()->_block_info;
-
                     FC_ASSERT(args.start_block_num > 0);
                     FC_ASSERT(args.count <= 10000);
-                    uint32_t n = std::min(uint32_t(_block_info.size()),
-                            args.start_block_num + args.count);
-                    for (uint32_t block_num = args.start_block_num;
-                         block_num < n; block_num++) {
-                             result.emplace_back(_block_info[block_num]);
-                    }
+                    result = get_plugin()->get_block_info(args.start_block_num, args.start_block_num + args.count);
                     return;
                 }
 
                 void block_info_api_impl::get_blocks_with_info(const get_block_info_args &args, std::vector<block_with_info> &result) {
-                    const std::vector<block_info> &_block_info = get_plugin()->_block_info;
                     const chain::database &db = get_plugin()->database();
 
                     FC_ASSERT(args.start_block_num > 0);
                     FC_ASSERT(args.count <= 10000);
-                    uint32_t n = std::min(uint32_t(_block_info.size()),
-                            args.start_block_num + args.count);
+                    std::vector<block_info> infos = get_plugin()->get_block_info(args.start_block_num, args.start_block_num + args.count);
                     uint64_t total_size = 0;
-                    for (uint32_t block_num = args.start_block_num;
-                         block_num < n; block_num++) {
-                        uint64_t new_size =
-                                total_size + _block_info[block_num].block_size;
+                    for (uint32_t i = 0; i < infos.size(); i++) {
+                        uint32_t block_num = args.start_block_num + i;
+                        uint64_t new_size = total_size + infos[i].block_size;
                         if ((new_size > 8 * 1024 * 1024) &&
                             (block_num != args.start_block_num)) {
                                 break;
                         }
+                        auto block = db.fetch_block_by_number(block_num);
+                        if (!block) {
+                            break;
+                        }
                         total_size = new_size;
                         result.emplace_back();
-                        result.back().block = *db.fetch_block_by_number(block_num);
-                        result.back().info = _block_info[block_num];
+                        result.back().block = *block;
+                        result.back().info = infos[i];
                     }
                     return;
                 }
@@ -1,4 +1,5 @@
 
+#include <steemit/app/plugin_pipeline.hpp>
 #include <steemit/chain/database.hpp>
 
 #include <steemit/plugins/block_info/block_info.hpp>
@@ -9,6 +10,27 @@ namespace steemit {
     namespace plugin {
         namespace block_info {
 
+            namespace detail {
+
+                class block_info_consumer : public steemit::app::pipeline_consumer {
+                public:
+                    block_info_consumer(block_info_plugin &plugin)
+                            : _plugin(plugin) {
+                    }
+
+                    virtual void on_apply_block(const chain::block_notification &note) override {
+                        _plugin.record_block(note.block, note.props);
+                    }
+
+                    virtual void on_pop_block(const chain::signed_block &block) override {
+                        _plugin.pop_block(block);
+                    }
+
+                    block_info_plugin &_plugin;
+                };
+
+            }
+
             block_info_plugin::block_info_plugin(application *app)
                     : plugin(app) {
             }
@@ -21,28 +43,37 @@ namespace steemit {
             }
 
             void block_info_plugin::plugin_initialize(const boost::program_options::variables_map &options) {
+                if (app().is_plugin_async(plugin_name())) {
+                    app().get_plugin_pipeline()->add_consumer(plugin_name(), std::make_shared<detail::block_info_consumer>(*this));
+                    return;
+                }
+
                 chain::database &db = database();
 
                 _applied_block_conn = db.applied_block.connect([this](const chain::signed_block &b) { on_applied_block(b); });
             }
 
             void block_info_plugin::plugin_startup() {
-                app().register_api_factory<block_info_api>("block_info_api");
+                app().register_shared_api_factory<block_info_api>("block_info_api");
             }
 
             void block_info_plugin::plugin_shutdown() {
             }
 
             void block_info_plugin::on_applied_block(const chain::signed_block &b) {
+                record_block(b, database().get_dynamic_global_properties());
+            }
+
+            void block_info_plugin::record_block(const chain::signed_block &b, const chain::dynamic_global_property_object &dgpo) {
                 uint32_t block_num = b.block_num();
-                const chain::database &db = database();
+
+                std::lock_guard<std::mutex> lock(_block_info_mutex);
 
                 while (block_num >= _block_info.size()) {
                     _block_info.emplace_back();
                 }
 
                 block_info &info = _block_info[block_num];
-                const chain::dynamic_global_property_object &dgpo = db.get_dynamic_global_properties();
 
                 info.block_id = b.id();
                 info.block_size = fc::raw::pack_size(b);
@@ -53,6 +84,26 @@ namespace steemit {
                 return;
             }
 
+            void block_info_plugin::pop_block(const chain::signed_block &b) {
+                std::lock_guard<std::mutex> lock(_block_info_mutex);
+
+                if (b.block_num() < _block_info.size()) {
+                    _block_info.resize(b.block_num());
+                }
+            }
+
+            std::vector<block_info> block_info_plugin::get_block_info(uint32_t start_block_num, uint32_t end_block_num) const {
+                std::vector<block_info> result;
+
+                std::lock_guard<std::mutex> lock(_block_info_mutex);
+
+                uint32_t n = std::min(uint32_t(_block_info.size()), end_block_num);
+                for (uint32_t block_num = start_block_num; block_num < n; block_num++) {
+                    result.emplace_back(_block_info[block_num]);
+                }
+                return result;
+            }
+
         }
     }
 } // steemit::plugin::block_info
@@ -4,6 +4,7 @@
 #include <steemit/app/plugin.hpp>
 #include <steemit/plugins/block_info/block_info.hpp>
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -35,7 +36,24 @@ namespace steemit {
 
                 void on_applied_block(const chain::signed_block &b);
 
+                /**
+                 * Record the info of a block from the global properties right after it was applied.
+                 */
+                void record_block(const chain::signed_block &b, const chain::dynamic_global_property_object &dgpo);
+
+                /**
+                 * Forget the info of a block popped from the chain, only used when consuming blocks
+                 * through the plugin pipeline.
+                 */
+                void pop_block(const chain::signed_block &b);
+
+                /**
+                 * Return info of the blocks in [start_block_num, end_block_num), as far as known.
+                 */
+                std::vector<block_info> get_block_info(uint32_t start_block_num, uint32_t end_block_num) const;
+
                 std::vector<block_info> _block_info;
+                mutable std::mutex _block_info_mutex;
 
                 boost::signals2::scoped_connection _applied_block_conn;
             };
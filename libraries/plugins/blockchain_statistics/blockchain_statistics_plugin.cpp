@@ -362,7 +362,7 @@ namespace steemit {
                     for (auto bucket_id : _current_buckets) {
                         const auto &bucket = db.get(bucket_id);
 
-                        if (!is_virtual_operation(o.op)) {
+                        if (!o.is_virtual()) {
                             db.modify(bucket, [&](bucket_object &b) {
                                 b.operations++;
                             });
@@ -423,7 +423,7 @@ namespace steemit {
         void blockchain_statistics_plugin::plugin_startup() {
             ilog("chain_stats plugin: plugin_startup() begin");
 
-            app().register_api_factory<blockchain_statistics_api>("chain_stats_api");
+            app().register_shared_api_factory<blockchain_statistics_api>("chain_stats_api");
 
             ilog("chain_stats plugin: plugin_startup() end");
         }
@@ -156,7 +156,8 @@ namespace steemit {
                        results.size() < limit) {
                     const auto &comment = db.get(itr->comment);
                     comment_feed_entry entry;
-                    entry.comment = comment;
+                    entry.comment = comment_api_obj(comment, db);
+                    entry.comment.set_content(db.get_comment_content(comment));
                     entry.entry_id = itr->account_feed_id;
                     if (itr->first_reblogged_by != account_name_type()) {
                         //entry.reblog_by = itr->first_reblogged_by;
@@ -226,7 +227,8 @@ namespace steemit {
                        results.size() < limit) {
                     const auto &comment = db.get(itr->comment);
                     comment_blog_entry entry;
-                    entry.comment = comment;
+                    entry.comment = comment_api_obj(comment, db);
+                    entry.comment.set_content(db.get_comment_content(comment));
                     entry.blog = account;
                     entry.reblog_on = itr->reblogged_on;
                     entry.entry_id = itr->blog_feed_id;
@@ -376,7 +376,7 @@ namespace steemit {
         }
 
         void follow_plugin::plugin_startup() {
-            app().register_api_factory<follow_api>("follow_api");
+            app().register_shared_api_factory<follow_api>("follow_api");
         }
 
     }
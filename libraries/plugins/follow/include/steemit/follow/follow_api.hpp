@@ -133,3 +133,16 @@ FC_API(steemit::follow::follow_api,
                 (get_reblogged_by)
                 (get_blog_authors)
 )
+
+FC_API_READ_ONLY(steemit::follow::follow_api,
+        (get_followers)
+                (get_following)
+                (get_follow_count)
+                (get_feed_entries)
+                (get_feed)
+                (get_blog_entries)
+                (get_blog)
+                (get_account_reputations)
+                (get_reblogged_by)
+                (get_blog_authors)
+)
@@ -131,4 +131,14 @@ FC_API(steemit::market_history::market_history_api,
                 (get_recent_trades)
                 (get_market_history)
                 (get_market_history_buckets)
+);
+
+FC_API_READ_ONLY(steemit::market_history::market_history_api,
+        (get_ticker)
+                (get_volume)
+                (get_order_book)
+                (get_trade_history)
+                (get_recent_trades)
+                (get_market_history)
+                (get_market_history_buckets)
 );
\ No newline at end of file
@@ -58,6 +58,8 @@ namespace steemit {
 
             virtual void plugin_startup() override;
 
+            virtual bool plugin_reindex() override;
+
             flat_set<uint32_t> get_tracked_buckets() const;
 
             uint32_t get_max_history_per_bucket() const;
@@ -198,11 +198,21 @@ namespace steemit {
         void market_history_plugin::plugin_startup() {
             ilog("market_history plugin: plugin_startup() begin");
 
-            app().register_api_factory<market_history_api>("market_history_api");
+            app().register_shared_api_factory<market_history_api>("market_history_api");
 
             ilog("market_history plugin: plugin_startup() end");
         }
 
+        bool market_history_plugin::plugin_reindex() {
+            chain::database &db = database();
+
+            wipe_plugin_index<bucket_index>(db);
+            wipe_plugin_index<order_history_index>(db);
+
+            db.replay_operation_history([&](const operation_notification &o) { _my->update_market_histories(o); });
+            return true;
+        }
+
         flat_set<uint32_t> market_history_plugin::get_tracked_buckets() const {
             return _my->_tracked_buckets;
         }
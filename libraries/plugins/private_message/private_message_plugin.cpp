@@ -125,7 +125,7 @@ namespace steemit {
             chain::database &db = database();
             add_plugin_index<message_index>(db);
 
-            app().register_api_factory<private_message_api>("private_message_api");
+            app().register_shared_api_factory<private_message_api>("private_message_api");
 
             typedef pair<string, string> pairstring;
             LOAD_VALUE_SET(options, "pm-accounts", my->_tracked_accounts, pairstring);
@@ -21,7 +21,7 @@ namespace steemit {
             }
 
             void raw_block_plugin::plugin_startup() {
-                app().register_api_factory<raw_block_api>("raw_block_api");
+                app().register_shared_api_factory<raw_block_api>("raw_block_api");
             }
 
             void raw_block_plugin::plugin_shutdown() {
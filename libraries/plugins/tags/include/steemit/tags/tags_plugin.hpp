@@ -593,6 +593,8 @@ namespace steemit {
 
             virtual void plugin_startup() override;
 
+            virtual bool plugin_reindex() override;
+
             friend class detail::tags_plugin_impl;
 
             std::unique_ptr<detail::tags_plugin_impl> my;
@@ -19,6 +19,8 @@
 #include <boost/range/iterator_range.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <set>
+
 namespace steemit {
     namespace tags {
 
@@ -38,7 +40,11 @@ namespace steemit {
                     return _self.database();
                 }
 
-                void on_operation(const operation_notification &note);
+                /**
+                 * @param paid_out when replaying the history, comments whose first payout has been replayed
+                 */
+                void on_operation(const operation_notification &note,
+                        const std::set<comment_id_type> *paid_out = nullptr);
 
                 tags_plugin &_self;
             };
@@ -48,12 +54,16 @@ namespace steemit {
             }
 
             struct operation_visitor {
-                operation_visitor(database &db) : _db(db) {
+                operation_visitor(database &db, const std::set<comment_id_type> *paid_out = nullptr)
+                        : _db(db), _paid_out(paid_out) {
                 };
                 typedef void result_type;
 
                 database &_db;
 
+                /// Set when replaying, as tags then already reflect the current mode of their comments
+                const std::set<comment_id_type> *_paid_out;
+
                 void remove_stats(const tag_object &tag, const tag_stats_object &stats) const {
                     _db.modify(stats, [&](tag_stats_object &s) {
                         if (tag.parent == comment_id_type()) {
@@ -106,10 +116,11 @@ namespace steemit {
 
                 comment_metadata filter_tags(const comment_object &c) const {
                     comment_metadata meta;
+                    const auto json_metadata = _db.get_comment_content(c).json_metadata;
 
-                    if (c.json_metadata.size()) {
+                    if (json_metadata.size()) {
                         try {
-                            meta = fc::json::from_string(to_string(c.json_metadata)).as<comment_metadata>();
+                            meta = fc::json::from_string(json_metadata).as<comment_metadata>();
                         }
                         catch (const fc::exception &e) {
                             // Do nothing on malformed json_metadata
@@ -117,8 +128,9 @@ namespace steemit {
                     }
 
                     set<string> lower_tags;
-                    if (c.category != "") {
-                        meta.tags.insert(fc::to_lower(to_string(c.category)));
+                    const auto &category = _db.get_interned_string(c.category);
+                    if (category.size()) {
+                        meta.tags.insert(fc::to_lower(to_string(category)));
                     }
 
                     uint8_t tag_limit = 5;
@@ -176,7 +188,7 @@ namespace steemit {
                     account_id_type author = _db.get_account(comment.author).id;
 
                     if (comment.parent_author.size()) {
-                        parent = _db.get_comment(comment.parent_author, comment.parent_permlink).id;
+                        parent = _db.get_parent_comment(comment).id;
                     }
 
                     const auto &tag_obj = _db.create<tag_object>([&](tag_object &obj) {
@@ -274,7 +286,7 @@ namespace steemit {
                         }
 
                         if (c.parent_author.size()) {
-                            update_tags(_db.get_comment(c.parent_author, c.parent_permlink));
+                            update_tags(_db.get_parent_comment(c));
                         }
                     } FC_CAPTURE_LOG_AND_RETHROW((c))
                 }
@@ -349,12 +361,13 @@ namespace steemit {
 
                             auto c = _db.find_comment(acnt, perm);
                             if (c && c->parent_author.size() == 0) {
+                                bool replayed_first_payout = _paid_out != nullptr && _paid_out->count(c->id) == 0;
                                 const auto &comment_idx = _db.get_index<tag_index>().indices().get<by_comment>();
                                 auto citr = comment_idx.lower_bound(c->id);
                                 while (citr != comment_idx.end() &&
                                        citr->comment == c->id) {
                                     _db.modify(*citr, [&](tag_object &t) {
-                                        if (t.mode == first_payout) {
+                                        if (_paid_out != nullptr ? replayed_first_payout : t.mode == first_payout) {
                                             t.promoted_balance += op.amount.amount;
                                         }
                                     });
@@ -416,10 +429,11 @@ namespace steemit {
             };
 
 
-            void tags_plugin_impl::on_operation(const operation_notification &note) {
+            void tags_plugin_impl::on_operation(const operation_notification &note,
+                    const std::set<comment_id_type> *paid_out) {
                 try {
                     /// plugins shouldn't ever throw
-                    note.op.visit(operation_visitor(database()));
+                    note.op.visit(operation_visitor(database(), paid_out));
                 }
                 catch (const fc::exception &e) {
                     edump((e.to_detail_string()));
@@ -453,13 +467,53 @@ namespace steemit {
             ilog("Intializing tags plugin");
             database().post_apply_operation.connect([&](const operation_notification &note) { my->on_operation(note); });
 
-            app().register_api_factory<tag_api>("tag_api");
+            app().register_shared_api_factory<tag_api>("tag_api");
         }
 
 
         void tags_plugin::plugin_startup() {
         }
 
+        /**
+         * Tags are derived from the current state of comments, so they are rebuilt from the comments directly.
+         * Only promotions and payouts, which are not kept in the chain state, are replayed from the history.
+         * Peer stats can't be derived from either and are kept as they are.
+         */
+        bool tags_plugin::plugin_reindex() {
+            chain::database &db = database();
+
+            wipe_plugin_index<tag_index>(db);
+            wipe_plugin_index<tag_stats_index>(db);
+            wipe_plugin_index<author_tag_stats_index>(db);
+
+            detail::operation_visitor visitor(db);
+            for (const auto &c : db.get_index<comment_index>().indices()) {
+                try {
+                    visitor.update_tags(c);
+                }
+                catch (const fc::exception &e) {
+                    edump((e.to_detail_string()));
+                }
+            }
+
+            // A promotion counts only while the comment waits for its first payout, which ends with the first
+            // payout update of the comment
+            std::set<comment_id_type> paid_out;
+            db.replay_operation_history([&](const operation_notification &note) {
+                if (note.op.which() == operation::tag<comment_payout_update_operation>::value) {
+                    const auto &op = note.op.get<comment_payout_update_operation>();
+                    const auto *c = db.find_comment(op.author, op.permlink);
+                    if (c != nullptr) {
+                        paid_out.insert(c->id);
+                    }
+                } else if (note.op.which() == operation::tag<transfer_operation>::value ||
+                           note.op.which() == operation::tag<comment_reward_operation>::value) {
+                    my->on_operation(note, &paid_out);
+                }
+            });
+            return true;
+        }
+
     }
 } /// steemit::tags
 
@@ -23,14 +23,12 @@
  */
 
 #include <steemit/protocol/authority.hpp>
-
-#include <steemit/app/impacted.hpp>
+#include <steemit/protocol/impacted.hpp>
 
 namespace steemit {
-    namespace app {
+    namespace protocol {
 
         using namespace fc;
-        using namespace steemit::protocol;
 
 // TODO:  Review all of these, especially no-ops
         struct get_impacted_account_visitor {
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <fc/container/flat.hpp>
+#include <steemit/protocol/operations.hpp>
+#include <steemit/protocol/transaction.hpp>
+
+namespace steemit {
+    namespace protocol {
+
+        void operation_get_impacted_accounts(
+                const operation &op,
+                fc::flat_set<account_name_type> &result);
+
+        void transaction_get_impacted_accounts(
+                const transaction &tx,
+                fc::flat_set<account_name_type> &result
+        );
+
+    }
+} // steemit::protocol
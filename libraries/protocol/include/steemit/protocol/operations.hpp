@@ -87,6 +87,9 @@ namespace steemit {
 
         bool is_virtual_operation(const operation &op);
 
+        /** Operations authorized by a posting authority, e.g. votes and comments */
+        bool is_posting_operation(const operation &op);
+
     }
 } // steemit::protocol
 
@@ -47,6 +47,21 @@ namespace steemit {
             return op.visit(is_vop_visitor());
         }
 
+        struct is_posting_op_visitor {
+            typedef bool result_type;
+
+            template<typename T>
+            bool operator()(const T &v) const {
+                flat_set<account_name_type> posting;
+                v.get_required_posting_authorities(posting);
+                return !posting.empty();
+            }
+        };
+
+        bool is_posting_operation(const operation &op) {
+            return op.visit(is_posting_op_visitor());
+        }
+
     }
 } // steemit::protocol
 
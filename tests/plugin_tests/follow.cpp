@@ -0,0 +1,61 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <steemit/chain/account_object.hpp>
+#include <steemit/chain/comment_object.hpp>
+#include <steemit/protocol/steem_operations.hpp>
+
+#include <steemit/app/api_context.hpp>
+
+#include <steemit/follow/follow_api.hpp>
+#include <steemit/follow/follow_plugin.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace steemit::chain;
+using namespace steemit::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(follow, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(blog_content) {
+        using namespace steemit::follow;
+
+        try {
+            auto follow = app.register_plugin<follow_plugin>();
+            boost::program_options::variables_map options;
+            follow->plugin_initialize(options);
+
+            ACTORS((alice));
+            generate_block();
+
+            signed_transaction tx;
+            comment_operation comment;
+            comment.author = "alice";
+            comment.permlink = "test";
+            comment.parent_permlink = "test";
+            comment.title = "foo";
+            comment.body = "bar";
+            comment.json_metadata = "{\"tags\":[\"test\"]}";
+            tx.operations.push_back(comment);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+            generate_block();
+
+            follow_api api(steemit::app::api_context(app, "follow_api",
+                    std::weak_ptr<steemit::app::api_session_data>()));
+
+            // The content is kept out of the comment_object and must still be returned
+            auto blog = api.get_blog("alice", 0, 10);
+            BOOST_REQUIRE_EQUAL(blog.size(), 1u);
+            BOOST_REQUIRE_EQUAL(blog[0].comment.permlink, "test");
+            BOOST_REQUIRE_EQUAL(blog[0].comment.title, "foo");
+            BOOST_REQUIRE_EQUAL(blog[0].comment.body, "bar");
+            BOOST_REQUIRE_EQUAL(blog[0].comment.json_metadata, comment.json_metadata);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -49,9 +49,9 @@ DEFINE_PLUGIN_EVALUATOR( test_plugin, test_b_operation, test_b );
 
 void test_a_evaluator::do_apply( const test_a_operation& o )
 {
-   const auto& account = db().get_account( o.account );
+   const auto& account = db().get_account_metadata( o.account );
 
-   db().modify( account, [&]( account_object& a )
+   db().modify( account, [&]( account_metadata_object& a )
    {
       a.json_metadata = "a";
    });
@@ -59,9 +59,9 @@ void test_a_evaluator::do_apply( const test_a_operation& o )
 
 void test_b_evaluator::do_apply( const test_b_operation& o )
 {
-   const auto& account = db().get_account( o.account );
+   const auto& account = db().get_account_metadata( o.account );
 
-   db().modify( account, [&]( account_object& a )
+   db().modify( account, [&]( account_metadata_object& a )
    {
       a.json_metadata = "b";
    });
@@ -0,0 +1,195 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <steemit/chain/account_object.hpp>
+#include <steemit/chain/comment_object.hpp>
+#include <steemit/protocol/steem_operations.hpp>
+
+#include <steemit/app/api_context.hpp>
+#include <steemit/app/database_api.hpp>
+
+#include <steemit/tags/tags_plugin.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <algorithm>
+
+#include "../common/database_fixture.hpp"
+
+using namespace steemit::chain;
+using namespace steemit::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(tags, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(discussion_fields) {
+        try {
+            auto tags = app.register_plugin<steemit::tags::tags_plugin>();
+            boost::program_options::variables_map options;
+            tags->plugin_initialize(options);
+
+            ACTORS((alice));
+            generate_block();
+
+            signed_transaction tx;
+            comment_operation comment;
+            comment.author = "alice";
+            comment.permlink = "kept";
+            comment.parent_permlink = "test";
+            comment.title = "foo";
+            comment.body = "bar";
+            comment.json_metadata = "{\"tags\":[\"test\"]}";
+            tx.operations.push_back(comment);
+
+            comment.permlink = "filtered";
+            comment.json_metadata = "{\"tags\":[\"test\",\"skip\"]}";
+            tx.operations.push_back(comment);
+
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+            generate_block();
+
+            steemit::app::database_api api(steemit::app::api_context(app, "database_api",
+                    std::weak_ptr<steemit::app::api_session_data>()));
+
+            steemit::app::discussion_query query;
+            query.limit = 10;
+            query.select_tags = {"test"};
+
+            BOOST_TEST_MESSAGE("All fields are filled in when none are selected");
+            auto discussions = api.get_discussions_by_created(query);
+            BOOST_REQUIRE_EQUAL(discussions.size(), 2u);
+            for (const auto &d : discussions) {
+                BOOST_REQUIRE_EQUAL(d.title, "foo");
+                BOOST_REQUIRE_EQUAL(d.body, "bar");
+                BOOST_REQUIRE(!d.json_metadata.empty());
+                BOOST_REQUIRE(!d.url.empty());
+            }
+
+            BOOST_TEST_MESSAGE("Fields which are not selected are left out, the title is always returned");
+            query.fields = std::set<std::string>{"url"};
+            discussions = api.get_discussions_by_created(query);
+            BOOST_REQUIRE_EQUAL(discussions.size(), 2u);
+            for (const auto &d : discussions) {
+                BOOST_REQUIRE_EQUAL(d.title, "foo");
+                BOOST_REQUIRE(d.body.empty());
+                BOOST_REQUIRE_EQUAL(d.body_length, 3u);
+                BOOST_REQUIRE(d.json_metadata.empty());
+                BOOST_REQUIRE_EQUAL(d.url, "/test/@alice/" + d.permlink);
+            }
+
+            BOOST_TEST_MESSAGE("Tags are filtered by the json_metadata even when it is not returned");
+            query.filter_tags = {"skip"};
+            discussions = api.get_discussions_by_created(query);
+            BOOST_REQUIRE_EQUAL(discussions.size(), 1u);
+            BOOST_REQUIRE_EQUAL(discussions[0].permlink, "kept");
+            BOOST_REQUIRE(discussions[0].json_metadata.empty());
+
+            query.fields = std::set<std::string>{"body", "json_metadata"};
+            discussions = api.get_discussions_by_created(query);
+            BOOST_REQUIRE_EQUAL(discussions.size(), 1u);
+            BOOST_REQUIRE_EQUAL(discussions[0].body, "bar");
+            BOOST_REQUIRE_EQUAL(discussions[0].json_metadata, "{\"tags\":[\"test\"]}");
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(reindex_matches_replay) {
+        using namespace steemit::tags;
+
+        try {
+            auto tags = app.register_plugin<tags_plugin>();
+            boost::program_options::variables_map options;
+            tags->plugin_initialize(options);
+
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            fund("alice", ASSET("10.000 TBD"));
+            vest("bob", 10000);
+            generate_block();
+
+            auto push = [&](const operation &op, const fc::ecc::private_key &key) {
+                signed_transaction tx;
+                tx.operations.push_back(op);
+                tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                tx.sign(key, db.get_chain_id());
+                db.push_transaction(tx, 0);
+            };
+
+            comment_operation post;
+            post.author = "alice";
+            post.permlink = "post";
+            post.parent_permlink = "test";
+            post.title = "foo";
+            post.body = "bar";
+            post.json_metadata = "{\"tags\":[\"test\",\"other\"]}";
+            push(post, alice_private_key);
+
+            comment_operation reply;
+            reply.author = "bob";
+            reply.permlink = "reply";
+            reply.parent_author = "alice";
+            reply.parent_permlink = "post";
+            reply.body = "baz";
+            reply.json_metadata = "{\"tags\":[\"reply\"]}";
+            push(reply, bob_private_key);
+            generate_block();
+
+            vote_operation vote;
+            vote.voter = "bob";
+            vote.author = "alice";
+            vote.permlink = "post";
+            vote.weight = STEEMIT_100_PERCENT;
+            push(vote, bob_private_key);
+
+            transfer_operation promote;
+            promote.from = "alice";
+            promote.to = STEEMIT_NULL_ACCOUNT;
+            promote.amount = ASSET("1.000 TBD");
+            promote.memo = "@alice/post";
+            push(promote, alice_private_key);
+            generate_block();
+
+            // Objects are compared without their ids, which are assigned again by the reindex
+            auto snapshot = [&]() {
+                std::vector<std::string> result;
+                auto add = [&](const fc::variant &v) {
+                    fc::mutable_variant_object o(v.get_object());
+                    o.erase("id");
+                    result.push_back(fc::json::to_string(fc::variant(o)));
+                };
+                for (const auto &t : db.get_index<tag_index>().indices()) {
+                    add(fc::variant(t));
+                }
+                for (const auto &t : db.get_index<tag_stats_index>().indices()) {
+                    add(fc::variant(t));
+                }
+                for (const auto &t : db.get_index<author_tag_stats_index>().indices()) {
+                    add(fc::variant(t));
+                }
+                std::sort(result.begin(), result.end());
+                return result;
+            };
+
+            auto replayed = snapshot();
+            const auto &tag_idx = db.get_index<tag_index>().indices().get<by_comment>();
+            auto promoted = tag_idx.find(db.get_comment("alice", string("post")).id);
+            BOOST_REQUIRE(promoted != tag_idx.end());
+            BOOST_REQUIRE_EQUAL(promoted->promoted_balance.value, 1000);
+
+            BOOST_TEST_MESSAGE("Reindexing the plugin rebuilds the indexes the blocks built");
+            db.with_write_lock([&]() {
+                BOOST_REQUIRE(tags->plugin_reindex());
+            });
+            auto reindexed = snapshot();
+            BOOST_REQUIRE_EQUAL(reindexed.size(), replayed.size());
+            for (size_t i = 0; i < replayed.size(); ++i) {
+                BOOST_CHECK_EQUAL(reindexed[i], replayed[i]);
+            }
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,477 @@
+#include <boost/test/unit_test.hpp>
+
+#include <steemit/chain/database.hpp>
+#include <steemit/app/api_admission.hpp>
+#include <steemit/app/api_context.hpp>
+#include <steemit/app/api_executor.hpp>
+#include <steemit/app/api_metrics.hpp>
+#include <steemit/app/database_api.hpp>
+#include <steemit/app/plugin_pipeline.hpp>
+#include <steemit/app/response_cache.hpp>
+#include <steemit/app/state_views.hpp>
+#include <steemit/market_history/market_history_api.hpp>
+#include <steemit/plugins/debug_node/debug_node_api.hpp>
+
+#include <fc/network/http/connection.hpp>
+#include <fc/network/http/websocket.hpp>
+#include <fc/network/ip.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <atomic>
+#include <sstream>
+
+#include "../common/database_fixture.hpp"
+
+using namespace steemit;
+using namespace steemit::chain;
+using namespace steemit::protocol;
+
+namespace {
+    /**
+     * Records the blocks it is given, applied blocks as positive and popped blocks as negative numbers
+     */
+    class recording_consumer : public steemit::app::pipeline_consumer {
+    public:
+        virtual void on_apply_block(const block_notification &note) override {
+            while (paused) {
+                fc::usleep(fc::milliseconds(1));
+            }
+            events.push_back(int64_t(note.block.block_num()));
+        }
+
+        virtual void on_pop_block(const signed_block &block) override {
+            events.push_back(-int64_t(block.block_num()));
+        }
+
+        std::atomic<bool> paused{false};
+        std::vector<int64_t> events;
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(api_tests, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(read_only_call_dispatch) {
+        try {
+            auto admission = std::make_shared<steemit::app::api_admission>(steemit::app::api_admission_limits(), 1,
+                    std::map<std::string, uint32_t>(), std::vector<std::string>());
+            auto metrics = std::make_shared<steemit::app::api_metrics>(fc::seconds(10));
+            steemit::app::api_executor executor(1, admission, metrics);
+            int session;
+
+            std::string method = "get_dynamic_global_properties";
+            fc::variants args;
+            fc::rpc::api_connection::call_info read_only_info{0, method, args, true};
+            fc::rpc::api_connection::call_info info{0, method, args, false};
+
+            fc::thread *ran_on = nullptr;
+            auto read_call = [&]() {
+                return db.with_read_lock([&]() {
+                    ran_on = &fc::thread::current();
+                    return fc::variant(db.head_block_num());
+                });
+            };
+
+            BOOST_TEST_MESSAGE("A read only call runs on an API thread and waits there for the read lock");
+            fc::future<fc::variant> result;
+            db.with_write_lock([&]() {
+                result = fc::async([&]() {
+                    return executor.execute(&session, "database_api." + method, read_only_info, read_call);
+                });
+                fc::usleep(fc::milliseconds(100));
+                BOOST_REQUIRE(!result.ready());
+            });
+            BOOST_REQUIRE_EQUAL(result.wait().as_uint64(), db.head_block_num());
+            BOOST_REQUIRE(ran_on != nullptr);
+            BOOST_REQUIRE(ran_on != &fc::thread::current());
+
+            auto stats = metrics->get_stats();
+            BOOST_REQUIRE_EQUAL(stats.size(), 1u);
+            BOOST_REQUIRE_EQUAL(stats[0].name, "database_api." + method);
+            BOOST_REQUIRE_EQUAL(stats[0].errors, 0u);
+            BOOST_REQUIRE_GT(stats[0].lock_wait.max_us, 0);
+
+            BOOST_TEST_MESSAGE("Other calls run on the calling thread");
+            ran_on = nullptr;
+            executor.execute(&session, "database_api." + method, info, read_call);
+            BOOST_REQUIRE(ran_on == &fc::thread::current());
+
+            BOOST_TEST_MESSAGE("A failing call is counted as an error and its exception reaches the caller");
+            BOOST_REQUIRE_THROW(executor.execute(&session, "database_api." + method, read_only_info, [&]() -> fc::variant {
+                FC_ASSERT(false);
+            }), fc::assert_exception);
+            BOOST_REQUIRE_EQUAL(metrics->get_stats()[0].errors, 1u);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(metrics_endpoint) {
+        try {
+            auto admission = std::make_shared<steemit::app::api_admission>(steemit::app::api_admission_limits(), 1,
+                    std::map<std::string, uint32_t>(), std::vector<std::string>());
+            auto metrics = std::make_shared<steemit::app::api_metrics>(fc::seconds(10));
+            steemit::app::api_executor executor(1, admission, metrics);
+            int session;
+
+            fc::http::websocket_server server;
+            server.on_http_get([&](const std::string &resource) {
+                if (resource == "/metrics") {
+                    return fc::optional<std::string>(metrics->to_prometheus());
+                }
+                return fc::optional<std::string>();
+            });
+            server.listen(8093);
+            server.start_accept();
+
+            auto get = [&](const std::string &resource) {
+                fc::http::connection client;
+                client.connect_to(fc::ip::endpoint::from_string("127.0.0.1:8093"));
+                return client.request("GET", "http://127.0.0.1:8093" + resource);
+            };
+            // Samples of the exposition by metric and labels, comments left out
+            auto get_metrics = [&]() {
+                auto reply = get("/metrics");
+                BOOST_REQUIRE_EQUAL(reply.status, fc::http::reply::OK);
+                std::map<std::string, double> samples;
+                std::istringstream lines(std::string(reply.body.begin(), reply.body.end()));
+                std::string line;
+                while (std::getline(lines, line)) {
+                    auto pos = line.rfind(' ');
+                    if (line.empty() || line[0] == '#' || pos == std::string::npos) {
+                        continue;
+                    }
+                    samples[line.substr(0, pos)] = std::stod(line.substr(pos + 1));
+                }
+                return samples;
+            };
+
+            std::string method = "get_dynamic_global_properties";
+            std::string label = "{method=\"database_api." + method + "\"}";
+            fc::variants args;
+            fc::rpc::api_connection::call_info info{0, method, args, true};
+            auto read_call = [&]() {
+                return db.with_read_lock([&]() { return fc::variant(db.head_block_num()); });
+            };
+
+            BOOST_REQUIRE(get_metrics().count("golos_api_calls_total" + label) == 0);
+            BOOST_REQUIRE_EQUAL(get("/other").status, fc::http::reply::NotFound);
+
+            BOOST_TEST_MESSAGE("A call which waited for the read lock is counted with its wait");
+            fc::future<fc::variant> result;
+            db.with_write_lock([&]() {
+                result = fc::async([&]() {
+                    return executor.execute(&session, "database_api." + method, info, read_call);
+                });
+                fc::usleep(fc::milliseconds(100));
+            });
+            result.wait();
+
+            auto samples = get_metrics();
+            BOOST_REQUIRE_EQUAL(samples.at("golos_api_calls_total" + label), 1);
+            BOOST_REQUIRE_EQUAL(samples.at("golos_api_errors_total" + label), 0);
+            BOOST_REQUIRE_EQUAL(samples.at("golos_api_call_duration_microseconds_count" + label), 1);
+            auto lock_wait = samples.at("golos_api_lock_wait_microseconds_total" + label);
+            BOOST_REQUIRE_GT(lock_wait, 0);
+
+            BOOST_TEST_MESSAGE("The counters move with further calls");
+            executor.execute(&session, "database_api." + method, info, read_call);
+            BOOST_REQUIRE_THROW(executor.execute(&session, "database_api." + method, info, [&]() -> fc::variant {
+                FC_ASSERT(false);
+            }), fc::assert_exception);
+
+            samples = get_metrics();
+            BOOST_REQUIRE_EQUAL(samples.at("golos_api_calls_total" + label), 3);
+            BOOST_REQUIRE_EQUAL(samples.at("golos_api_errors_total" + label), 1);
+            BOOST_REQUIRE_EQUAL(samples.at("golos_api_call_duration_microseconds_count" + label), 3);
+            BOOST_REQUIRE_GE(samples.at("golos_api_lock_wait_microseconds_total" + label), lock_wait);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(read_only_batch_admission) {
+        try {
+            steemit::app::api_admission_limits limits;
+            limits.max_session_calls = 4;
+            auto admission = std::make_shared<steemit::app::api_admission>(limits, 1,
+                    std::map<std::string, uint32_t>(), std::vector<std::string>());
+            auto metrics = std::make_shared<steemit::app::api_metrics>(fc::seconds(10));
+            steemit::app::api_executor executor(1, admission, metrics);
+            int session;
+
+            std::string method = "get_dynamic_global_properties";
+            fc::variants args;
+            fc::rpc::api_connection::call_info info{0, method, args, true};
+            auto call = [&]() {
+                fc::usleep(fc::milliseconds(10));
+                return db.with_read_lock([&]() { return fc::variant(db.head_block_num()); });
+            };
+
+            BOOST_TEST_MESSAGE("A batch of as many calls as the session may have in flight is admitted whole");
+            std::vector<fc::future<fc::variant>> batch;
+            for (uint32_t i = 0; i < limits.max_session_calls; ++i) {
+                batch.push_back(fc::async([&]() {
+                    return executor.execute(&session, "database_api." + method, info, call);
+                }));
+            }
+            for (auto &result : batch) {
+                BOOST_REQUIRE_EQUAL(result.wait().as_uint64(), db.head_block_num());
+            }
+
+            BOOST_TEST_MESSAGE("Calls beyond the session limit are rejected, batches are capped at it");
+            batch.clear();
+            for (uint32_t i = 0; i <= limits.max_session_calls; ++i) {
+                batch.push_back(fc::async([&]() {
+                    return executor.execute(&session, "database_api." + method, info, call);
+                }));
+            }
+            uint32_t rejected = 0;
+            for (auto &result : batch) {
+                try {
+                    result.wait();
+                } catch (const fc::assert_exception &) {
+                    ++rejected;
+                }
+            }
+            BOOST_REQUIRE_EQUAL(rejected, 1u);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(shared_api_instances) {
+        try {
+            app.register_shared_api_factory<steemit::market_history::market_history_api>("market_history_api");
+            auto create = [&](const std::string &name) {
+                return app.create_api_by_name(steemit::app::api_context(app, name,
+                        std::make_shared<steemit::app::api_session_data>()));
+            };
+
+            BOOST_TEST_MESSAGE("Every session gets the same instance of a shared API");
+            auto market_history = create("market_history_api");
+            BOOST_REQUIRE(market_history);
+            BOOST_REQUIRE(create("market_history_api") == market_history);
+
+            BOOST_TEST_MESSAGE("Other APIs get the same instance from the application");
+            auto instance = app.get_shared_api<steemit::market_history::market_history_api>("market_history_api");
+            BOOST_REQUIRE(instance);
+            BOOST_REQUIRE(app.get_shared_api<steemit::market_history::market_history_api>("market_history_api") == instance);
+
+            BOOST_TEST_MESSAGE("An API keeping per-session state is built for each session");
+            auto debug_node = create("debug_node_api");
+            BOOST_REQUIRE(debug_node);
+            BOOST_REQUIRE(create("debug_node_api") != debug_node);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(plugin_pipeline_delivery) {
+        try {
+            steemit::app::plugin_pipeline pipeline(app.chain_database());
+            auto consumer = std::make_shared<recording_consumer>();
+            pipeline.add_consumer("recorder", consumer);
+            auto wait_idle = [&]() {
+                for (int i = 0; i < 1000 && pipeline.get_status()[0].queue_size; ++i) {
+                    fc::usleep(fc::milliseconds(1));
+                }
+                BOOST_REQUIRE_EQUAL(pipeline.get_status()[0].queue_size, 0u);
+            };
+            uint32_t start = db.head_block_num();
+
+            BOOST_TEST_MESSAGE("A consumer which is behind reports its lag");
+            consumer->paused = true;
+            generate_blocks(3);
+            auto status = pipeline.get_status();
+            BOOST_REQUIRE_EQUAL(status.size(), 1u);
+            BOOST_REQUIRE_EQUAL(status[0].name, "recorder");
+            BOOST_REQUIRE_EQUAL(status[0].head_block_num, start + 3);
+            BOOST_REQUIRE_EQUAL(status[0].queue_size, 3u);
+            BOOST_REQUIRE_EQUAL(status[0].lag, status[0].head_block_num - status[0].processed_block_num);
+            BOOST_REQUIRE_GT(status[0].lag, 0u);
+
+            consumer->paused = false;
+            wait_idle();
+            status = pipeline.get_status();
+            BOOST_REQUIRE_EQUAL(status[0].processed_block_num, start + 3);
+            BOOST_REQUIRE_EQUAL(status[0].lag, 0u);
+
+            BOOST_TEST_MESSAGE("A popped block is delivered after it was applied");
+            db.pop_block();
+            wait_idle();
+            status = pipeline.get_status();
+            BOOST_REQUIRE_EQUAL(status[0].head_block_num, start + 2);
+            BOOST_REQUIRE_EQUAL(status[0].processed_block_num, start + 2);
+
+            BOOST_TEST_MESSAGE("Blocks are delivered in the order they were applied and popped");
+            std::vector<int64_t> expected = {int64_t(start) + 1, int64_t(start) + 2, int64_t(start) + 3, -(int64_t(start) + 3)};
+            BOOST_REQUIRE(consumer->events == expected);
+
+            pipeline.shutdown();
+            generate_block();
+            BOOST_REQUIRE(consumer->events == expected);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(response_cache_size) {
+        try {
+            steemit::app::response_cache cache(100);
+            auto result = std::make_shared<const int>(1);
+
+            BOOST_TEST_MESSAGE("Entries are weighed by their key and estimated result size");
+            cache.insert("a", result, 40, cache.generation());
+            cache.insert("b", result, 40, cache.generation());
+            BOOST_REQUIRE(cache.find("a") && cache.find("b"));
+            BOOST_REQUIRE_EQUAL(cache.size(), 82u);
+
+            BOOST_TEST_MESSAGE("Replacing an entry does not count it twice");
+            cache.insert("b", result, 10, cache.generation());
+            BOOST_REQUIRE_EQUAL(cache.size(), 52u);
+
+            BOOST_TEST_MESSAGE("A result too large for the cache is not cached");
+            cache.insert("c", result, 100, cache.generation());
+            BOOST_REQUIRE(!cache.find("c"));
+            BOOST_REQUIRE_EQUAL(cache.size(), 52u);
+
+            BOOST_TEST_MESSAGE("The cache starts over when full");
+            cache.insert("d", result, 60, cache.generation());
+            BOOST_REQUIRE(!cache.find("a") && !cache.find("b"));
+            BOOST_REQUIRE(cache.find("d"));
+            BOOST_REQUIRE_EQUAL(cache.size(), 61u);
+
+            BOOST_TEST_MESSAGE("Results computed before the cache was cleared are dropped");
+            auto generation = cache.generation();
+            cache.clear();
+            cache.insert("e", result, 1, generation);
+            BOOST_REQUIRE(!cache.find("e"));
+            BOOST_REQUIRE_EQUAL(cache.size(), 0u);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(state_views_changed_accounts) {
+        try {
+            ACTORS((alice)(bob)(carol));
+            fund("alice", 10000);
+            vest("alice", 10000);
+            generate_block();
+
+            steemit::app::state_views views(100);
+            boost::signals2::scoped_connection connection = db.changed_objects.connect(
+                    [&](const changed_objects_notification &note) {
+                        views.on_changed_objects(db, note);
+                    });
+            for (const auto &name : {"alice", "bob", "carol"}) {
+                views.insert_account(steemit::app::extended_account(db.get_account(name), db));
+            }
+
+            BOOST_TEST_MESSAGE("Accounts whose objects a block changed are dropped when the block is applied");
+            proxy("alice", "bob");
+            BOOST_REQUIRE(views.find_account("bob"));
+            generate_block();
+            BOOST_REQUIRE(!views.find_account("alice"));
+            BOOST_REQUIRE(!views.find_account("bob"));
+            BOOST_REQUIRE(views.find_account("carol"));
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(object_updates_callback) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+
+            comment_operation comment;
+            comment.author = "alice";
+            comment.permlink = "post";
+            comment.parent_permlink = "test";
+            comment.title = "foo";
+            comment.body = "bar";
+            signed_transaction tx;
+            tx.operations.push_back(comment);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+            generate_block();
+
+            steemit::app::database_api api(steemit::app::api_context(app, "database_api",
+                    std::weak_ptr<steemit::app::api_session_data>()));
+
+            std::vector<fc::variant> updates;
+            api.set_subscribe_callback([&](const fc::variant &update) {
+                updates.push_back(update);
+            }, true);
+            api.get_accounts({"bob"});
+            api.get_content("alice", "post");
+
+            transfer("alice", "bob", 100);
+            comment.body = "baz";
+            tx.operations = {comment};
+            tx.signatures.clear();
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+            generate_block();
+            BOOST_REQUIRE(updates.empty());
+
+            BOOST_TEST_MESSAGE("The objects looked up which a block changed are sent after the block");
+            fc::usleep(fc::milliseconds(100));
+            BOOST_REQUIRE_EQUAL(updates.size(), 1u);
+            BOOST_REQUIRE_EQUAL(updates[0]["block_num"].as_uint64(), db.head_block_num());
+
+            BOOST_TEST_MESSAGE("Accounts and comments which were not looked up are left out");
+            auto accounts = updates[0]["accounts"].get_array();
+            BOOST_REQUIRE_EQUAL(accounts.size(), 1u);
+            BOOST_REQUIRE_EQUAL(accounts[0]["name"].as_string(), "bob");
+            auto comments = updates[0]["comments"].get_array();
+            BOOST_REQUIRE_EQUAL(comments.size(), 1u);
+            BOOST_REQUIRE_EQUAL(comments[0]["permlink"].as_string(), "post");
+            BOOST_REQUIRE_EQUAL(comments[0]["body"].as_string(), "baz");
+
+            api.set_subscribe_callback(std::function<void(const fc::variant &)>(), true);
+            transfer("alice", "bob", 100);
+            generate_block();
+            fc::usleep(fc::milliseconds(100));
+            BOOST_REQUIRE_EQUAL(updates.size(), 1u);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(block_operations_callback) {
+        try {
+            ACTORS((alice)(bob)(carol));
+            fund("alice", 10000);
+            generate_block();
+
+            steemit::app::database_api api(steemit::app::api_context(app, "database_api",
+                    std::weak_ptr<steemit::app::api_session_data>()));
+
+            std::vector<fc::variant> updates;
+            steemit::app::block_operations_filter filter;
+            filter.accounts = {"bob"};
+            filter.virtual_ops = false;
+            api.set_block_operations_callback([&](const fc::variant &update) {
+                updates.push_back(update);
+            }, filter);
+
+            transfer("alice", "bob", 100);
+            transfer("alice", "carol", 100);
+            generate_block();
+
+            BOOST_TEST_MESSAGE("Blocks are filtered and sent after they are applied");
+            fc::usleep(fc::milliseconds(100));
+            BOOST_REQUIRE_EQUAL(updates.size(), 1u);
+            BOOST_REQUIRE_EQUAL(updates[0]["block_num"].as_uint64(), db.head_block_num());
+
+            BOOST_TEST_MESSAGE("Only operations impacting the accounts of the filter are sent");
+            auto operations = updates[0]["operations"].get_array();
+            BOOST_REQUIRE_EQUAL(operations.size(), 1u);
+            auto op = operations[0]["op"].as<operation>();
+            BOOST_REQUIRE(op.which() == operation::tag<transfer_operation>::value);
+            BOOST_REQUIRE_EQUAL(std::string(op.get<transfer_operation>().to), "bob");
+
+            api.cancel_all_subscriptions();
+            generate_block();
+            fc::usleep(fc::milliseconds(100));
+            BOOST_REQUIRE_EQUAL(updates.size(), 1u);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
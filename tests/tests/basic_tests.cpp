@@ -26,10 +26,12 @@
 #include <boost/test/unit_test_monitor.hpp>
 
 #include <steemit/chain/database.hpp>
+#include <steemit/app/api_admission.hpp>
 
 #include <fc/crypto/digest.hpp>
 #include "../common/database_fixture.hpp"
 
+#include <algorithm>
 #include <random>
 
 using namespace steemit;
@@ -313,4 +315,157 @@ BOOST_FIXTURE_TEST_SUITE(basic_tests, clean_database_fixture)
         BOOST_CHECK(block.calculate_merkle_root() == c(dO));
     }
 
+    BOOST_AUTO_TEST_CASE(api_admission_limits) {
+        using steemit::app::api_admission;
+        using steemit::app::api_priority;
+
+        steemit::app::api_admission_limits limits;
+        limits.max_queued_calls = 0;
+        limits.max_session_calls = 2;
+        limits.max_method_calls = 1;
+        limits.max_normal_cost = 100;
+
+        api_admission admission(limits, 1, {{"database_api.get_state", 200}}, {"network_broadcast_api"});
+        int session_a, session_b;
+
+        fc::mutable_variant_object query;
+        query["limit"] = 50;
+        BOOST_CHECK_EQUAL(admission.estimate_cost("database_api.get_discussions_by_trending", {query}), 50u);
+        BOOST_CHECK_EQUAL(admission.estimate_cost("database_api.get_state", {"/trending"}), 200u);
+
+        auto state = admission.admit(&session_a, "database_api.get_state", {"/trending"});
+        BOOST_CHECK(state->priority() == api_priority::low);
+
+        // Only one call of the method may be in flight, broadcasts are not limited per method
+        STEEMIT_REQUIRE_THROW(admission.admit(&session_b, "database_api.get_state", {"/"}), fc::exception);
+        auto broadcast = admission.admit(&session_a, "network_broadcast_api.broadcast_transaction", {});
+        BOOST_CHECK(broadcast->priority() == api_priority::high);
+
+        // The session already has two calls in flight
+        STEEMIT_REQUIRE_THROW(admission.admit(&session_a, "database_api.get_config", {}), fc::exception);
+        broadcast.reset();
+        auto config = admission.admit(&session_a, "database_api.get_config", {});
+        BOOST_CHECK(config->priority() == api_priority::normal);
+
+        // The only thread is taken and no call may wait for it
+        auto slot = admission.acquire_thread(*state);
+        BOOST_CHECK_EQUAL(slot->thread(), 0u);
+        STEEMIT_REQUIRE_THROW(admission.acquire_thread(*config), fc::exception);
+        slot.reset();
+        BOOST_CHECK_EQUAL(admission.acquire_thread(*config)->thread(), 0u);
+    }
+
+    BOOST_AUTO_TEST_CASE(api_admission_canceled_wait) {
+        using steemit::app::api_admission;
+
+        steemit::app::api_admission_limits limits;
+        limits.max_queued_calls = 1;
+        api_admission admission(limits, 1, {}, {});
+        int session;
+
+        auto first = admission.admit(&session, "database_api.get_config", {});
+        auto second = admission.admit(&session, "database_api.get_config", {});
+        auto third = admission.admit(&session, "database_api.get_config", {});
+
+        // The second call waits for the only thread and gives up
+        auto slot = admission.acquire_thread(*first);
+        auto waiting = fc::async([&]() { admission.acquire_thread(*second); });
+        fc::usleep(fc::milliseconds(10));
+        BOOST_CHECK(!waiting.ready());
+        waiting.cancel_and_wait();
+
+        // Its place in the queue is free and the thread is not handed to it
+        slot.reset();
+        auto acquired = fc::async([&]() { return admission.acquire_thread(*third)->thread(); });
+        BOOST_CHECK_EQUAL(acquired.wait(fc::seconds(1)), 0u);
+    }
+
+
+    BOOST_AUTO_TEST_CASE(block_profiler_phases) {
+        block_profiler profiler;
+        profiler.set_enabled(true);
+
+        profiler.begin_block(1);
+        profiler.record(block_phase::update_virtual_supply, fc::microseconds(10));
+        profiler.record(block_phase::process_funds, fc::microseconds(30));
+        profiler.record(block_phase::update_virtual_supply_after_payouts, fc::microseconds(20));
+        profiler.end_block();
+
+        profiler.begin_block(2);
+        profiler.record(block_phase::update_virtual_supply, fc::microseconds(50));
+        profiler.end_block();
+
+        auto stats = profiler.get_stats();
+        BOOST_REQUIRE_EQUAL(stats.size(), 5u);
+        BOOST_CHECK_EQUAL(stats[0].name, "block");
+        BOOST_CHECK_EQUAL(stats[0].count, 2u);
+        BOOST_CHECK_EQUAL(stats[1].name, "transaction");
+        BOOST_CHECK_EQUAL(stats[1].count, 0u);
+
+        // Phases which were not recorded are left out, the rest are sorted by total time
+        BOOST_CHECK_EQUAL(stats[2].name, "update_virtual_supply");
+        BOOST_CHECK_EQUAL(stats[2].count, 2u);
+        BOOST_CHECK_EQUAL(stats[2].total_us, 60);
+        BOOST_CHECK_EQUAL(stats[3].name, "process_funds");
+        BOOST_CHECK_EQUAL(stats[4].name, "update_virtual_supply_after_payouts");
+        BOOST_CHECK_EQUAL(stats[4].count, 1u);
+    }
+
+    BOOST_AUTO_TEST_CASE(operation_profile_counts) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            db.set_operation_profiling(true, 0);
+
+            signed_transaction tx;
+            transfer_operation transfer;
+            transfer.from = "alice";
+            transfer.to = "bob";
+            transfer.amount = ASSET("1.000 TESTS");
+            tx.operations.push_back(transfer);
+            tx.operations.push_back(transfer);
+            transfer_to_vesting_operation vest;
+            vest.from = "alice";
+            vest.to = "bob";
+            vest.amount = ASSET("1.000 TESTS");
+            tx.operations.push_back(vest);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            auto find = [](const std::vector<operation_profile_stats> &stats, const std::string &name) {
+                auto itr = std::find_if(stats.begin(), stats.end(), [&](const operation_profile_stats &s) {
+                    return s.name == name;
+                });
+                BOOST_REQUIRE(itr != stats.end());
+                return *itr;
+            };
+
+            // Only the operations applied since profiling was enabled are counted, once per phase
+            auto stats = db.get_operation_profile_stats();
+            BOOST_REQUIRE_EQUAL(stats.size(), 2u);
+            auto transfers = find(stats, "transfer");
+            BOOST_CHECK_EQUAL(transfers.evaluate.count, 2u);
+            BOOST_CHECK_EQUAL(transfers.pre_apply.count, 2u);
+            BOOST_CHECK_EQUAL(transfers.post_apply.count, 2u);
+            BOOST_CHECK_EQUAL(transfers.total_us,
+                    transfers.evaluate.total_us + transfers.pre_apply.total_us + transfers.post_apply.total_us);
+            auto vests = find(stats, "transfer_to_vesting");
+            BOOST_CHECK_EQUAL(vests.evaluate.count, 1u);
+            BOOST_CHECK_EQUAL(vests.pre_apply.count, 1u);
+
+            // Operations are no longer counted once profiling is disabled
+            db.set_operation_profiling(false, 0);
+            transfer.amount = ASSET("2.000 TESTS");
+            tx.operations = {transfer};
+            tx.signatures.clear();
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+            BOOST_CHECK_EQUAL(find(db.get_operation_profile_stats(), "transfer").evaluate.count, 2u);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -30,13 +30,18 @@
 #include <steemit/chain/database.hpp>
 #include <steemit/chain/steem_objects.hpp>
 #include <steemit/chain/history_object.hpp>
+#include <steemit/chain/operation_notification.hpp>
 
 #include <steemit/account_history/account_history_plugin.hpp>
 
+#include <steemit/app/transaction_prechecker.hpp>
+
 #include <graphene/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
 
+#include <fstream>
+
 #include "../common/database_fixture.hpp"
 
 using namespace steemit;
@@ -45,6 +50,20 @@ using namespace steemit::protocol;
 
 #define TEST_SHARED_MEM_SIZE (1024 * 1024 * 8)
 
+// The on-disk logs flush on close, so a crash between writing data and writing the header
+// is simulated by putting back the head of a file saved right after the last flush.
+static std::vector<char> read_file_head(const fc::path &file, size_t size) {
+    std::vector<char> data(size);
+    std::ifstream s(file.generic_string().c_str(), std::ios::in | std::ios::binary);
+    s.read(data.data(), size);
+    return data;
+}
+
+static void write_file_head(const fc::path &file, const std::vector<char> &data) {
+    std::fstream s(file.generic_string().c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    s.write(data.data(), data.size());
+}
+
 BOOST_AUTO_TEST_SUITE(block_tests)
 
     BOOST_AUTO_TEST_CASE(generate_empty_blocks) {
@@ -103,6 +122,300 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(transaction_index_log_lookup) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            fc::path index_file = data_dir.path() / "transaction_index";
+
+            std::vector<signed_block> blocks(3);
+            for (uint32_t i = 0; i < blocks.size(); ++i) {
+                if (i) {
+                    blocks[i].previous = blocks[i - 1].id();
+                }
+                for (uint32_t j = 0; j < 2; ++j) {
+                    signed_transaction trx;
+                    trx.ref_block_num = i;
+                    trx.ref_block_prefix = j;
+                    blocks[i].transactions.push_back(trx);
+                }
+            }
+
+            std::vector<char> header;
+            {
+                transaction_index_log log;
+                log.open(index_file);
+                BOOST_CHECK_EQUAL(log.head_block_num(), 0);
+                log.append(blocks[0]);
+                log.append(blocks[1]);
+                STEEMIT_REQUIRE_THROW(log.append(blocks[0]), fc::exception);
+                log.flush();
+                header = read_file_head(index_file, 16);
+                // Not covered by the header, must be dropped on reopen
+                log.append(blocks[2]);
+            }
+            write_file_head(index_file, header);
+            {
+                transaction_index_log log;
+                log.open(index_file);
+                BOOST_CHECK_EQUAL(log.head_block_num(), 2);
+
+                auto location = log.find(blocks[1].transactions[1].id());
+                BOOST_REQUIRE(location.valid());
+                BOOST_CHECK_EQUAL(location->block_num, 2);
+                BOOST_CHECK_EQUAL(location->trx_in_block, 1);
+
+                BOOST_CHECK(!log.find(blocks[2].transactions[0].id()).valid());
+                log.append(blocks[2]);
+                location = log.find(blocks[2].transactions[0].id());
+                BOOST_REQUIRE(location.valid());
+                BOOST_CHECK_EQUAL(location->block_num, 3);
+                BOOST_CHECK_EQUAL(location->trx_in_block, 0);
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(block_log_raw_blocks) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+
+            std::vector<signed_block> blocks(3);
+            for (uint32_t i = 0; i < blocks.size(); ++i) {
+                if (i) {
+                    blocks[i].previous = blocks[i - 1].id();
+                }
+                blocks[i].timestamp = fc::time_point_sec(STEEMIT_TESTING_GENESIS_TIMESTAMP + i * STEEMIT_BLOCK_INTERVAL);
+                signed_transaction trx;
+                trx.ref_block_num = i;
+                blocks[i].transactions.push_back(trx);
+            }
+
+            block_log log;
+            log.open(data_dir.path() / "block_log");
+            for (const auto &b : blocks) {
+                log.append(b);
+            }
+
+            auto raw = log.read_raw_blocks(2, 5);
+            BOOST_REQUIRE_EQUAL(raw.size(), 2);
+            BOOST_CHECK(raw[0] == fc::raw::pack(blocks[1]));
+            BOOST_CHECK(raw[1] == fc::raw::pack(blocks[2]));
+
+            raw = log.read_raw_blocks(1, 1);
+            BOOST_REQUIRE_EQUAL(raw.size(), 1);
+            BOOST_CHECK(fc::raw::unpack<signed_block>(raw[0]).id() == blocks[0].id());
+
+            BOOST_CHECK(log.read_raw_blocks(0, 1).empty());
+            BOOST_CHECK(log.read_raw_blocks(4, 1).empty());
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(history_log_lookup) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            fc::path history_file = data_dir.path() / "account_history";
+
+            // Block n has n operations, all of them impact account 1, every other one account 3
+            auto make_block = [](uint32_t block_num, uint32_t *seq1, uint32_t *seq3) {
+                std::vector<std::pair<history_operation, std::vector<history_account_entry>>> ops;
+                for (uint32_t i = 0; i < block_num; ++i) {
+                    history_operation op;
+                    op.block = block_num;
+                    op.op_in_trx = i;
+                    op.serialized_op.assign(i + 1, char(block_num));
+
+                    std::vector<history_account_entry> accounts;
+                    accounts.push_back({1, (*seq1)++});
+                    if (i % 2 == 0) {
+                        accounts.push_back({3, (*seq3)++});
+                    }
+                    ops.emplace_back(op, accounts);
+                }
+                return ops;
+            };
+
+            uint32_t seq1 = 0, seq3 = 0;
+            std::vector<char> header;
+            {
+                history_log log;
+                log.open(history_file);
+                BOOST_CHECK_EQUAL(log.head_block_num(), 0);
+                for (uint32_t b = 1; b <= 20; ++b) {
+                    log.append_block(b, make_block(b, &seq1, &seq3));
+                }
+                STEEMIT_REQUIRE_THROW(log.append_block(20, {}), fc::exception);
+                log.flush();
+                header = read_file_head(history_file, 20);
+
+                // Not covered by the header, must be dropped on reopen
+                uint32_t s1 = seq1, s3 = seq3;
+                log.append_block(21, make_block(21, &s1, &s3));
+            }
+            write_file_head(history_file, header);
+            {
+                history_log log;
+                log.open(history_file);
+                BOOST_CHECK_EQUAL(log.head_block_num(), 20);
+                BOOST_CHECK_EQUAL(log.get_account_sequence(1), seq1);
+                BOOST_CHECK_EQUAL(log.get_account_sequence(3), seq3);
+                BOOST_CHECK_EQUAL(log.get_account_sequence(2), 0);
+
+                auto block_ops = log.get_block_operations(7);
+                BOOST_REQUIRE_EQUAL(block_ops.size(), 7);
+                BOOST_CHECK_EQUAL(block_ops[6].op_in_trx, 6);
+                BOOST_CHECK_EQUAL(block_ops[6].serialized_op.size(), 7);
+                BOOST_CHECK(log.get_block_operations(21).empty());
+
+                // Every sequence of account 1 is found, whichever entry the lookup starts from
+                for (uint32_t from = 0; from < seq1; ++from) {
+                    auto history = log.get_account_history(1, from, 0);
+                    BOOST_REQUIRE_EQUAL(history.size(), 1);
+                    BOOST_CHECK_EQUAL(history.begin()->first, from);
+                }
+
+                auto history = log.get_account_history(3, uint32_t(-1), 10);
+                BOOST_REQUIRE_EQUAL(history.size(), 11);
+                BOOST_CHECK_EQUAL(history.rbegin()->first, seq3 - 1);
+                BOOST_CHECK_EQUAL(history.rbegin()->second.block, 20);
+
+                history = log.get_account_history(1, 2, 10);
+                BOOST_REQUIRE_EQUAL(history.size(), 3);
+                BOOST_CHECK_EQUAL(history[0].block, 1);
+                BOOST_CHECK_EQUAL(history[2].block, 2);
+
+                // The serialized operations of block n start with the tag n
+                uint64_t types = (uint64_t(1) << 5) | (uint64_t(1) << 17);
+                history = log.get_account_history_by_type(1, types, uint32_t(-1), 100);
+                BOOST_REQUIRE_EQUAL(history.size(), 22);
+                for (const auto &h : history) {
+                    BOOST_CHECK(h.second.block == 5 || h.second.block == 17);
+                }
+                history = log.get_account_history_by_type(1, types, uint32_t(-1), 3);
+                BOOST_REQUIRE_EQUAL(history.size(), 3);
+                BOOST_CHECK_EQUAL(history.begin()->second.block, 17);
+                history = log.get_account_history_by_type(3, uint64_t(1) << 5, 20, 100);
+                BOOST_REQUIRE_EQUAL(history.size(), 3);
+                BOOST_CHECK(log.get_account_history_by_type(1, uint64_t(1) << 30, uint32_t(-1), 100).empty());
+
+                // Skipped blocks have no operations
+                log.append_block(23, make_block(23, &seq1, &seq3));
+                BOOST_CHECK(log.get_block_operations(22).empty());
+                BOOST_CHECK_EQUAL(log.get_block_operations(23).size(), 23);
+                BOOST_CHECK_EQUAL(log.get_account_history(1, uint32_t(-1), 0).begin()->second.block, 23);
+
+                // A reader sees everything the writer flushed, also after the reader was opened
+                log.flush();
+                history_log reader;
+                reader.open(history_file, true);
+                BOOST_CHECK_EQUAL(reader.head_block_num(), 23);
+                BOOST_CHECK_EQUAL(reader.get_account_sequence(1), seq1);
+                log.append_block(24, make_block(24, &seq1, &seq3));
+                BOOST_CHECK_EQUAL(reader.head_block_num(), 23);
+                log.flush();
+                BOOST_CHECK_EQUAL(reader.head_block_num(), 24);
+                BOOST_CHECK_EQUAL(reader.get_account_sequence(3), seq3);
+                BOOST_CHECK_EQUAL(reader.get_block_operations(24).size(), 24);
+                BOOST_CHECK_EQUAL(reader.get_account_history(1, uint32_t(-1), 0).begin()->second.block, 24);
+                BOOST_CHECK_EQUAL(reader.get_account_history_by_type(3, uint64_t(1) << 24, uint32_t(-1), 100).size(), 12);
+                STEEMIT_REQUIRE_THROW(reader.append_block(25, {}), fc::exception);
+            }
+
+            history_log missing;
+            STEEMIT_REQUIRE_THROW(missing.open(data_dir.path() / "missing", true), fc::exception);
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(vote_archive_lookup) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            fc::path archive_file = data_dir.path() / "vote_archive";
+
+            // Comment n gets one vote from each of the voters 1 to n
+            auto make_votes = [](uint32_t comment) {
+                std::vector<archived_vote> votes;
+                for (uint32_t voter = 1; voter <= comment; ++voter) {
+                    archived_vote v;
+                    v.comment = comment;
+                    v.voter = voter;
+                    v.rshares = comment * 100 + voter;
+                    votes.push_back(v);
+                }
+                return votes;
+            };
+
+            std::vector<char> header;
+            {
+                vote_archive archive;
+                archive.open(archive_file);
+                BOOST_CHECK_EQUAL(archive.head_block_num(), 0);
+                for (uint32_t b = 1; b <= 10; ++b) {
+                    archive.append_block(b, make_votes(b));
+                }
+                STEEMIT_REQUIRE_THROW(archive.append_block(10, {}), fc::exception);
+                STEEMIT_REQUIRE_THROW(archive.append_block(11, make_votes(3)), fc::exception);
+                archive.flush();
+                header = read_file_head(archive_file, 12);
+
+                // Not covered by the header, must be dropped on reopen
+                archive.append_block(12, make_votes(12));
+            }
+            write_file_head(archive_file, header);
+            {
+                vote_archive archive;
+                archive.open(archive_file);
+                BOOST_CHECK_EQUAL(archive.head_block_num(), 10);
+                BOOST_CHECK(archive.get_comment_votes(12).empty());
+                BOOST_CHECK(archive.get_comment_votes(100).empty());
+
+                auto votes = archive.get_comment_votes(7);
+                BOOST_REQUIRE_EQUAL(votes.size(), 7);
+                BOOST_CHECK_EQUAL(votes[2].voter, 3);
+                BOOST_CHECK_EQUAL(votes[2].rshares, 703);
+
+                // Voter 3 voted on comments 3 to 10, latest first
+                votes = archive.get_account_votes(3);
+                BOOST_REQUIRE_EQUAL(votes.size(), 8);
+                BOOST_CHECK_EQUAL(votes.front().comment, 10);
+                BOOST_CHECK_EQUAL(votes.back().comment, 3);
+                BOOST_CHECK_EQUAL(archive.get_account_votes(12).size(), 0);
+
+                archive.append_block(13, make_votes(12));
+                BOOST_CHECK_EQUAL(archive.get_comment_votes(12).size(), 12);
+                BOOST_CHECK_EQUAL(archive.get_account_votes(12).size(), 1);
+                BOOST_CHECK_EQUAL(archive.get_account_votes(1).size(), 11);
+
+                // A reader sees everything the writer flushed, also after the reader was opened
+                archive.flush();
+                vote_archive reader;
+                reader.open(archive_file, true);
+                BOOST_CHECK_EQUAL(reader.head_block_num(), 13);
+                BOOST_CHECK_EQUAL(reader.get_comment_votes(12).size(), 12);
+                archive.append_block(14, make_votes(14));
+                BOOST_CHECK(reader.get_comment_votes(14).empty());
+                archive.flush();
+                BOOST_CHECK_EQUAL(reader.head_block_num(), 14);
+                BOOST_CHECK_EQUAL(reader.get_comment_votes(14).size(), 14);
+                BOOST_CHECK_EQUAL(reader.get_account_votes(14).size(), 1);
+                BOOST_CHECK_EQUAL(reader.get_account_votes(1).size(), 12);
+                STEEMIT_REQUIRE_THROW(reader.append_block(15, {}), fc::exception);
+            }
+
+            vote_archive missing;
+            STEEMIT_REQUIRE_THROW(missing.open(data_dir.path() / "missing", true), fc::exception);
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(undo_block) {
         try {
             fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
@@ -783,5 +1096,273 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         FC_LOG_AND_RETHROW()
     }
 
+    BOOST_FIXTURE_TEST_CASE(verified_transaction_cache, clean_database_fixture) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            transfer_operation op;
+            op.from = "alice";
+            op.to = "bob";
+            op.amount = asset(1000, STEEM_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+
+            BOOST_TEST_MESSAGE("Verify the transaction and drop it from the pending state");
+            db.push_transaction(tx, 0);
+            db.clear_pending();
+
+            BOOST_TEST_MESSAGE("Change the active authority of alice");
+            auto new_private_key = generate_private_key("alice_new");
+            account_update_operation update;
+            update.account = "alice";
+            update.active = authority(1, new_private_key.get_public_key(), 1);
+            update.memo_key = alice_public_key;
+            update.json_metadata = "{}";
+
+            signed_transaction update_tx;
+            update_tx.operations.push_back(update);
+            update_tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            update_tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(update_tx, 0);
+            generate_block();
+
+            BOOST_TEST_MESSAGE("The verification of the old signature must not be reused");
+            STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), tx_missing_active_auth);
+
+            tx.signatures.clear();
+            tx.sign(new_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_FIXTURE_TEST_CASE(pending_transactions_limit, clean_database_fixture) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            auto make_transfer = [&](int64_t amount) {
+                transfer_operation op;
+                op.from = "alice";
+                op.to = "bob";
+                op.amount = asset(amount, STEEM_SYMBOL);
+
+                signed_transaction tx;
+                tx.operations.push_back(op);
+                tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                tx.sign(alice_private_key, db.get_chain_id());
+                return tx;
+            };
+
+            auto bob_balance = [&]() {
+                return db.get_account("bob").balance.amount.value;
+            };
+
+            BOOST_TEST_MESSAGE("The oldest transactions are dropped when the pool is full by count");
+            auto first = make_transfer(1);
+            db.set_pending_transactions_limit(2, 0);
+            auto balance = bob_balance();
+            db.push_transaction(first, 0);
+            db.push_transaction(make_transfer(2), 0);
+            db.push_transaction(make_transfer(3), 0);
+            BOOST_REQUIRE(!db.is_known_transaction(first.id()));
+            BOOST_REQUIRE_EQUAL(bob_balance(), balance + 5);
+
+            generate_block();
+            BOOST_REQUIRE_EQUAL(bob_balance(), balance + 5);
+
+            BOOST_TEST_MESSAGE("The oldest transactions are dropped when the pool is full by size");
+            auto size = fc::raw::pack_size(make_transfer(4));
+            db.set_pending_transactions_limit(0, 2 * size);
+            balance = bob_balance();
+            db.push_transaction(make_transfer(4), 0);
+            db.push_transaction(make_transfer(5), 0);
+            BOOST_REQUIRE_EQUAL(bob_balance(), balance + 9);
+            db.push_transaction(make_transfer(6), 0);
+            BOOST_REQUIRE_EQUAL(bob_balance(), balance + 6);
+
+            BOOST_TEST_MESSAGE("A transaction larger than the pool is rejected");
+            db.set_pending_transactions_limit(0, size - 1);
+            STEEMIT_REQUIRE_THROW(db.push_transaction(make_transfer(7), 0), fc::exception);
+            BOOST_REQUIRE_EQUAL(bob_balance(), balance + 6);
+
+            db.set_pending_transactions_limit(0, 0);
+            db.push_transaction(make_transfer(7), 0);
+            BOOST_REQUIRE_EQUAL(bob_balance(), balance + 13);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+
+    BOOST_FIXTURE_TEST_CASE(precheck_transaction, clean_database_fixture) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            transfer_operation op;
+            op.from = "alice";
+            op.to = "bob";
+            op.amount = asset(1000, STEEM_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.set_reference_block(db.head_block_id());
+            tx.ref_block_prefix++;
+            tx.sign(alice_private_key, db.get_chain_id());
+
+            BOOST_TEST_MESSAGE("Checks skipped by the flags are skipped by the precheck");
+            STEEMIT_REQUIRE_THROW(db.precheck_transaction(tx), fc::assert_exception);
+            auto keys = db.precheck_transaction(tx, database::skip_tapos_check);
+            BOOST_REQUIRE(keys.size() == 1);
+            BOOST_REQUIRE(*keys.begin() == alice_public_key);
+            BOOST_REQUIRE(db.precheck_transaction(tx,
+                    database::skip_tapos_check | database::skip_transaction_signatures).empty());
+
+            BOOST_TEST_MESSAGE("A transaction failing the precheck is rejected without the write lock");
+            uint32_t pushed = 0;
+            auto connection = db.on_pending_transaction.connect([&](const signed_transaction &) { ++pushed; });
+
+            steemit::app::transaction_prechecker prechecker(app.chain_database(), 1);
+            signed_transaction bad_tx;
+            op.amount = asset(-1000, STEEM_SYMBOL);
+            bad_tx.operations.push_back(op);
+            bad_tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            bad_tx.sign(alice_private_key, db.get_chain_id());
+
+            // Had the push waited for the write lock held here, it would fail with a lock timeout instead
+            db.with_write_lock([&]() {
+                STEEMIT_REQUIRE_THROW(prechecker.push_transaction(bad_tx), fc::assert_exception);
+            });
+            BOOST_REQUIRE(pushed == 0);
+
+            steemit::app::transaction_prechecker skipping_prechecker(app.chain_database(), 1, database::skip_tapos_check);
+            skipping_prechecker.push_transaction(tx);
+            BOOST_REQUIRE(pushed == 1);
+            connection.disconnect();
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+
+    BOOST_FIXTURE_TEST_CASE(block_profiling, clean_database_fixture) {
+        try {
+            db.set_block_profiling(true, 0);
+            generate_blocks(3);
+
+            auto stats = db.get_block_profiler().get_stats();
+            BOOST_REQUIRE(stats.size() > 2);
+            BOOST_CHECK_EQUAL(stats[0].name, "block");
+            BOOST_CHECK_EQUAL(stats[0].count, 3u);
+
+            // Every phase is recorded once per block, under its own name
+            std::set<std::string> names;
+            for (size_t i = 2; i < stats.size(); ++i) {
+                BOOST_CHECK_EQUAL(stats[i].count, 3u);
+                BOOST_CHECK(names.insert(stats[i].name).second);
+            }
+            BOOST_CHECK(names.count("update_virtual_supply"));
+            BOOST_CHECK(names.count("update_virtual_supply_after_payouts"));
+            BOOST_CHECK(names.count("notify_changed_objects"));
+
+            db.set_block_profiling(false, 0);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_FIXTURE_TEST_CASE(operation_notification_impacted_accounts, clean_database_fixture) {
+        try {
+            std::map<int64_t, uint32_t> checked;
+            const flat_set<account_name_type> *pre_impacted = nullptr;
+
+            // The cached set is compared with a fresh visit of the operation, and the post apply
+            // handlers must see the set computed for the pre apply handlers
+            auto pre = db.pre_apply_operation.connect([&](const operation_notification &note) {
+                flat_set<account_name_type> uncached;
+                protocol::operation_get_impacted_accounts(note.op, uncached);
+                BOOST_CHECK(note.impacted_accounts() == uncached);
+                BOOST_CHECK_EQUAL(note.is_virtual(), is_virtual_operation(note.op));
+                BOOST_CHECK_EQUAL(note.is_market(), is_market_operation(note.op));
+                BOOST_CHECK_EQUAL(note.is_posting(), is_posting_operation(note.op));
+                pre_impacted = &note.impacted_accounts();
+                ++checked[note.op.which()];
+            });
+            auto post = db.post_apply_operation.connect([&](const operation_notification &note) {
+                flat_set<account_name_type> uncached;
+                protocol::operation_get_impacted_accounts(note.op, uncached);
+                BOOST_CHECK(&note.impacted_accounts() == pre_impacted);
+                BOOST_CHECK(note.impacted_accounts() == uncached);
+            });
+
+            ACTORS((alice)(bob))
+            fund("alice", 10000);
+            fund("bob", ASSET("10.000 TBD"));
+            transfer("alice", "bob", 1000);
+
+            comment_operation comment;
+            comment.author = "alice";
+            comment.permlink = "post";
+            comment.parent_permlink = "test";
+            comment.title = "foo";
+            comment.body = "bar";
+
+            vote_operation vote;
+            vote.voter = "bob";
+            vote.author = "alice";
+            vote.permlink = "post";
+            vote.weight = STEEMIT_100_PERCENT;
+
+            signed_transaction tx;
+            tx.operations.push_back(comment);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            tx.operations = {vote};
+            tx.signatures.clear();
+            tx.sign(bob_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            // Two crossing orders are filled by a virtual operation impacting both owners
+            limit_order_create_operation order;
+            order.owner = "alice";
+            order.orderid = 1;
+            order.amount_to_sell = ASSET("1.000 TESTS");
+            order.min_to_receive = ASSET("1.000 TBD");
+            tx.operations = {order};
+            tx.signatures.clear();
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            order.owner = "bob";
+            order.amount_to_sell = ASSET("1.000 TBD");
+            order.min_to_receive = ASSET("1.000 TESTS");
+            tx.operations = {order};
+            tx.signatures.clear();
+            tx.sign(bob_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            generate_block();
+
+            BOOST_REQUIRE(checked[operation::tag<account_create_operation>::value] > 0);
+            BOOST_REQUIRE(checked[operation::tag<transfer_operation>::value] > 0);
+            BOOST_REQUIRE(checked[operation::tag<comment_operation>::value] > 0);
+            BOOST_REQUIRE(checked[operation::tag<vote_operation>::value] > 0);
+            BOOST_REQUIRE(checked[operation::tag<limit_order_create_operation>::value] > 0);
+            BOOST_REQUIRE(checked[operation::tag<fill_order_operation>::value] > 0);
+
+            pre.disconnect();
+            post.disconnect();
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
@@ -133,6 +133,15 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
                           ASSET("0.000 TBD").amount.value);
             BOOST_REQUIRE(acct.id._id == acct_auth.id._id);
 
+            const auto &acct_meta = db.get_account_metadata("alice");
+            BOOST_REQUIRE(acct_meta.account == "alice");
+            BOOST_REQUIRE(!acct_meta.mined);
+            BOOST_REQUIRE(acct_meta.recovery_account == op.creator);
+            BOOST_REQUIRE(acct_meta.reset_account == STEEMIT_NULL_ACCOUNT);
+            BOOST_REQUIRE(acct_meta.last_account_recovery == time_point_sec());
+            BOOST_REQUIRE(acct_meta.last_owner_proved == time_point_sec::min());
+            BOOST_REQUIRE(acct_meta.last_active_proved == time_point_sec::min());
+
             /* This is being moved out of consensus...
       #ifndef IS_LOW_MEM
          BOOST_REQUIRE( acct.json_metadata == op.json_metadata );
@@ -462,7 +471,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             BOOST_REQUIRE(alice_comment.author == op.author);
             BOOST_REQUIRE(to_string(alice_comment.permlink) == op.permlink);
-            BOOST_REQUIRE(to_string(alice_comment.parent_permlink) ==
+            BOOST_REQUIRE(to_string(db.get_interned_string(alice_comment.parent_permlink)) ==
                           op.parent_permlink);
             BOOST_REQUIRE(alice_comment.last_update == db.head_block_time());
             BOOST_REQUIRE(alice_comment.created == db.head_block_time());
@@ -472,14 +481,15 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
                     db.head_block_time() +
                     fc::seconds(STEEMIT_CASHOUT_WINDOW_SECONDS)));
 
+            auto alice_content = db.get_comment_content(alice_comment);
 #ifndef IS_LOW_MEM
-                                                                                                                                    BOOST_REQUIRE( to_string( alice_comment.title ) == op.title );
-         BOOST_REQUIRE( to_string( alice_comment.body ) == op.body );
-         //BOOST_REQUIRE( alice_comment.json_metadata == op.json_metadata );
+            BOOST_REQUIRE(alice_content.title == op.title);
+            BOOST_REQUIRE(alice_content.body == op.body);
+            BOOST_REQUIRE(alice_content.json_metadata == op.json_metadata);
 #else
-            BOOST_REQUIRE(to_string(alice_comment.title) == "");
-            BOOST_REQUIRE(to_string(alice_comment.body) == "");
-            //BOOST_REQUIRE( alice_comment.json_metadata == "" );
+            BOOST_REQUIRE(alice_content.title == "");
+            BOOST_REQUIRE(alice_content.body == "");
+            BOOST_REQUIRE(alice_content.json_metadata == "");
 #endif
 
             validate_database();
@@ -510,7 +520,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(bob_comment.author == op.author);
             BOOST_REQUIRE(to_string(bob_comment.permlink) == op.permlink);
             BOOST_REQUIRE(bob_comment.parent_author == op.parent_author);
-            BOOST_REQUIRE(to_string(bob_comment.parent_permlink) ==
+            BOOST_REQUIRE(to_string(db.get_interned_string(bob_comment.parent_permlink)) ==
                           op.parent_permlink);
             BOOST_REQUIRE(bob_comment.last_update == db.head_block_time());
             BOOST_REQUIRE(bob_comment.created == db.head_block_time());
@@ -519,6 +529,9 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(
                     bob_comment.cashout_time == fc::time_point_sec::maximum());
             BOOST_REQUIRE(bob_comment.root_comment == alice_comment.id);
+            BOOST_REQUIRE(bob_comment.parent_comment == alice_comment.id);
+            BOOST_REQUIRE(bob_comment.category == alice_comment.category);
+            BOOST_REQUIRE(db.get_category(bob_comment.category).discussions == 2);
             validate_database();
 
             BOOST_TEST_MESSAGE("--- Test Sam posting a comment on Bob's comment");
@@ -539,7 +552,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(sam_comment.author == op.author);
             BOOST_REQUIRE(to_string(sam_comment.permlink) == op.permlink);
             BOOST_REQUIRE(sam_comment.parent_author == op.parent_author);
-            BOOST_REQUIRE(to_string(sam_comment.parent_permlink) ==
+            BOOST_REQUIRE(to_string(db.get_interned_string(sam_comment.parent_permlink)) ==
                           op.parent_permlink);
             BOOST_REQUIRE(sam_comment.last_update == db.head_block_time());
             BOOST_REQUIRE(sam_comment.created == db.head_block_time());
@@ -548,6 +561,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(
                     sam_comment.cashout_time == fc::time_point_sec::maximum());
             BOOST_REQUIRE(sam_comment.root_comment == alice_comment.id);
+            BOOST_REQUIRE(sam_comment.parent_comment == bob_comment.id);
+            BOOST_REQUIRE(&db.get_parent_comment(sam_comment) == &bob_comment);
             validate_database();
 
             generate_blocks(60 * 5 / STEEMIT_BLOCK_INTERVAL + 1);
@@ -590,7 +605,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(mod_sam_comment.author == op.author);
             BOOST_REQUIRE(to_string(mod_sam_comment.permlink) == op.permlink);
             BOOST_REQUIRE(mod_sam_comment.parent_author == op.parent_author);
-            BOOST_REQUIRE(to_string(mod_sam_comment.parent_permlink) ==
+            BOOST_REQUIRE(to_string(db.get_interned_string(mod_sam_comment.parent_permlink)) ==
                           op.parent_permlink);
             BOOST_REQUIRE(mod_sam_comment.last_update == db.head_block_time());
             BOOST_REQUIRE(mod_sam_comment.created == created);
@@ -3549,6 +3564,9 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             const auto &bob_auth = db.get<account_authority_object, by_account>("bob");
             BOOST_REQUIRE(bob_auth.owner == acc_create.owner);
+            const auto &bob_meta = db.get_account_metadata("bob");
+            BOOST_REQUIRE(bob_meta.recovery_account == "alice");
+            BOOST_REQUIRE(bob_meta.last_account_recovery == time_point_sec());
 
 
             BOOST_TEST_MESSAGE("Changing bob's owner authority");
@@ -3605,6 +3623,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             const auto &owner1 = db.get<account_authority_object, by_account>("bob").owner;
 
             BOOST_REQUIRE(owner1 == recover.new_owner_authority);
+            BOOST_REQUIRE(bob_meta.last_account_recovery == db.head_block_time());
+            auto last_recovery = bob_meta.last_account_recovery;
 
 
             BOOST_TEST_MESSAGE("Creating new recover request for a bogus key");
@@ -3636,6 +3656,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             const auto &owner2 = db.get<account_authority_object, by_account>("bob").owner;
             BOOST_REQUIRE(owner2 ==
                           authority(1, generate_private_key("new_key").get_public_key(), 1));
+            BOOST_REQUIRE(bob_meta.last_account_recovery == last_recovery);
 
 
             BOOST_TEST_MESSAGE("Testing failure when bob does not have old authority");
@@ -3670,6 +3691,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             const auto &owner4 = db.get<account_authority_object, by_account>("bob").owner;
             BOOST_REQUIRE(owner4 == recover.new_owner_authority);
+            BOOST_REQUIRE(bob_meta.last_account_recovery == db.head_block_time());
 
             BOOST_TEST_MESSAGE("Creating a recovery request that will expire");
 
@@ -3855,6 +3877,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             STEEMIT_REQUIRE_THROW(change_recovery_account("haxer", "sam"), fc::exception);
             STEEMIT_REQUIRE_THROW(change_recovery_account("haxer", "nobody"), fc::exception);
             change_recovery_account("alice", "sam");
+            const auto &alice_meta = db.get_account_metadata("alice");
+            BOOST_REQUIRE(alice_meta.recovery_account == STEEMIT_INIT_MINER_NAME);
 
             fc::ecc::private_key alice_priv1 = fc::ecc::private_key::regenerate(fc::sha256::hash("alice_k1"));
             fc::ecc::private_key alice_priv2 = fc::ecc::private_key::regenerate(fc::sha256::hash("alice_k2"));
@@ -3866,6 +3890,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             // cannot request account recovery until recovery account is approved
             STEEMIT_REQUIRE_THROW(request_account_recovery("sam", sam_private_key, "alice", alice_pub1), fc::exception);
             generate_blocks(1);
+            BOOST_REQUIRE(alice_meta.recovery_account == "sam");
             // cannot finish account recovery until requested
             STEEMIT_REQUIRE_THROW(recover_account("alice", alice_priv1, alice_private_key), fc::exception);
             // do the request
@@ -3875,6 +3900,90 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             // unless we change it!
             change_owner("alice", alice_private_key, public_key_type(alice_priv2.get_public_key()));
             recover_account("alice", alice_priv1, alice_private_key);
+            BOOST_REQUIRE(alice_meta.last_account_recovery == db.head_block_time());
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(challenge_authority_metadata) {
+        try {
+            BOOST_TEST_MESSAGE("Testing: challenges update the account metadata");
+
+            ACTORS((alice)(bob))
+            fund("alice", 10000);
+            fund("bob", 10000);
+
+            const auto &alice_meta = db.get_account_metadata("alice");
+
+            BOOST_TEST_MESSAGE("--- Challenges are disabled and leave the account untouched");
+            challenge_authority_operation challenge;
+            challenge.challenger = "bob";
+            challenge.challenged = "alice";
+
+            signed_transaction tx;
+            tx.operations.push_back(challenge);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(bob_private_key, db.get_chain_id());
+            STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), fc::exception);
+            BOOST_REQUIRE(!db.get_account("alice").active_challenged);
+            BOOST_REQUIRE(alice_meta.last_active_proved == time_point_sec::min());
+
+            BOOST_TEST_MESSAGE("--- Proving the owner authority records both proofs");
+            db.modify(db.get_account("alice"), [&](account_object &a) {
+                a.owner_challenged = true;
+                a.active_challenged = true;
+            });
+
+            prove_authority_operation prove;
+            prove.challenged = "alice";
+            prove.require_owner = true;
+
+            tx.operations = {prove};
+            tx.signatures.clear();
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            BOOST_REQUIRE(!db.get_account("alice").owner_challenged);
+            BOOST_REQUIRE(!db.get_account("alice").active_challenged);
+            BOOST_REQUIRE(alice_meta.last_owner_proved == db.head_block_time());
+            BOOST_REQUIRE(alice_meta.last_active_proved == db.head_block_time());
+            auto owner_proved = alice_meta.last_owner_proved;
+
+            BOOST_TEST_MESSAGE("--- A transfer proves the active authority only");
+            generate_block();
+            db.modify(db.get_account("alice"), [&](account_object &a) {
+                a.active_challenged = true;
+            });
+            transfer("alice", "bob", 1000);
+
+            BOOST_REQUIRE(!db.get_account("alice").active_challenged);
+            BOOST_REQUIRE(alice_meta.last_active_proved == db.head_block_time());
+            BOOST_REQUIRE(alice_meta.last_owner_proved == owner_proved);
+            BOOST_REQUIRE(alice_meta.reset_account == STEEMIT_NULL_ACCOUNT);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(account_metadata_for_every_account) {
+        try {
+            BOOST_TEST_MESSAGE("Testing: every account has a metadata object");
+
+            auto require_metadata = [&]() {
+                const auto &accounts = db.get_index<account_index>().indices();
+                BOOST_REQUIRE_EQUAL(accounts.size(), db.get_index<account_metadata_index>().indices().size());
+                for (const auto &account : accounts) {
+                    BOOST_REQUIRE(db.get_account_metadata(account.name).account == account.name);
+                }
+            };
+
+            BOOST_TEST_MESSAGE("--- Genesis accounts");
+            require_metadata();
+            BOOST_REQUIRE(db.get_account_metadata(STEEMIT_INIT_MINER_NAME).recovery_account == "");
+            STEEMIT_REQUIRE_THROW(db.get_account_metadata("nobody"), fc::exception);
+
+            BOOST_TEST_MESSAGE("--- Created accounts");
+            ACTORS((alice)(bob))
+            require_metadata();
         }
         FC_LOG_AND_RETHROW()
     }
@@ -4011,6 +4120,11 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(alice_auth_obj.posting == alice_auth);
             BOOST_REQUIRE(alice.memo_key == alice_public_key);
 
+            const auto &alice_meta = db.get_account_metadata("alice");
+            BOOST_REQUIRE(alice_meta.mined);
+            BOOST_REQUIRE(alice_meta.recovery_account == "");
+            BOOST_REQUIRE(alice_meta.reset_account == STEEMIT_NULL_ACCOUNT);
+
             const auto &alice_witness = db.get_witness("alice");
             BOOST_REQUIRE(alice_witness.pow_worker == 0);
 